@@ -60,6 +60,9 @@ void ApplicationWindow::Initialize()
     }
 
     glEnable(GL_DEPTH_TEST);
+    glEnable(GL_CULL_FACE);
+    glCullFace(GL_BACK);
+    glFrontFace(GL_CCW);
 
     shape1 = Shapes::CreateSphere(1.0f, 64, 64, glm::vec3(0.6f, 0.2f, 0.9f)); //Shapes::CreateCylinder(1.0f, 2.0f, 64, glm::vec3(0.6f, 0.2f, 0.9f));//Shapes::CreateSphere(1.0f, 64, 64, glm::vec3(0.6f, 0.2f, 0.9f));
     shape2 = Shapes::CreateBox(1.0f,1.0f,2.0f, glm::vec3(0.2f,0.6f,0.9f));
@@ -71,18 +74,17 @@ void ApplicationWindow::Initialize()
     model1 = glm::translate(model1, glm::vec3(5.0f, 0.0f, 0.0f));
 
     // render the cube
-    glBindVertexArray(shape1.VAO);
-    glDrawElements(GL_TRIANGLES, shape1.indexCount, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+    renderer.Draw(shape1);
 
     // world transformation
     glm::mat4 model2 = glm::mat4(1.0f);
     model2 = glm::translate(model2, glm::vec3(5.5f, 0.5f, 1.0f));
 
-    bool intersects = Shapes::AreMeshesIntersectingSAT(shape1, model1, shape2, model2);
-    if (intersects) {
-        bool firstMeshPoints = true;
-        std::vector<Face> points = Shapes::GeneratePolygonIntersectionFaces(shape1, model1, shape2, model2);
+    scene.Add(shape1, model1);
+    scene.Add(shape2, model2);
+    for (const BroadphasePair& pair : Shapes::FindIntersectingPairs(scene)) {
+        std::vector<Face> points = Shapes::GeneratePolygonIntersectionFaces(
+            *scene.Mesh(pair.bodyA), scene.Model(pair.bodyA), *scene.Mesh(pair.bodyB), scene.Model(pair.bodyB));
         for(auto& point:points)
         face.push_back(Shapes::FaceToMesh(point,glm::vec3(1.0f,0.0f,0.0f)));
     }
@@ -152,9 +154,7 @@ void ApplicationWindow::Render()
     glDrawElements(GL_TRIANGLES, face[0].indexCount, GL_UNSIGNED_INT, 0);
     glBindVertexArray(0);*/
 
-        glBindVertexArray(face[2].VAO);
-         glDrawElements(GL_TRIANGLES, face[2].indexCount, GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
+        renderer.Draw(face[2]);
     //}
 
     }
@@ -170,15 +170,13 @@ void ApplicationWindow::Render()
     //glDrawElements(GL_TRIANGLES, shape1.indexCount, GL_UNSIGNED_INT, 0);
     //glBindVertexArray(0);
         glm::mat4 model1 = glm::mat4(1.0f);
-    for (int i = 0;i < face[2].vertices.size();i += 9) {
+    for (int i = 0;i < face[2].positions.size();i++) {
         model1 = glm::mat4(1.0f);
-        model1 = glm::translate(model1, glm::vec3(face[2].vertices[i], face[2].vertices[i + 1], face[2].vertices[i + 2]));
+        model1 = glm::translate(model1, face[2].positions[i]);
         model1 = glm::scale(model1, glm::vec3(0.1f));
         ourShader->setMat4("model", model1);
-        ourShader->setFloat("Multi", 0.01f* i);
-        glBindVertexArray(shape1.VAO);
-        glDrawElements(GL_TRIANGLES, shape1.indexCount, GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
+        ourShader->setFloat("Multi", 0.09f* i);
+        renderer.Draw(shape1);
     }
     // world transformation
     glm::mat4 model2 = glm::mat4(1.0f);
@@ -186,11 +184,10 @@ void ApplicationWindow::Render()
     ourShader->setMat4("model", model2);
     ourShader->setFloat("Multi", 1.0f);
 
-    glBindVertexArray(shape2.VAO);
-    glDrawElements(GL_TRIANGLES, shape2.indexCount, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+    renderer.Draw(shape2);
 
     }
+    renderer.EndFrame();
 
 
     // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
@@ -201,8 +198,7 @@ void ApplicationWindow::Render()
 
 void ApplicationWindow::Shutdown()
 {
-    glDeleteVertexArrays(1, &shape1.VAO);
-    glDeleteVertexArrays(1, &shape2.VAO);
+    renderer.ReleaseAll();
     glfwTerminate();
 }
 
@@ -4,6 +4,7 @@
 #include "Shader.h"
 #include "Camera.h"
 #include "Shapes.h"
+#include "MeshRenderer.h"
 
 struct Light {
     glm::vec3 position;
@@ -45,7 +46,9 @@ public:
     glm::vec3 lightPos = glm::vec3(1.2f, 1.0f, 2.0f);
 
     Shader* ourShader = nullptr;
-    Mesh shape1, shape2;
-    std::vector<Mesh> face;
+    MeshRenderer renderer;
+    MeshData shape1, shape2;
+    SweepAndPrune scene;
+    std::vector<MeshData> face;
 };
 
@@ -0,0 +1,200 @@
+#include "AxisProjection.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CSG_PROJECTION_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CSG_PROJECTION_SSE 1
+#endif
+
+// AVX2 code is compiled for this function only and reached through runtime dispatch
+#if defined(CSG_PROJECTION_X86) && (defined(__GNUC__) || defined(__clang__))
+#define CSG_PROJECTION_AVX2 1
+#define CSG_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#elif defined(CSG_PROJECTION_X86) && defined(_MSC_VER)
+#define CSG_PROJECTION_AVX2 1
+#define CSG_TARGET_AVX2
+#endif
+
+namespace {
+    // One block of BlockWidth axes in SoA form, unused lanes zero
+    struct AxisBlock {
+        alignas(32) float x[AxisProjection::BlockWidth];
+        alignas(32) float y[AxisProjection::BlockWidth];
+        alignas(32) float z[AxisProjection::BlockWidth];
+    };
+
+    using BlockKernel = void (*)(const glm::vec3* points, size_t pointCount, const AxisBlock& block, float* outMin, float* outMax);
+
+    void ProjectBlockScalar(const glm::vec3* points, size_t pointCount, const AxisBlock& block, float* outMin, float* outMax)
+    {
+        constexpr size_t W = AxisProjection::BlockWidth;
+        float low[W], high[W];
+        std::fill(low, low + W, INFINITY);
+        std::fill(high, high + W, -INFINITY);
+        for (size_t i = 0; i < pointCount; ++i) {
+            const glm::vec3& p = points[i];
+            for (size_t a = 0; a < W; ++a) {
+                float d = p.x * block.x[a] + p.y * block.y[a] + p.z * block.z[a];
+                low[a] = std::min(low[a], d);
+                high[a] = std::max(high[a], d);
+            }
+        }
+        std::copy(low, low + W, outMin);
+        std::copy(high, high + W, outMax);
+    }
+
+#ifdef CSG_PROJECTION_SSE
+    void ProjectBlockSSE2(const glm::vec3* points, size_t pointCount, const AxisBlock& block, float* outMin, float* outMax)
+    {
+        constexpr int R = AxisProjection::BlockWidth / 4;
+        __m128 ax[R], ay[R], az[R], low[R], high[R];
+        for (int r = 0; r < R; ++r) {
+            ax[r] = _mm_load_ps(block.x + 4 * r);
+            ay[r] = _mm_load_ps(block.y + 4 * r);
+            az[r] = _mm_load_ps(block.z + 4 * r);
+            low[r] = _mm_set1_ps(INFINITY);
+            high[r] = _mm_set1_ps(-INFINITY);
+        }
+        for (size_t i = 0; i < pointCount; ++i) {
+            const __m128 px = _mm_set1_ps(points[i].x);
+            const __m128 py = _mm_set1_ps(points[i].y);
+            const __m128 pz = _mm_set1_ps(points[i].z);
+            for (int r = 0; r < R; ++r) {
+                __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, ax[r]), _mm_mul_ps(py, ay[r])), _mm_mul_ps(pz, az[r]));
+                low[r] = _mm_min_ps(low[r], d);
+                high[r] = _mm_max_ps(high[r], d);
+            }
+        }
+        for (int r = 0; r < R; ++r) {
+            _mm_storeu_ps(outMin + 4 * r, low[r]);
+            _mm_storeu_ps(outMax + 4 * r, high[r]);
+        }
+    }
+#endif
+
+#ifdef CSG_PROJECTION_AVX2
+    CSG_TARGET_AVX2 void ProjectBlockAVX2(const glm::vec3* points, size_t pointCount, const AxisBlock& block, float* outMin, float* outMax)
+    {
+        constexpr int R = AxisProjection::BlockWidth / 8;
+        __m256 ax[R], ay[R], az[R], low[R], high[R];
+        for (int r = 0; r < R; ++r) {
+            ax[r] = _mm256_load_ps(block.x + 8 * r);
+            ay[r] = _mm256_load_ps(block.y + 8 * r);
+            az[r] = _mm256_load_ps(block.z + 8 * r);
+            low[r] = _mm256_set1_ps(INFINITY);
+            high[r] = _mm256_set1_ps(-INFINITY);
+        }
+        for (size_t i = 0; i < pointCount; ++i) {
+            const __m256 px = _mm256_set1_ps(points[i].x);
+            const __m256 py = _mm256_set1_ps(points[i].y);
+            const __m256 pz = _mm256_set1_ps(points[i].z);
+            for (int r = 0; r < R; ++r) {
+                __m256 d = _mm256_fmadd_ps(pz, az[r], _mm256_fmadd_ps(py, ay[r], _mm256_mul_ps(px, ax[r])));
+                low[r] = _mm256_min_ps(low[r], d);
+                high[r] = _mm256_max_ps(high[r], d);
+            }
+        }
+        for (int r = 0; r < R; ++r) {
+            _mm256_storeu_ps(outMin + 8 * r, low[r]);
+            _mm256_storeu_ps(outMax + 8 * r, high[r]);
+        }
+    }
+#endif
+
+    bool CpuHasAVX2()
+    {
+#if defined(CSG_PROJECTION_AVX2) && defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+            return false;
+        __cpuid(info, 1);
+        const bool fma = (info[2] & (1 << 12)) != 0;
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const bool avx = (info[2] & (1 << 28)) != 0;
+        // The OS must save the YMM registers on context switch
+        if (!(fma && osxsave && avx) || (_xgetbv(0) & 6) != 6)
+            return false;
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#elif defined(CSG_PROJECTION_AVX2)
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+        return false;
+#endif
+    }
+
+    std::atomic<int> activeISA{ -1 }; // -1 until the first call picks BestISA
+
+    BlockKernel KernelFor(AxisProjection::ISA isa)
+    {
+        switch (isa) {
+#ifdef CSG_PROJECTION_AVX2
+        case AxisProjection::ISA::AVX2: return ProjectBlockAVX2;
+#endif
+#ifdef CSG_PROJECTION_SSE
+        case AxisProjection::ISA::SSE2: return ProjectBlockSSE2;
+#endif
+        default: return ProjectBlockScalar;
+        }
+    }
+}
+
+AxisProjection::ISA AxisProjection::BestISA()
+{
+    static const ISA best = [] {
+        if (CpuHasAVX2())
+            return ISA::AVX2;
+#ifdef CSG_PROJECTION_SSE
+        return ISA::SSE2;
+#else
+        return ISA::Scalar;
+#endif
+    }();
+    return best;
+}
+
+AxisProjection::ISA AxisProjection::ActiveISA()
+{
+    int isa = activeISA.load(std::memory_order_relaxed);
+    if (isa < 0) {
+        isa = static_cast<int>(BestISA());
+        activeISA.store(isa, std::memory_order_relaxed);
+    }
+    return static_cast<ISA>(isa);
+}
+
+void AxisProjection::SetISA(ISA isa)
+{
+    activeISA.store(std::min(static_cast<int>(isa), static_cast<int>(BestISA())), std::memory_order_relaxed);
+}
+
+void AxisProjection::Project(const glm::vec3* points, size_t pointCount, const glm::vec3* axes, size_t axisCount,
+    float* outMin, float* outMax)
+{
+    const BlockKernel kernel = KernelFor(ActiveISA());
+    AxisBlock block;
+    float blockMin[BlockWidth], blockMax[BlockWidth];
+    for (size_t first = 0; first < axisCount; first += BlockWidth) {
+        const size_t count = std::min(BlockWidth, axisCount - first);
+        for (size_t a = 0; a < BlockWidth; ++a) {
+            glm::vec3 axis = a < count ? axes[first + a] : glm::vec3(0.0f);
+            block.x[a] = axis.x;
+            block.y[a] = axis.y;
+            block.z[a] = axis.z;
+        }
+        kernel(points, pointCount, block, blockMin, blockMax);
+        std::copy(blockMin, blockMin + count, outMin + first);
+        std::copy(blockMax, blockMax + count, outMax + first);
+    }
+}
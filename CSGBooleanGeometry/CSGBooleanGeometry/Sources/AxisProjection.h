@@ -0,0 +1,24 @@
+#pragma once
+#include "glm.hpp"
+#include <cstddef>
+
+// Extent of a point set along many axes in one pass over the points. Axes are
+// processed in blocks held in SIMD registers (4 per SSE2 register, 8 per AVX2
+// register) and min/max are reduced in registers, so each point is loaded once
+// per block instead of once per axis. The ISA is picked at runtime.
+class AxisProjection
+{
+public:
+    enum class ISA { Scalar, SSE2, AVX2 };
+
+    // outMin[a] / outMax[a] = min / max of dot(axes[a], points[i]); +inf / -inf for no points
+    static void Project(const glm::vec3* points, size_t pointCount, const glm::vec3* axes, size_t axisCount,
+        float* outMin, float* outMax);
+
+    static ISA BestISA();   // Best ISA this CPU supports
+    static ISA ActiveISA(); // ISA used by Project
+    // Restricts Project to isa (clamped to BestISA); for benchmarking and cross-checking
+    static void SetISA(ISA isa);
+
+    static constexpr size_t BlockWidth = 16; // Axes per pass over the points
+};
@@ -0,0 +1,442 @@
+#include "BVH.h"
+#include "MeshData.h"
+#include "TransformCache.h"
+#include "VertexWelder.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace {
+    constexpr unsigned int MaxDepth = 60; // Traversal stacks hold MaxDepth + 2 entries
+
+    float SurfaceArea(const glm::vec3& boundsMin, const glm::vec3& boundsMax)
+    {
+        glm::vec3 e = boundsMax - boundsMin;
+        return e.x * e.y + e.y * e.z + e.z * e.x;
+    }
+
+    bool BoxesOverlap(const glm::vec3& aMin, const glm::vec3& aMax, const glm::vec3& bMin, const glm::vec3& bMax)
+    {
+        return aMin.x <= bMax.x && aMax.x >= bMin.x
+            && aMin.y <= bMax.y && aMax.y >= bMin.y
+            && aMin.z <= bMax.z && aMax.z >= bMin.z;
+    }
+
+    // Bounds of a box under an affine transform (Arvo): centre moves, extents go through |M|
+    void TransformBox(const glm::mat4& m, const glm::vec3& boundsMin, const glm::vec3& boundsMax, glm::vec3& outMin, glm::vec3& outMax)
+    {
+        glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+        glm::vec3 extents = (boundsMax - boundsMin) * 0.5f;
+        glm::vec3 newCenter = glm::vec3(m * glm::vec4(center, 1.0f));
+        glm::vec3 newExtents;
+        for (int row = 0; row < 3; ++row) {
+            newExtents[row] = std::abs(m[0][row]) * extents.x + std::abs(m[1][row]) * extents.y + std::abs(m[2][row]) * extents.z;
+        }
+        outMin = newCenter - newExtents;
+        outMax = newCenter + newExtents;
+    }
+
+    struct Bin {
+        glm::vec3 boundsMin = glm::vec3(FLT_MAX);
+        glm::vec3 boundsMax = glm::vec3(-FLT_MAX);
+        unsigned int count = 0;
+    };
+}
+
+const BVH& BVH::ForMesh(const MeshData& mesh)
+{
+    BVH& bvh = mesh.bvh;
+    if (bvh.sourceRevision != mesh.revision) {
+        bvh.Build(mesh.positions, mesh.indices);
+        bvh.sourceRevision = mesh.revision;
+    }
+    return bvh;
+}
+
+const BVH& BVH::ForMeshWorld(const MeshData& mesh, const glm::mat4& model)
+{
+    bool hit;
+    WorldBVHCache::Entry& entry = mesh.worldBvh.Find(mesh.revision, model, hit);
+    if (!hit)
+        entry.value.Build(TransformCache::GetWorldPositions(mesh, model), mesh.indices);
+    return entry.value;
+}
+
+void BVH::Clear()
+{
+    nodes.clear();
+    triangleOrder.clear();
+    sourceRevision = 0;
+}
+
+float BVH::QueryMargin() const
+{
+    if (nodes.empty())
+        return VertexWelder::DefaultTolerance;
+    return 1e-5f * glm::length(nodes[0].boundsMax - nodes[0].boundsMin) + VertexWelder::DefaultTolerance;
+}
+
+void BVH::Build(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices)
+{
+    nodes.clear();
+    triangleOrder.clear();
+    const unsigned int triangleCount = static_cast<unsigned int>(indices.size() / 3);
+    if (triangleCount == 0)
+        return;
+
+    // Step 1: Per-triangle bounds and centroids, computed once for the whole build
+    std::vector<glm::vec3> triMin(triangleCount), triMax(triangleCount), centroids(triangleCount);
+    for (unsigned int t = 0; t < triangleCount; ++t) {
+        const glm::vec3& a = positions[indices[t * 3]];
+        const glm::vec3& b = positions[indices[t * 3 + 1]];
+        const glm::vec3& c = positions[indices[t * 3 + 2]];
+        triMin[t] = glm::min(a, glm::min(b, c));
+        triMax[t] = glm::max(a, glm::max(b, c));
+        centroids[t] = (triMin[t] + triMax[t]) * 0.5f;
+    }
+
+    triangleOrder.resize(triangleCount);
+    for (unsigned int t = 0; t < triangleCount; ++t)
+        triangleOrder[t] = t;
+
+    // Step 2: Root covers everything; a binary tree never needs more than 2n - 1 nodes
+    nodes.reserve(size_t(triangleCount) * 2);
+    BVHNode root;
+    root.leftFirst = 0;
+    root.triangleCount = triangleCount;
+    UpdateBounds(root, triMin, triMax);
+    nodes.push_back(root);
+
+    // Step 3: Split depth-first; children are appended in pairs so siblings share a cache line
+    std::vector<std::pair<unsigned int, unsigned int>> stack; // (node, depth)
+    stack.push_back({ 0, 0 });
+    while (!stack.empty()) {
+        auto [nodeIndex, depth] = stack.back();
+        stack.pop_back();
+        if (depth >= MaxDepth)
+            continue;
+        size_t before = nodes.size();
+        Subdivide(nodeIndex, centroids, triMin, triMax);
+        if (nodes.size() != before) {
+            stack.push_back({ nodes[nodeIndex].leftFirst, depth + 1 });
+            stack.push_back({ nodes[nodeIndex].leftFirst + 1, depth + 1 });
+        }
+    }
+    nodes.shrink_to_fit();
+}
+
+void BVH::UpdateBounds(BVHNode& node, const std::vector<glm::vec3>& triMin, const std::vector<glm::vec3>& triMax) const
+{
+    node.boundsMin = glm::vec3(FLT_MAX);
+    node.boundsMax = glm::vec3(-FLT_MAX);
+    for (unsigned int i = 0; i < node.triangleCount; ++i) {
+        unsigned int t = triangleOrder[node.leftFirst + i];
+        node.boundsMin = glm::min(node.boundsMin, triMin[t]);
+        node.boundsMax = glm::max(node.boundsMax, triMax[t]);
+    }
+}
+
+void BVH::Subdivide(unsigned int nodeIndex, const std::vector<glm::vec3>& centroids, const std::vector<glm::vec3>& triMin, const std::vector<glm::vec3>& triMax)
+{
+    const unsigned int first = nodes[nodeIndex].leftFirst;
+    const unsigned int count = nodes[nodeIndex].triangleCount;
+    if (count <= MaxLeafSize)
+        return;
+
+    // Bin on centroid bounds so every bin can receive triangles
+    glm::vec3 centroidMin(FLT_MAX), centroidMax(-FLT_MAX);
+    for (unsigned int i = 0; i < count; ++i) {
+        const glm::vec3& c = centroids[triangleOrder[first + i]];
+        centroidMin = glm::min(centroidMin, c);
+        centroidMax = glm::max(centroidMax, c);
+    }
+
+    float bestCost = FLT_MAX;
+    int bestAxis = -1;
+    int bestSplit = 0;
+    for (int axis = 0; axis < 3; ++axis) {
+        float extent = centroidMax[axis] - centroidMin[axis];
+        if (extent <= 0.0f)
+            continue;
+        float scale = BinCount / extent;
+
+        Bin bins[BinCount];
+        for (unsigned int i = 0; i < count; ++i) {
+            unsigned int t = triangleOrder[first + i];
+            int b = std::min(BinCount - 1, static_cast<int>((centroids[t][axis] - centroidMin[axis]) * scale));
+            bins[b].count++;
+            bins[b].boundsMin = glm::min(bins[b].boundsMin, triMin[t]);
+            bins[b].boundsMax = glm::max(bins[b].boundsMax, triMax[t]);
+        }
+
+        // Sweep from both ends to get the cost of every plane in O(BinCount)
+        float leftArea[BinCount - 1], rightArea[BinCount - 1];
+        unsigned int leftCount[BinCount - 1], rightCount[BinCount - 1];
+        Bin left, right;
+        for (int b = 0; b < BinCount - 1; ++b) {
+            left.count += bins[b].count;
+            left.boundsMin = glm::min(left.boundsMin, bins[b].boundsMin);
+            left.boundsMax = glm::max(left.boundsMax, bins[b].boundsMax);
+            leftCount[b] = left.count;
+            leftArea[b] = left.count ? SurfaceArea(left.boundsMin, left.boundsMax) : 0.0f;
+
+            const Bin& rb = bins[BinCount - 1 - b];
+            right.count += rb.count;
+            right.boundsMin = glm::min(right.boundsMin, rb.boundsMin);
+            right.boundsMax = glm::max(right.boundsMax, rb.boundsMax);
+            rightCount[BinCount - 2 - b] = right.count;
+            rightArea[BinCount - 2 - b] = right.count ? SurfaceArea(right.boundsMin, right.boundsMax) : 0.0f;
+        }
+        for (int b = 0; b < BinCount - 1; ++b) {
+            float cost = leftCount[b] * leftArea[b] + rightCount[b] * rightArea[b];
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestAxis = axis;
+                bestSplit = b + 1;
+            }
+        }
+    }
+
+    // Keep the leaf when no split beats intersecting every triangle in it
+    const BVHNode& node = nodes[nodeIndex];
+    float leafCost = count * SurfaceArea(node.boundsMin, node.boundsMax);
+    if (bestAxis < 0 || bestCost >= leafCost)
+        return;
+
+    // Partition in place: triangles left of the split plane move to the front
+    float scale = BinCount / (centroidMax[bestAxis] - centroidMin[bestAxis]);
+    auto middle = std::partition(triangleOrder.begin() + first, triangleOrder.begin() + first + count,
+        [&](unsigned int t) {
+            int b = std::min(BinCount - 1, static_cast<int>((centroids[t][bestAxis] - centroidMin[bestAxis]) * scale));
+            return b < bestSplit;
+        });
+    unsigned int leftCount = static_cast<unsigned int>(middle - (triangleOrder.begin() + first));
+    if (leftCount == 0 || leftCount == count)
+        return;
+
+    unsigned int childIndex = static_cast<unsigned int>(nodes.size());
+    BVHNode leftChild, rightChild;
+    leftChild.leftFirst = first;
+    leftChild.triangleCount = leftCount;
+    rightChild.leftFirst = first + leftCount;
+    rightChild.triangleCount = count - leftCount;
+    UpdateBounds(leftChild, triMin, triMax);
+    UpdateBounds(rightChild, triMin, triMax);
+    nodes.push_back(leftChild);
+    nodes.push_back(rightChild);
+
+    nodes[nodeIndex].leftFirst = childIndex;
+    nodes[nodeIndex].triangleCount = 0;
+}
+
+void BVH::QueryBox(const glm::vec3& boxMin, const glm::vec3& boxMax, std::vector<unsigned int>& outTriangles) const
+{
+    if (nodes.empty())
+        return;
+    size_t firstResult = outTriangles.size();
+
+    unsigned int stack[MaxDepth + 2];
+    unsigned int stackSize = 0;
+    stack[stackSize++] = 0;
+    while (stackSize > 0) {
+        const BVHNode& node = nodes[stack[--stackSize]];
+        if (!BoxesOverlap(node.boundsMin, node.boundsMax, boxMin, boxMax))
+            continue;
+        if (node.IsLeaf()) {
+            for (unsigned int i = 0; i < node.triangleCount; ++i)
+                outTriangles.push_back(triangleOrder[node.leftFirst + i]);
+        }
+        else {
+            stack[stackSize++] = node.leftFirst;
+            stack[stackSize++] = node.leftFirst + 1;
+        }
+    }
+    std::sort(outTriangles.begin() + firstResult, outTriangles.end());
+}
+
+void BVH::QueryTriangle(const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2, std::vector<unsigned int>& outTriangles, float margin) const
+{
+    if (nodes.empty())
+        return;
+    size_t firstResult = outTriangles.size();
+
+    glm::vec3 boxMin = glm::min(v0, glm::min(v1, v2)) - glm::vec3(margin);
+    glm::vec3 boxMax = glm::max(v0, glm::max(v1, v2)) + glm::vec3(margin);
+    // The plane test only prunes; a degenerate triangle falls back to its bounds
+    glm::vec3 normal = glm::cross(v1 - v0, v2 - v0);
+    float normalLength = glm::length(normal);
+    bool usePlane = normalLength > 0.0f;
+    if (usePlane)
+        normal /= normalLength;
+    float planeDistance = glm::dot(normal, v0);
+
+    unsigned int stack[MaxDepth + 2];
+    unsigned int stackSize = 0;
+    stack[stackSize++] = 0;
+    while (stackSize > 0) {
+        const BVHNode& node = nodes[stack[--stackSize]];
+        if (!BoxesOverlap(node.boundsMin, node.boundsMax, boxMin, boxMax))
+            continue;
+        if (usePlane) {
+            glm::vec3 center = (node.boundsMin + node.boundsMax) * 0.5f;
+            glm::vec3 extents = (node.boundsMax - node.boundsMin) * 0.5f;
+            float radius = glm::dot(extents, glm::abs(normal));
+            if (std::abs(glm::dot(normal, center) - planeDistance) > radius + margin)
+                continue;
+        }
+        if (node.IsLeaf()) {
+            for (unsigned int i = 0; i < node.triangleCount; ++i)
+                outTriangles.push_back(triangleOrder[node.leftFirst + i]);
+        }
+        else {
+            stack[stackSize++] = node.leftFirst;
+            stack[stackSize++] = node.leftFirst + 1;
+        }
+    }
+    std::sort(outTriangles.begin() + firstResult, outTriangles.end());
+}
+
+void BVH::QuerySegment(const glm::vec3& p0, const glm::vec3& p1, std::vector<unsigned int>& outTriangles, float margin) const
+{
+    if (nodes.empty())
+        return;
+    size_t firstResult = outTriangles.size();
+
+    glm::vec3 direction = p1 - p0;
+    glm::vec3 inverseDirection;
+    for (int axis = 0; axis < 3; ++axis)
+        inverseDirection[axis] = direction[axis] != 0.0f ? 1.0f / direction[axis] : 0.0f;
+
+    // Slab test on the box grown by margin, clipped to the segment's [0, 1]
+    auto hitsBox = [&](const BVHNode& node) {
+        float tEnter = 0.0f, tExit = 1.0f;
+        for (int axis = 0; axis < 3; ++axis) {
+            float lo = node.boundsMin[axis] - margin;
+            float hi = node.boundsMax[axis] + margin;
+            if (direction[axis] == 0.0f) {
+                if (p0[axis] < lo || p0[axis] > hi)
+                    return false;
+                continue;
+            }
+            float t0 = (lo - p0[axis]) * inverseDirection[axis];
+            float t1 = (hi - p0[axis]) * inverseDirection[axis];
+            if (t0 > t1)
+                std::swap(t0, t1);
+            tEnter = std::max(tEnter, t0);
+            tExit = std::min(tExit, t1);
+            if (tEnter > tExit)
+                return false;
+        }
+        return true;
+    };
+
+    unsigned int stack[MaxDepth + 2];
+    unsigned int stackSize = 0;
+    stack[stackSize++] = 0;
+    while (stackSize > 0) {
+        const BVHNode& node = nodes[stack[--stackSize]];
+        if (!hitsBox(node))
+            continue;
+        if (node.IsLeaf()) {
+            for (unsigned int i = 0; i < node.triangleCount; ++i)
+                outTriangles.push_back(triangleOrder[node.leftFirst + i]);
+        }
+        else {
+            stack[stackSize++] = node.leftFirst;
+            stack[stackSize++] = node.leftFirst + 1;
+        }
+    }
+    std::sort(outTriangles.begin() + firstResult, outTriangles.end());
+}
+
+BVHTraversalStats BVH::FindOverlappingPairs(const BVH& a, const BVH& b, const glm::mat4& bToA,
+    const std::function<void(const TrianglePair* pairs, size_t count)>& onBatch, float margin, size_t batchSize)
+{
+    BVHTraversalStats stats;
+    if (a.nodes.empty() || b.nodes.empty())
+        return stats;
+    if (batchSize == 0)
+        batchSize = 1;
+
+    std::vector<TrianglePair> batch;
+    batch.reserve(batchSize);
+    auto flush = [&]() {
+        if (batch.empty())
+            return;
+        onBatch(batch.data(), batch.size());
+        stats.batches++;
+        batch.clear();
+    };
+
+    // Each entry carries b's node box already in a's space, so it is transformed once per visit
+    struct Entry {
+        unsigned int nodeA;
+        unsigned int nodeB;
+        glm::vec3 boundsMinB;
+        glm::vec3 boundsMaxB;
+    };
+    std::vector<Entry> stack;
+    stack.reserve(2 * (MaxDepth + 2));
+
+    Entry root{ 0, 0, glm::vec3(0.0f), glm::vec3(0.0f) };
+    TransformBox(bToA, b.nodes[0].boundsMin, b.nodes[0].boundsMax, root.boundsMinB, root.boundsMaxB);
+    stack.push_back(root);
+
+    while (!stack.empty()) {
+        stats.maxStackSize = std::max(stats.maxStackSize, stack.size());
+        Entry entry = stack.back();
+        stack.pop_back();
+        const BVHNode& nodeA = a.nodes[entry.nodeA];
+        const BVHNode& nodeB = b.nodes[entry.nodeB];
+
+        stats.nodePairsTested++;
+        if (!BoxesOverlap(nodeA.boundsMin - glm::vec3(margin), nodeA.boundsMax + glm::vec3(margin), entry.boundsMinB, entry.boundsMaxB)) {
+            stats.nodePairsCulled++;
+            continue;
+        }
+
+        if (nodeA.IsLeaf() && nodeB.IsLeaf()) {
+            stats.leafPairs++;
+            for (unsigned int i = 0; i < nodeA.triangleCount; ++i) {
+                for (unsigned int j = 0; j < nodeB.triangleCount; ++j) {
+                    batch.push_back({ a.triangleOrder[nodeA.leftFirst + i], b.triangleOrder[nodeB.leftFirst + j] });
+                    if (batch.size() == batchSize)
+                        flush();
+                }
+            }
+            stats.trianglePairs += size_t(nodeA.triangleCount) * nodeB.triangleCount;
+            continue;
+        }
+
+        // Descend the larger node so both sides shrink at a similar rate
+        bool descendB = nodeA.IsLeaf() || (!nodeB.IsLeaf()
+            && SurfaceArea(entry.boundsMinB, entry.boundsMaxB) > SurfaceArea(nodeA.boundsMin, nodeA.boundsMax));
+        if (descendB) {
+            for (unsigned int child = nodeB.leftFirst; child < nodeB.leftFirst + 2; ++child) {
+                Entry next{ entry.nodeA, child, glm::vec3(0.0f), glm::vec3(0.0f) };
+                TransformBox(bToA, b.nodes[child].boundsMin, b.nodes[child].boundsMax, next.boundsMinB, next.boundsMaxB);
+                stack.push_back(next);
+            }
+        }
+        else {
+            stack.push_back({ nodeA.leftFirst, entry.nodeB, entry.boundsMinB, entry.boundsMaxB });
+            stack.push_back({ nodeA.leftFirst + 1, entry.nodeB, entry.boundsMinB, entry.boundsMaxB });
+        }
+    }
+    flush();
+    return stats;
+}
+
+std::vector<TrianglePair> BVH::FindOverlappingPairs(const BVH& a, const BVH& b, const glm::mat4& bToA, float margin, BVHTraversalStats* stats)
+{
+    std::vector<TrianglePair> pairs;
+    BVHTraversalStats result = FindOverlappingPairs(a, b, bToA,
+        [&](const TrianglePair* batch, size_t count) { pairs.insert(pairs.end(), batch, batch + count); },
+        margin);
+    std::sort(pairs.begin(), pairs.end(), [](const TrianglePair& x, const TrianglePair& y) {
+        return x.triangleB != y.triangleB ? x.triangleB < y.triangleB : x.triangleA < y.triangleA;
+    });
+    if (stats)
+        *stats = result;
+    return pairs;
+}
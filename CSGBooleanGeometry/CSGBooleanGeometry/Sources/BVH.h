@@ -0,0 +1,92 @@
+#pragma once
+#include "glm.hpp"
+#include <functional>
+#include <vector>
+
+struct MeshData;
+
+// Flattened BVH node, 32 bytes. Children of an inner node are stored next to
+// each other at leftFirst and leftFirst + 1; a leaf covers triangleCount
+// entries of the triangle order starting at leftFirst.
+struct BVHNode {
+    glm::vec3 boundsMin;
+    unsigned int leftFirst;
+    glm::vec3 boundsMax;
+    unsigned int triangleCount;
+
+    bool IsLeaf() const { return triangleCount > 0; }
+};
+
+// Candidate pair from a tree-vs-tree traversal (triangle ids of each BVH)
+struct TrianglePair {
+    unsigned int triangleA;
+    unsigned int triangleB;
+};
+
+// Counters filled by BVH::FindOverlappingPairs
+struct BVHTraversalStats {
+    size_t nodePairsTested = 0;  // Box-vs-box tests performed
+    size_t nodePairsCulled = 0;  // Tests that found the boxes disjoint
+    size_t leafPairs = 0;        // Overlapping leaf-vs-leaf pairs expanded into triangle pairs
+    size_t trianglePairs = 0;    // Pairs emitted
+    size_t batches = 0;          // Calls made to the batch callback
+    size_t maxStackSize = 0;
+};
+
+// Triangle bounding volume hierarchy built with the binned surface area
+// heuristic. Triangle ids are positions in the index buffer divided by 3, so
+// they stay valid for welded copies of the same index buffer.
+// Queries append candidate triangle ids in ascending order; callers run the
+// exact primitive test on the candidates.
+class BVH
+{
+public:
+    void Build(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices);
+    void Clear();
+
+    // Cached local-space BVH of the mesh, rebuilt when the mesh revision changes
+    static const BVH& ForMesh(const MeshData& mesh);
+    // Cached BVH over the mesh's world positions under model (TransformCache),
+    // kept per (revision, matrix) like them; not thread-safe
+    static const BVH& ForMeshWorld(const MeshData& mesh, const glm::mat4& model);
+
+    // Triangles in leaves whose bounds overlap the box
+    void QueryBox(const glm::vec3& boxMin, const glm::vec3& boxMax, std::vector<unsigned int>& outTriangles) const;
+    // Triangles in leaves whose bounds overlap the triangle (bounds and plane tests).
+    // margin grows the tests to absorb welding and transform round-off.
+    void QueryTriangle(const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2, std::vector<unsigned int>& outTriangles, float margin = 0.0f) const;
+    // Triangles in leaves whose bounds the segment p0-p1 passes through
+    void QuerySegment(const glm::vec3& p0, const glm::vec3& p1, std::vector<unsigned int>& outTriangles, float margin = 0.0f) const;
+
+    // Walks both trees at once and emits every (triangle of a, triangle of b)
+    // whose leaves overlap. bToA maps b's space into a's space; only b's node
+    // boxes are transformed, as they are visited. Pairs are handed to onBatch
+    // in chunks of up to batchSize from one reused buffer, in no particular order.
+    static BVHTraversalStats FindOverlappingPairs(const BVH& a, const BVH& b, const glm::mat4& bToA,
+        const std::function<void(const TrianglePair* pairs, size_t count)>& onBatch,
+        float margin = 0.0f, size_t batchSize = 4096);
+    // Collects all pairs, sorted by triangleB then triangleA
+    static std::vector<TrianglePair> FindOverlappingPairs(const BVH& a, const BVH& b, const glm::mat4& bToA,
+        float margin = 0.0f, BVHTraversalStats* stats = nullptr);
+
+    // Slack for queries made with welded, re-transformed points: the tree is built
+    // from the raw local positions, so allow for round-off relative to its size
+    float QueryMargin() const;
+
+    bool Empty() const { return nodes.empty(); }
+    const std::vector<BVHNode>& Nodes() const { return nodes; }
+    const std::vector<unsigned int>& TriangleOrder() const { return triangleOrder; }
+    const BVHNode& Root() const { return nodes[0]; }
+
+    unsigned long long sourceRevision = 0; // Mesh revision this BVH was built from (ForMesh)
+
+    static constexpr unsigned int MaxLeafSize = 4;
+    static constexpr int BinCount = 12;
+
+private:
+    void Subdivide(unsigned int nodeIndex, const std::vector<glm::vec3>& centroids, const std::vector<glm::vec3>& triMin, const std::vector<glm::vec3>& triMax);
+    void UpdateBounds(BVHNode& node, const std::vector<glm::vec3>& triMin, const std::vector<glm::vec3>& triMax) const;
+
+    std::vector<BVHNode> nodes;
+    std::vector<unsigned int> triangleOrder;
+};
@@ -0,0 +1,169 @@
+#include "Bounds.h"
+#include "AxisProjection.h"
+#include "MeshData.h"
+#include <algorithm>
+#include <cmath>
+
+bool AABB::Overlaps(const AABB& other, glm::vec3* outAxis) const
+{
+    for (int axis = 0; axis < 3; ++axis) {
+        if (min[axis] > other.max[axis] || max[axis] < other.min[axis]) {
+            if (outAxis) {
+                *outAxis = glm::vec3(0.0f);
+                (*outAxis)[axis] = 1.0f;
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+AABB AABB::Transformed(const glm::mat4& model) const
+{
+    glm::vec3 center = glm::vec3(model * glm::vec4((min + max) * 0.5f, 1.0f));
+    glm::vec3 extents = (max - min) * 0.5f;
+    glm::vec3 newExtents;
+    for (int row = 0; row < 3; ++row) {
+        newExtents[row] = std::abs(model[0][row]) * extents.x + std::abs(model[1][row]) * extents.y + std::abs(model[2][row]) * extents.z;
+    }
+    return { center - newExtents, center + newExtents };
+}
+
+OBB OBB::Transformed(const glm::mat4& model) const
+{
+    const glm::mat3 linear(model);
+    OBB result;
+    result.center = glm::vec3(model * glm::vec4(center, 1.0f));
+    for (int i = 0; i < 3; ++i)
+        result.halfAxes[i] = linear * halfAxes[i];
+    return result;
+}
+
+bool OBB::Overlap(const OBB& a, const OBB& b, glm::vec3* outAxis)
+{
+    const glm::vec3 offset = b.center - a.center;
+
+    // Half-length of a box's projection onto an (unnormalized) axis
+    auto radius = [](const OBB& box, const glm::vec3& axis) {
+        return std::abs(glm::dot(box.halfAxes[0], axis)) + std::abs(glm::dot(box.halfAxes[1], axis)) + std::abs(glm::dot(box.halfAxes[2], axis));
+    };
+    // Every axis is the cross product of two edges: face normals pair edges of one
+    // box, edge-edge axes pair one edge of each
+    auto separatedOnCross = [&](const glm::vec3& u, const glm::vec3& v) {
+        glm::vec3 axis = glm::cross(u, v);
+        // Parallel edges give no axis; the face normals cover that case
+        if (glm::dot(axis, axis) <= 1e-12f * glm::dot(u, u) * glm::dot(v, v))
+            return false;
+        if (std::abs(glm::dot(offset, axis)) <= radius(a, axis) + radius(b, axis))
+            return false;
+        if (outAxis)
+            *outAxis = glm::normalize(axis);
+        return true;
+    };
+
+    for (int i = 0; i < 3; ++i) {
+        if (separatedOnCross(a.halfAxes[(i + 1) % 3], a.halfAxes[(i + 2) % 3]))
+            return false;
+        if (separatedOnCross(b.halfAxes[(i + 1) % 3], b.halfAxes[(i + 2) % 3]))
+            return false;
+    }
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            if (separatedOnCross(a.halfAxes[i], b.halfAxes[j]))
+                return false;
+        }
+    }
+    return true;
+}
+
+namespace {
+    // Eigenvectors of a symmetric 3x3 matrix by cyclic Jacobi rotations; columns of the result
+    glm::mat3 SymmetricEigenvectors(glm::mat3 m)
+    {
+        glm::mat3 vectors(1.0f);
+        for (int sweep = 0; sweep < 16; ++sweep) {
+            float offDiagonal = m[0][1] * m[0][1] + m[0][2] * m[0][2] + m[1][2] * m[1][2];
+            if (offDiagonal < 1e-20f)
+                break;
+            for (int p = 0; p < 2; ++p) {
+                for (int q = p + 1; q < 3; ++q) {
+                    if (std::abs(m[p][q]) < 1e-20f)
+                        continue;
+                    float theta = (m[q][q] - m[p][p]) / (2.0f * m[p][q]);
+                    float t = (theta >= 0.0f ? 1.0f : -1.0f) / (std::abs(theta) + std::sqrt(theta * theta + 1.0f));
+                    float c = 1.0f / std::sqrt(t * t + 1.0f);
+                    float s = t * c;
+                    glm::mat3 rotation(1.0f);
+                    rotation[p][p] = c;
+                    rotation[q][q] = c;
+                    rotation[q][p] = s;  // column q, row p
+                    rotation[p][q] = -s; // column p, row q
+                    m = glm::transpose(rotation) * m * rotation;
+                    vectors = vectors * rotation;
+                }
+            }
+        }
+        return vectors;
+    }
+}
+
+const MeshBounds& MeshBounds::ForMesh(const MeshData& mesh)
+{
+    MeshBounds& bounds = mesh.bounds;
+    if (bounds.sourceRevision != mesh.revision) {
+        bounds.Build(mesh);
+        bounds.sourceRevision = mesh.revision;
+    }
+    return bounds;
+}
+
+void MeshBounds::Build(const MeshData& mesh)
+{
+    const std::vector<glm::vec3>& positions = mesh.positions;
+    empty = positions.empty();
+    aabb = AABB();
+    obb = OBB();
+    if (empty)
+        return;
+
+    // Step 1: Axis-aligned bounds and the mean
+    aabb.min = aabb.max = positions[0];
+    glm::vec3 mean(0.0f);
+    for (const glm::vec3& p : positions) {
+        aabb.min = glm::min(aabb.min, p);
+        aabb.max = glm::max(aabb.max, p);
+        mean += p;
+    }
+    mean /= float(positions.size());
+
+    // Step 2: Principal axes from the covariance of the vertices
+    glm::mat3 covariance(0.0f);
+    for (const glm::vec3& p : positions) {
+        glm::vec3 d = p - mean;
+        covariance += glm::outerProduct(d, d);
+    }
+    glm::mat3 axes = SymmetricEigenvectors(covariance);
+
+    // Step 3: Extents along those axes
+    const glm::vec3 axisList[3] = { axes[0], axes[1], axes[2] };
+    glm::vec3 low, high;
+    AxisProjection::Project(positions.data(), positions.size(), axisList, 3, &low.x, &high.x);
+    // Flat meshes get a sliver of thickness so every box axis still gives a test direction
+    const float minimumHalf = 1e-6f * std::max(glm::length(aabb.max - aabb.min), 1e-6f);
+    glm::vec3 half = glm::max((high - low) * 0.5f, glm::vec3(minimumHalf));
+    glm::vec3 middle = (high + low) * 0.5f;
+
+    // Step 4: Keep whichever box is tighter; PCA is poor on symmetric shapes such as boxes
+    glm::vec3 aabbHalf = glm::max((aabb.max - aabb.min) * 0.5f, glm::vec3(minimumHalf));
+    if (half.x * half.y * half.z < aabbHalf.x * aabbHalf.y * aabbHalf.z) {
+        obb.center = axes[0] * middle.x + axes[1] * middle.y + axes[2] * middle.z;
+        for (int i = 0; i < 3; ++i)
+            obb.halfAxes[i] = axes[i] * half[i];
+    }
+    else {
+        obb.center = (aabb.min + aabb.max) * 0.5f;
+        obb.halfAxes[0] = glm::vec3(aabbHalf.x, 0.0f, 0.0f);
+        obb.halfAxes[1] = glm::vec3(0.0f, aabbHalf.y, 0.0f);
+        obb.halfAxes[2] = glm::vec3(0.0f, 0.0f, aabbHalf.z);
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include "glm.hpp"
+#include <vector>
+
+struct MeshData;
+
+struct AABB {
+    glm::vec3 min = glm::vec3(0.0f);
+    glm::vec3 max = glm::vec3(0.0f);
+
+    // outAxis receives a world axis that separates the boxes when they do not overlap
+    bool Overlaps(const AABB& other, glm::vec3* outAxis = nullptr) const;
+    // Bounds of this box after an affine transform (Arvo)
+    AABB Transformed(const glm::mat4& model) const;
+};
+
+// Oriented box as a centre and three half-edge vectors. The vectors are
+// orthogonal in local space; an affine transform may shear them into a
+// parallelepiped, which Overlap still handles exactly.
+struct OBB {
+    glm::vec3 center = glm::vec3(0.0f);
+    glm::vec3 halfAxes[3] = { glm::vec3(0.0f), glm::vec3(0.0f), glm::vec3(0.0f) };
+
+    OBB Transformed(const glm::mat4& model) const;
+    // Separating axis test on the 3 + 3 face normals and 9 edge cross products
+    static bool Overlap(const OBB& a, const OBB& b, glm::vec3* outAxis = nullptr);
+};
+
+// Local-space bounds of a mesh, rebuilt when its revision changes. The OBB is
+// fitted on the principal axes of the vertices, or is the AABB when that is smaller.
+class MeshBounds
+{
+public:
+    void Build(const MeshData& mesh);
+
+    static const MeshBounds& ForMesh(const MeshData& mesh);
+
+    AABB WorldAABB(const glm::mat4& model) const { return aabb.Transformed(model); }
+    OBB WorldOBB(const glm::mat4& model) const { return obb.Transformed(model); }
+
+    AABB aabb;
+    OBB obb;
+    bool empty = true;
+
+    unsigned long long sourceRevision = 0;
+};
@@ -0,0 +1,165 @@
+#include "Broadphase.h"
+#include "MeshData.h"
+#include <algorithm>
+
+void SweepAndPrune::Endpoint::Set(const AABB& bounds)
+{
+    for (int i = 0; i < 3; ++i) {
+        min[i] = bounds.min[i];
+        max[i] = bounds.max[i];
+    }
+}
+
+unsigned int SweepAndPrune::Allocate()
+{
+    unsigned int body;
+    if (!freeBodies.empty()) {
+        body = freeBodies.back();
+        freeBodies.pop_back();
+    }
+    else {
+        body = static_cast<unsigned int>(bodies.size());
+        bodies.emplace_back();
+    }
+    bodies[body] = Body();
+    bodies[body].alive = true;
+    orderDirty = true;
+    return body;
+}
+
+unsigned int SweepAndPrune::Add(const MeshData& mesh, const glm::mat4& model)
+{
+    unsigned int body = Allocate();
+    bodies[body].mesh = &mesh;
+    bodies[body].model = model;
+    bodies[body].revision = mesh.revision;
+    bodies[body].bounds = MeshBounds::ForMesh(mesh).WorldAABB(model);
+    return body;
+}
+
+unsigned int SweepAndPrune::Add(const AABB& bounds)
+{
+    unsigned int body = Allocate();
+    bodies[body].bounds = bounds;
+    return body;
+}
+
+void SweepAndPrune::Remove(unsigned int body)
+{
+    if (body >= bodies.size() || !bodies[body].alive)
+        return;
+    bodies[body].alive = false;
+    bodies[body].mesh = nullptr;
+    freeBodies.push_back(body);
+    orderDirty = true;
+}
+
+void SweepAndPrune::Update(unsigned int body, const glm::mat4& model)
+{
+    if (body >= bodies.size() || !bodies[body].alive)
+        return;
+    Body& entry = bodies[body];
+    if (!entry.mesh || (entry.model == model && entry.revision == entry.mesh->revision))
+        return;
+    entry.model = model;
+    entry.revision = entry.mesh->revision;
+    entry.bounds = MeshBounds::ForMesh(*entry.mesh).WorldAABB(model);
+}
+
+void SweepAndPrune::Update(unsigned int body, const AABB& bounds)
+{
+    if (body >= bodies.size() || !bodies[body].alive)
+        return;
+    bodies[body].bounds = bounds;
+}
+
+// Sweeps along the axis where the box centres are most spread out, which keeps
+// the number of boxes overlapping on that axis alone small. Switching re-sorts
+// everything, so the axis only changes when another one is clearly better.
+void SweepAndPrune::ChooseAxis()
+{
+    glm::vec3 sum(0.0f), sumSquares(0.0f);
+    size_t count = 0;
+    for (const Body& body : bodies) {
+        if (!body.alive)
+            continue;
+        glm::vec3 center = (body.bounds.min + body.bounds.max) * 0.5f;
+        sum += center;
+        sumSquares += center * center;
+        count++;
+    }
+    if (count < 2)
+        return;
+
+    glm::vec3 mean = sum / static_cast<float>(count);
+    glm::vec3 variance = sumSquares / static_cast<float>(count) - mean * mean;
+    int best = 0;
+    if (variance.y > variance[best]) best = 1;
+    if (variance.z > variance[best]) best = 2;
+    if (best != axis && variance[best] > 2.0f * variance[axis]) {
+        axis = best;
+        orderDirty = true;
+    }
+}
+
+const std::vector<BroadphasePair>& SweepAndPrune::FindPairs()
+{
+    pairs.clear();
+    ChooseAxis();
+
+    // Step 1: bring the order up to date. A full sort after structural changes,
+    // otherwise an insertion sort over the nearly sorted previous order.
+    if (orderDirty) {
+        order.clear();
+        for (unsigned int body = 0; body < bodies.size(); ++body) {
+            if (!bodies[body].alive)
+                continue;
+            Endpoint entry;
+            entry.Set(bodies[body].bounds);
+            entry.body = body;
+            order.push_back(entry);
+        }
+        std::sort(order.begin(), order.end(), [this](const Endpoint& a, const Endpoint& b) { return a.min[axis] < b.min[axis]; });
+        orderDirty = false;
+    }
+    else {
+        for (Endpoint& entry : order)
+            entry.Set(bodies[entry.body].bounds);
+        for (size_t i = 1; i < order.size(); ++i) {
+            Endpoint entry = order[i];
+            size_t j = i;
+            while (j > 0 && order[j - 1].min[axis] > entry.min[axis]) {
+                order[j] = order[j - 1];
+                --j;
+            }
+            order[j] = entry;
+        }
+    }
+
+    // Step 2: sweep. Each box is paired with the boxes that start before it ends
+    // on the sweep axis, then filtered on the two remaining axes.
+    const int axis0 = axis;
+    const int axis1 = (axis + 1) % 3;
+    const int axis2 = (axis + 2) % 3;
+    const Endpoint* entries = order.data();
+    const size_t count = order.size();
+    for (size_t i = 0; i < count; ++i) {
+        const Endpoint& a = entries[i];
+        const float end = a.max[axis0];
+        for (size_t j = i + 1; j < count && entries[j].min[axis0] <= end; ++j) {
+            const Endpoint& b = entries[j];
+            // Most candidates fail here at random, so the four compares are combined
+            // without short-circuiting rather than each costing a mispredicted branch
+            const bool separated = (a.min[axis1] > b.max[axis1]) | (a.max[axis1] < b.min[axis1]) |
+                (a.min[axis2] > b.max[axis2]) | (a.max[axis2] < b.min[axis2]);
+            if (separated)
+                continue;
+            pairs.push_back({ std::min(a.body, b.body), std::max(a.body, b.body) });
+        }
+    }
+
+    std::sort(pairs.begin(), pairs.end(), [](const BroadphasePair& a, const BroadphasePair& b) {
+        return a.bodyA != b.bodyA ? a.bodyA < b.bodyA : a.bodyB < b.bodyB;
+    });
+    return pairs;
+}
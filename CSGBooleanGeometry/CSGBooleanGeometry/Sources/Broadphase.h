@@ -0,0 +1,72 @@
+#pragma once
+#include "glm.hpp"
+#include "Bounds.h"
+#include <vector>
+
+struct MeshData;
+
+// Two bodies whose world AABBs overlap; bodyA < bodyB
+struct BroadphasePair {
+    unsigned int bodyA;
+    unsigned int bodyB;
+};
+
+// Scene-level broadphase: incremental sweep and prune over world AABBs.
+// Bodies are kept sorted by their lower bound on one sweep axis. Between
+// queries they only move a little, so the order is repaired with an insertion
+// sort that runs in near linear time; the sweep then reports every pair whose
+// boxes overlap on all three axes.
+//
+// Registered meshes are referenced, not copied, and must outlive their bodies.
+class SweepAndPrune
+{
+public:
+    static constexpr unsigned int InvalidBody = ~0u;
+
+    unsigned int Add(const MeshData& mesh, const glm::mat4& model);
+    // Body without a mesh, for callers that maintain their own bounds
+    unsigned int Add(const AABB& bounds);
+    void Remove(unsigned int body);
+
+    // Recomputes the body's world AABB; a no-op when neither the matrix nor the
+    // mesh revision changed. Removed or unknown bodies are ignored.
+    void Update(unsigned int body, const glm::mat4& model);
+    void Update(unsigned int body, const AABB& bounds);
+
+    // Overlapping pairs sorted by (bodyA, bodyB). Valid until the next call.
+    const std::vector<BroadphasePair>& FindPairs();
+
+    const MeshData* Mesh(unsigned int body) const { return bodies[body].mesh; }
+    const glm::mat4& Model(unsigned int body) const { return bodies[body].model; }
+    const AABB& Bounds(unsigned int body) const { return bodies[body].bounds; }
+    size_t BodyCount() const { return bodies.size() - freeBodies.size(); }
+    int SweepAxis() const { return axis; }
+
+private:
+    struct Body {
+        AABB bounds;
+        glm::mat4 model = glm::mat4(1.0f);
+        const MeshData* mesh = nullptr;
+        unsigned long long revision = 0; // Mesh revision the bounds were built from
+        bool alive = false;
+    };
+    // Sorted entry with a copy of the body's box, so the sweep reads contiguous
+    // memory. Plain arrays: glm's vec3 subscript is a switch on the index.
+    struct Endpoint {
+        float min[3];
+        float max[3];
+        unsigned int body;
+
+        void Set(const AABB& bounds);
+    };
+
+    unsigned int Allocate();
+    void ChooseAxis();
+
+    std::vector<Body> bodies;
+    std::vector<unsigned int> freeBodies;
+    std::vector<Endpoint> order;
+    std::vector<BroadphasePair> pairs;
+    int axis = 0;
+    bool orderDirty = false; // Bodies added or removed, or the axis changed
+};
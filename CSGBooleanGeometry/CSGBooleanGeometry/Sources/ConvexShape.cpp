@@ -0,0 +1,507 @@
+#include "ConvexShape.h"
+#include "AxisProjection.h"
+#include "MeshData.h"
+#include "Predicates.h"
+#include "VertexWelder.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Opposite normals give the same separating axis; flip so the largest component is positive
+    glm::vec3 CanonicalAxis(const glm::vec3& n)
+    {
+        glm::vec3 a = glm::abs(n);
+        int largest = 0;
+        if (a.y > a[largest]) largest = 1;
+        if (a.z > a[largest]) largest = 2;
+        return n[largest] < 0.0f ? -n : n;
+    }
+
+    // Vertex adjacency of a triangle list in CSR form
+    void BuildAdjacency(size_t vertexCount, const std::vector<unsigned int>& indices,
+        std::vector<unsigned int>& outOffsets, std::vector<unsigned int>& outAdjacency)
+    {
+        std::vector<std::vector<unsigned int>> neighbors(vertexCount);
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            for (int e = 0; e < 3; ++e) {
+                unsigned int a = indices[i + e];
+                unsigned int b = indices[i + (e + 1) % 3];
+                if (a == b)
+                    continue;
+                neighbors[a].push_back(b);
+                neighbors[b].push_back(a);
+            }
+        }
+        outOffsets.assign(vertexCount + 1, 0);
+        outAdjacency.clear();
+        for (size_t v = 0; v < vertexCount; ++v) {
+            std::sort(neighbors[v].begin(), neighbors[v].end());
+            neighbors[v].erase(std::unique(neighbors[v].begin(), neighbors[v].end()), neighbors[v].end());
+            outAdjacency.insert(outAdjacency.end(), neighbors[v].begin(), neighbors[v].end());
+            outOffsets[v + 1] = static_cast<unsigned int>(outAdjacency.size());
+        }
+    }
+
+    constexpr unsigned int NoPoint = ~0u;
+
+    struct HullFace {
+        unsigned int v[3] = {};
+        unsigned int neighbor[3] = {}; // Across edge v[i] -> v[(i + 1) % 3]
+        glm::dvec3 normal; // Unit, for picking the farthest point; sides are decided exactly
+        double offset;
+        unsigned int outside = NoPoint; // First point above the face, the rest linked through nextOutside
+        unsigned int farthest = 0;
+        double farthestDistance = -INFINITY;
+        bool alive = true;
+
+        double Distance(const glm::dvec3& p) const { return glm::dot(normal, p) - offset; }
+    };
+
+    // Convex hull by quickhull, as triangles counter-clockwise seen from outside.
+    // Whether a point is above a face is an exact orientation sign, so a face
+    // nearly coplanar with its neighbor can never fold over it; points on a face's
+    // plane count as on the hull. Returns false when the points span no volume.
+    bool QuickHull(const std::vector<glm::vec3>& points, std::vector<unsigned int>& outTriangles)
+    {
+        outTriangles.clear();
+        const unsigned int count = static_cast<unsigned int>(points.size());
+        if (count < 4)
+            return false;
+        auto point = [&points](unsigned int i) { return glm::dvec3(points[i]); };
+
+        // Step 1: a tetrahedron of far apart points. Two of the six axis extremes,
+        // the point farthest from their line, then the one farthest from that plane.
+        unsigned int extremes[6] = {};
+        for (unsigned int i = 1; i < count; ++i) {
+            for (int k = 0; k < 3; ++k) {
+                if (points[i][k] < points[extremes[2 * k]][k]) extremes[2 * k] = i;
+                if (points[i][k] > points[extremes[2 * k + 1]][k]) extremes[2 * k + 1] = i;
+            }
+        }
+        unsigned int a = 0, b = 0;
+        double farthest = -1.0;
+        for (unsigned int i = 0; i < 6; ++i) {
+            for (unsigned int j = i + 1; j < 6; ++j) {
+                const double length = glm::length(point(extremes[i]) - point(extremes[j]));
+                if (length > farthest) {
+                    farthest = length;
+                    a = extremes[i];
+                    b = extremes[j];
+                }
+            }
+        }
+        const glm::dvec3 line = glm::normalize(point(b) - point(a));
+        unsigned int c = a;
+        farthest = 0.0;
+        for (unsigned int i = 0; i < count; ++i) {
+            const double distance = glm::length(glm::cross(point(i) - point(a), line));
+            if (distance > farthest) {
+                farthest = distance;
+                c = i;
+            }
+        }
+        if (c == a)
+            return false;
+        const glm::dvec3 planeNormal = glm::normalize(glm::cross(point(b) - point(a), point(c) - point(a)));
+        unsigned int d = a;
+        farthest = 0.0;
+        for (unsigned int i = 0; i < count; ++i) {
+            const double distance = std::abs(glm::dot(planeNormal, point(i) - point(a)));
+            if (distance > farthest) {
+                farthest = distance;
+                d = i;
+            }
+        }
+        const double side = Predicates::Orient3D(points[a], points[b], points[c], points[d]);
+        if (side == 0.0)
+            return false;
+        if (side > 0.0)
+            std::swap(b, c); // d below a b c
+
+        std::vector<HullFace> faces;
+        auto addFace = [&](unsigned int v0, unsigned int v1, unsigned int v2) {
+            HullFace face;
+            face.v[0] = v0;
+            face.v[1] = v1;
+            face.v[2] = v2;
+            face.normal = glm::normalize(glm::cross(point(v1) - point(v0), point(v2) - point(v0)));
+            face.offset = glm::dot(face.normal, point(v0));
+            faces.push_back(face);
+            return static_cast<unsigned int>(faces.size() - 1);
+        };
+        // Which edge of face f runs from -> to, or -1
+        auto edgeIndex = [&faces](unsigned int f, unsigned int from, unsigned int to) {
+            for (int i = 0; i < 3; ++i) {
+                if (faces[f].v[i] == from && faces[f].v[(i + 1) % 3] == to)
+                    return i;
+            }
+            return -1;
+        };
+        addFace(a, b, c);
+        addFace(a, d, b);
+        addFace(b, d, c);
+        addFace(c, d, a);
+        for (unsigned int f = 0; f < 4; ++f) {
+            for (int i = 0; i < 3; ++i) {
+                for (unsigned int g = 0; g < 4; ++g) {
+                    if (g != f && edgeIndex(g, faces[f].v[(i + 1) % 3], faces[f].v[i]) >= 0)
+                        faces[f].neighbor[i] = g;
+                }
+            }
+        }
+
+        // Step 2: each remaining point goes to the first face it is above
+        std::vector<unsigned int> nextOutside(count, NoPoint);
+        auto above = [&](const HullFace& face, unsigned int i) {
+            return Predicates::Orient3D(points[face.v[0]], points[face.v[1]], points[face.v[2]], points[i]) > 0.0;
+        };
+        auto assign = [&](unsigned int i, const unsigned int* candidates, size_t candidateCount) {
+            for (size_t k = 0; k < candidateCount; ++k) {
+                HullFace& face = faces[candidates[k]];
+                if (above(face, i)) {
+                    const double distance = face.Distance(point(i));
+                    nextOutside[i] = face.outside;
+                    face.outside = i;
+                    if (distance > face.farthestDistance) {
+                        face.farthestDistance = distance;
+                        face.farthest = i;
+                    }
+                    return;
+                }
+            }
+        };
+        const unsigned int start[4] = { 0, 1, 2, 3 };
+        for (unsigned int i = 0; i < count; ++i) {
+            if (i != a && i != b && i != c && i != d)
+                assign(i, start, 4);
+        }
+
+        // Step 3: for each face with points above it, replace the faces its
+        // farthest point sees by a cone from the point to their horizon
+        std::vector<unsigned int> marks, visible, stack, created;
+        std::vector<std::pair<unsigned int, unsigned int>> coneStarts; // (horizon edge start, new face)
+        unsigned int mark = 0;
+        for (unsigned int f = 0; f < faces.size(); ++f) {
+            if (!faces[f].alive || faces[f].outside == NoPoint)
+                continue;
+            const unsigned int eye = faces[f].farthest;
+
+            // Faces that see the eye, connected to f
+            marks.resize(faces.size(), 0);
+            ++mark;
+            visible.clear();
+            stack.assign(1, f);
+            marks[f] = mark;
+            while (!stack.empty()) {
+                const unsigned int g = stack.back();
+                stack.pop_back();
+                visible.push_back(g);
+                for (unsigned int n : faces[g].neighbor) {
+                    if (marks[n] != mark && above(faces[n], eye)) {
+                        marks[n] = mark;
+                        stack.push_back(n);
+                    }
+                }
+            }
+
+            // Cone over the horizon: each edge between a visible and a hidden face
+            created.clear();
+            coneStarts.clear();
+            for (unsigned int g : visible) {
+                for (int i = 0; i < 3; ++i) {
+                    const unsigned int hidden = faces[g].neighbor[i];
+                    if (marks[hidden] == mark)
+                        continue;
+                    const unsigned int from = faces[g].v[i], to = faces[g].v[(i + 1) % 3];
+                    const int back = edgeIndex(hidden, to, from);
+                    if (back < 0)
+                        return false;
+                    const unsigned int cone = addFace(from, to, eye);
+                    faces[cone].neighbor[0] = hidden;
+                    faces[hidden].neighbor[back] = cone;
+                    created.push_back(cone);
+                    coneStarts.push_back({ from, cone });
+                }
+            }
+            // Cone face (from, to, eye) meets the one starting at to across (to, eye)
+            std::sort(coneStarts.begin(), coneStarts.end());
+            for (unsigned int cone : created) {
+                const unsigned int to = faces[cone].v[1];
+                auto next = std::lower_bound(coneStarts.begin(), coneStarts.end(), std::make_pair(to, 0u));
+                if (next == coneStarts.end() || next->first != to || (next + 1 != coneStarts.end() && (next + 1)->first == to))
+                    return false; // The horizon is not one loop
+                faces[cone].neighbor[1] = next->second;
+                faces[next->second].neighbor[2] = cone;
+            }
+
+            // Points above the removed faces move to the cone, or are now inside
+            for (unsigned int g : visible) {
+                faces[g].alive = false;
+                for (unsigned int i = faces[g].outside; i != NoPoint;) {
+                    const unsigned int next = nextOutside[i];
+                    if (i != eye)
+                        assign(i, created.data(), created.size());
+                    i = next;
+                }
+                faces[g].outside = NoPoint;
+            }
+        }
+
+        // Faces in depth-first order across their edges, so consecutive ones
+        // are mostly neighbors and support queries along their normals warm start well
+        ++mark;
+        marks.resize(faces.size(), 0);
+        stack.clear();
+        for (unsigned int f = 0; f < faces.size() && stack.empty(); ++f) {
+            if (faces[f].alive) {
+                stack.push_back(f);
+                marks[f] = mark;
+            }
+        }
+        while (!stack.empty()) {
+            const HullFace& face = faces[stack.back()];
+            stack.pop_back();
+            outTriangles.insert(outTriangles.end(), face.v, face.v + 3);
+            for (unsigned int n : face.neighbor) {
+                if (marks[n] != mark) {
+                    marks[n] = mark;
+                    stack.push_back(n);
+                }
+            }
+        }
+        return true;
+    }
+}
+
+const ConvexShape& ConvexShape::ForMesh(const MeshData& mesh)
+{
+    ConvexShape& shape = mesh.convex;
+    if (shape.sourceRevision != mesh.revision) {
+        shape.Build(mesh);
+        shape.sourceRevision = mesh.revision;
+    }
+    return shape;
+}
+
+void ConvexShape::Build(const MeshData& mesh)
+{
+    std::vector<glm::vec3> points;
+    std::vector<unsigned int> indices;
+    VertexWelder::Weld(mesh.positions, mesh.indices, VertexWelder::DefaultTolerance, points, indices);
+
+    // Step 1: Vertex adjacency of the mesh itself, for the convexity check
+    const size_t pointCount = points.size();
+    std::vector<unsigned int> meshOffsets, meshAdjacency;
+    BuildAdjacency(pointCount, indices, meshOffsets, meshAdjacency);
+
+    // Tolerances below scale with the mesh size
+    glm::vec3 boundsMin(0.0f), boundsMax(0.0f);
+    if (pointCount > 0) {
+        boundsMin = boundsMax = points[0];
+        for (const glm::vec3& v : points) {
+            boundsMin = glm::min(boundsMin, v);
+            boundsMax = glm::max(boundsMax, v);
+        }
+    }
+    center = glm::vec3(0.0f);
+    for (const glm::vec3& v : points)
+        center += v;
+    if (pointCount > 0)
+        center /= float(pointCount);
+    const float planeTolerance = 1e-5f * glm::length(boundsMax - boundsMin);
+
+    // Step 2: Whether the mesh is convex: locally convex at every face
+    convex = pointCount > 0;
+    for (size_t i = 0; i + 2 < indices.size() && convex; i += 3) {
+        const glm::vec3& v0 = points[indices[i]];
+        glm::vec3 normal = glm::cross(points[indices[i + 1]] - v0, points[indices[i + 2]] - v0);
+        float length = glm::length(normal);
+        if (length < 1e-12f)
+            continue;
+        normal /= length;
+        float planeDistance = glm::dot(normal, v0);
+        for (int k = 0; k < 3 && convex; ++k) {
+            unsigned int v = indices[i + k];
+            for (unsigned int n = meshOffsets[v]; n < meshOffsets[v + 1]; ++n) {
+                if (glm::dot(normal, points[meshAdjacency[n]]) - planeDistance > planeTolerance) {
+                    convex = false;
+                    break;
+                }
+            }
+        }
+    }
+
+    // Local convexity only implies convexity for one closed surface: every edge
+    // shared by exactly two triangles and every vertex reachable from the first
+    if (convex) {
+        std::vector<std::pair<unsigned int, unsigned int>> edges;
+        edges.reserve(indices.size());
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            for (int e = 0; e < 3; ++e) {
+                unsigned int a = indices[i + e], b = indices[i + (e + 1) % 3];
+                if (a != b)
+                    edges.push_back({ std::min(a, b), std::max(a, b) });
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+        for (size_t i = 0; i < edges.size() && convex;) {
+            size_t j = i;
+            while (j < edges.size() && edges[j] == edges[i])
+                ++j;
+            convex = j - i == 2;
+            i = j;
+        }
+    }
+    if (convex) {
+        std::vector<char> reached(pointCount, 0);
+        std::vector<unsigned int> stack{ 0 };
+        reached[0] = 1;
+        size_t reachedCount = 1;
+        while (!stack.empty()) {
+            unsigned int v = stack.back();
+            stack.pop_back();
+            for (unsigned int n = meshOffsets[v]; n < meshOffsets[v + 1]; ++n) {
+                if (!reached[meshAdjacency[n]]) {
+                    reached[meshAdjacency[n]] = 1;
+                    reachedCount++;
+                    stack.push_back(meshAdjacency[n]);
+                }
+            }
+        }
+        convex = reachedCount == pointCount;
+    }
+
+    // Step 3: The hull, over its own compacted vertices. Without one (flat or
+    // degenerate input) the shape keeps every welded point and the mesh's faces.
+    std::vector<unsigned int> hullTriangles;
+    hull = QuickHull(points, hullTriangles);
+    const std::vector<unsigned int>* faces = &indices;
+    if (hull) {
+        std::vector<unsigned int> remap(pointCount, VertexWelder::NotFound);
+        vertices.clear();
+        for (unsigned int& v : hullTriangles) {
+            if (remap[v] == VertexWelder::NotFound) {
+                remap[v] = static_cast<unsigned int>(vertices.size());
+                vertices.push_back(points[v]);
+            }
+            v = remap[v];
+        }
+        BuildAdjacency(vertices.size(), hullTriangles, adjacencyOffsets, adjacency);
+        faces = &hullTriangles;
+    }
+    else {
+        vertices = std::move(points);
+        adjacencyOffsets = std::move(meshOffsets);
+        adjacency = std::move(meshAdjacency);
+    }
+
+    // Step 4: Unique face axes
+    axes.clear();
+    VertexWelder uniqueAxes(AxisTolerance);
+    for (size_t i = 0; i + 2 < faces->size(); i += 3) {
+        const glm::vec3& v0 = vertices[(*faces)[i]];
+        glm::vec3 normal = glm::cross(vertices[(*faces)[i + 1]] - v0, vertices[(*faces)[i + 2]] - v0);
+        float length = glm::length(normal);
+        if (length < 1e-12f)
+            continue;
+        bool inserted;
+        uniqueAxes.Insert(CanonicalAxis(normal / length), inserted);
+        if (inserted)
+            axes.push_back(uniqueAxes.Points().back());
+    }
+
+    // Step 5: Own extent along each axis. Without a hull every vertex has to be
+    // projected, which the batch kernel does; otherwise consecutive axes come from
+    // nearby faces, so each support query starts where the previous one ended
+    axisMin.resize(axes.size());
+    axisMax.resize(axes.size());
+    if (!hull) {
+        AxisProjection::Project(vertices.data(), vertices.size(), axes.data(), axes.size(), axisMin.data(), axisMax.data());
+        return;
+    }
+    unsigned int maxVertex = 0, minVertex = 0;
+    for (size_t a = 0; a < axes.size(); ++a) {
+        maxVertex = Support(axes[a], maxVertex);
+        minVertex = Support(-axes[a], minVertex);
+        axisMax[a] = glm::dot(axes[a], vertices[maxVertex]);
+        axisMin[a] = glm::dot(axes[a], vertices[minVertex]);
+    }
+}
+
+unsigned int ConvexShape::Support(const glm::vec3& direction, unsigned int start) const
+{
+    if (!hull) {
+        unsigned int best = 0;
+        float bestDot = -INFINITY;
+        for (unsigned int v = 0; v < vertices.size(); ++v) {
+            float d = glm::dot(direction, vertices[v]);
+            if (d > bestDot) {
+                bestDot = d;
+                best = v;
+            }
+        }
+        return best;
+    }
+
+    // Step 1: Steepest ascent to a vertex with no strictly better neighbor
+    unsigned int current = start < vertices.size() ? start : 0;
+    float currentDot = glm::dot(direction, vertices[current]);
+    bool hasTie = false;
+    for (bool moved = true; moved;) {
+        moved = false;
+        hasTie = false;
+        unsigned int best = current;
+        float bestDot = currentDot;
+        for (unsigned int n = adjacencyOffsets[current]; n < adjacencyOffsets[current + 1]; ++n) {
+            float d = glm::dot(direction, vertices[adjacency[n]]);
+            if (d > bestDot) {
+                best = adjacency[n];
+                bestDot = d;
+            }
+            hasTie |= d == currentDot;
+        }
+        if (best != current) {
+            current = best;
+            currentDot = bestDot;
+            moved = true;
+        }
+    }
+    if (!hasTie)
+        return current;
+
+    // Step 2: Equal neighbors mean a flat region (e.g. interior vertices of a face
+    // perpendicular to direction); search it for an exit that climbs further
+    if (visitStamps.size() != vertices.size() || ++visitStamp == 0) {
+        visitStamps.assign(vertices.size(), 0);
+        visitStamp = 1;
+    }
+    std::vector<unsigned int> stack{ current };
+    visitStamps[current] = visitStamp;
+    while (!stack.empty()) {
+        unsigned int v = stack.back();
+        stack.pop_back();
+        for (unsigned int n = adjacencyOffsets[v]; n < adjacencyOffsets[v + 1]; ++n) {
+            unsigned int w = adjacency[n];
+            float d = glm::dot(direction, vertices[w]);
+            if (d > currentDot)
+                return Support(direction, w);
+            if (d == currentDot && visitStamps[w] != visitStamp) {
+                visitStamps[w] = visitStamp;
+                stack.push_back(w);
+            }
+        }
+    }
+    return current;
+}
+
+void ConvexShape::Project(const glm::mat4& model, const glm::vec3& worldAxis, float& outMin, float& outMax,
+    unsigned int& minHint, unsigned int& maxHint) const
+{
+    // dot(axis, M p + t) = dot(M^T axis, p) + dot(axis, t)
+    glm::vec3 localAxis = glm::transpose(glm::mat3(model)) * worldAxis;
+    float offset = glm::dot(worldAxis, glm::vec3(model[3]));
+    maxHint = Support(localAxis, maxHint);
+    minHint = Support(-localAxis, minHint);
+    outMax = glm::dot(localAxis, vertices[maxHint]) + offset;
+    outMin = glm::dot(localAxis, vertices[minHint]) + offset;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "glm.hpp"
+#include <vector>
+
+struct MeshData;
+
+// Local-space data for convex queries on a mesh, built once per mesh revision.
+// The shape is the convex hull of the mesh's welded positions (quickhull).
+// vertices: the hull's vertices; neighbors of vertex v along hull edges are
+// adjacency[adjacencyOffsets[v] .. adjacencyOffsets[v + 1]).
+// axes: unique unit hull face normals, with coplanar faces and opposite
+// normals collapsed to one axis. axisMin/axisMax: the hull's extent along
+// each axis, so projecting a shape onto its own axes needs no vertex loop.
+// Input that spans no volume gets no hull: vertices and adjacency are then the
+// welded mesh's, axes its face normals, and Support scans every vertex.
+class ConvexShape
+{
+public:
+    void Build(const MeshData& mesh);
+
+    static const ConvexShape& ForMesh(const MeshData& mesh);
+
+    // Vertex with the largest dot(direction, vertex). Hill-climbs the hull from
+    // start, or scans every vertex when there is no hull.
+    unsigned int Support(const glm::vec3& direction, unsigned int start = 0) const;
+
+    // Extent of the shape under model along a world axis. The hints are support
+    // start vertices, updated in place for the next call.
+    void Project(const glm::mat4& model, const glm::vec3& worldAxis, float& outMin, float& outMax,
+        unsigned int& minHint, unsigned int& maxHint) const;
+
+    bool Empty() const { return vertices.empty(); }
+
+    std::vector<glm::vec3> vertices;
+    std::vector<unsigned int> adjacencyOffsets;
+    std::vector<unsigned int> adjacency;
+    std::vector<glm::vec3> axes;
+    std::vector<float> axisMin;
+    std::vector<float> axisMax;
+    glm::vec3 center = glm::vec3(0.0f); // Vertex centroid
+    // vertices and adjacency form a closed convex hull, so hill climbing finds the global extreme
+    bool hull = false;
+    // The mesh itself is convex: closed, connected and locally convex
+    bool convex = false;
+
+    unsigned long long sourceRevision = 0;
+
+    // Face normals closer than this (after sign canonicalization) share an axis
+    static constexpr float AxisTolerance = 1e-5f;
+
+private:
+    // Support's flat-region search marks a vertex seen by setting its stamp to
+    // the current search's; one search at a time, like the other mesh caches
+    mutable std::vector<unsigned int> visitStamps;
+    mutable unsigned int visitStamp = 0;
+};
@@ -0,0 +1,320 @@
+// Self checks for the exact predicates: configurations that are exactly
+// degenerate in float coordinates, and ones an ulp away from it. For Orient3D
+// and InCircle they carry more bits than the double evaluation keeps, so only
+// the exact fallback gets them right. Then one point built from several inputs,
+// which ImplicitPoints must find equal. Last, MeshBoolean: which fragments each
+// operator keeps, and results that are closed by index with volumes that add up.
+// Prints each failure and exits non-zero if any.
+#include "ImplicitPoints.h"
+#include "MeshBoolean.h"
+#include "Predicates.h"
+#include "Shapes.h"
+#include "gtc/matrix_transform.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+    int failures = 0;
+
+    void Check(bool condition, const char* what, int iteration)
+    {
+        if (condition)
+            return;
+        if (++failures <= 20)
+            std::printf("FAILED: %s (iteration %d)\n", what, iteration);
+    }
+
+    int SignOf(double value)
+    {
+        return value > 0.0 ? 1 : (value < 0.0 ? -1 : 0);
+    }
+
+    // Multiples of step in [-range, range], exact in float
+    float Grid(std::mt19937& rng, int range, float step)
+    {
+        return static_cast<float>(std::uniform_int_distribution<int>(-range, range)(rng)) * step;
+    }
+
+    void CheckOrient2D(std::mt19937& rng)
+    {
+        // c = a + k (b - a) stays on the line exactly; moving it by one ulp
+        // across the line flips the sign with the line's direction
+        for (int i = 0; i < 100000; ++i) {
+            const glm::vec2 a(Grid(rng, 1 << 16, 1.0f / 1024), Grid(rng, 1 << 16, 1.0f / 1024));
+            const glm::vec2 b = a + glm::vec2(Grid(rng, 64, 1.0f / 1024), Grid(rng, 64, 1.0f / 1024));
+            if (a == b)
+                continue;
+            const float k = static_cast<float>(std::uniform_int_distribution<int>(-8, 8)(rng));
+            const glm::vec2 c = a + k * (b - a);
+            Check(Predicates::Orient2D(a, b, c) == 0.0, "Orient2D of collinear points is 0", i);
+            if (b.x == a.x)
+                continue;
+            const glm::vec2 above(c.x, std::nextafter(c.y, INFINITY));
+            Check(SignOf(Predicates::Orient2D(a, b, above)) == SignOf(double(b.x) - a.x), "Orient2D one ulp off the line", i);
+        }
+    }
+
+    void CheckOrient3D(std::mt19937& rng)
+    {
+        // Points (x, y, s - x - y) with 23-bit x and y all lie on the plane
+        // x + y + z = s; their products carry more bits than a double holds
+        for (int i = 0; i < 100000; ++i) {
+            const float s = Grid(rng, 1 << 10, 1.0f / 2048);
+            glm::vec3 p[4];
+            for (glm::vec3& q : p) {
+                q.x = Grid(rng, (1 << 22) - 1, 1.0f / 2048);
+                q.y = Grid(rng, (1 << 22) - 1, 1.0f / 2048);
+                q.z = s - q.x - q.y;
+            }
+            Check(Predicates::Orient3D(p[0], p[1], p[2], p[3]) == 0.0, "Orient3D of coplanar points is 0", i);
+
+            // One ulp up in z is on the side the normal's z points to
+            const glm::dvec3 u = glm::dvec3(p[1]) - glm::dvec3(p[0]), v = glm::dvec3(p[2]) - glm::dvec3(p[0]);
+            const int expected = SignOf(u.x * v.y - u.y * v.x);
+            const glm::vec3 raised(p[3].x, p[3].y, std::nextafter(p[3].z, INFINITY));
+            Check(SignOf(Predicates::Orient3D(p[0], p[1], p[2], raised)) == expected, "Orient3D one ulp off the plane", i);
+        }
+    }
+
+    void CheckInCircle(std::mt19937& rng)
+    {
+        // Lattice points on the circle of radius 5^8 about the origin, scaled by
+        // a power of two and moved to a grid centre, are exactly cocircular; their
+        // lifted terms carry more bits than a double holds
+        constexpr int Radius = 390625;
+        std::vector<glm::vec2> circle;
+        for (int x = -Radius; x <= Radius; ++x) {
+            const long long rest = 1LL * Radius * Radius - 1LL * x * x;
+            const int y = static_cast<int>(std::llround(std::sqrt(double(rest))));
+            if (1LL * y * y == rest) {
+                circle.push_back(glm::vec2(float(x), float(y)));
+                if (y != 0)
+                    circle.push_back(glm::vec2(float(x), float(-y)));
+            }
+        }
+        std::uniform_int_distribution<size_t> pick(0, circle.size() - 1);
+        for (int i = 0; i < 100000; ++i) {
+            const float scale = std::ldexp(1.0f, -std::uniform_int_distribution<int>(0, 8)(rng));
+            const glm::vec2 center(Grid(rng, 1 << 22, scale), Grid(rng, 1 << 22, scale));
+            const size_t k[4] = { pick(rng), pick(rng), pick(rng), pick(rng) };
+            if (k[0] == k[1] || k[1] == k[2] || k[2] == k[0])
+                continue;
+            glm::vec2 p[4];
+            for (int j = 0; j < 4; ++j)
+                p[j] = center + scale * circle[k[j]];
+            Check(Predicates::InCircle(p[0], p[1], p[2], p[3]) == 0.0, "InCircle of cocircular points is 0", i);
+
+            // The circle's rightmost point moved one ulp toward the centre is
+            // inside, one ulp away is outside (positive inside for counter-clockwise a, b, c)
+            const int winding = SignOf(Predicates::Orient2D(p[0], p[1], p[2]));
+            const glm::vec2 right = center + glm::vec2(scale * Radius, 0.0f);
+            const glm::vec2 in(std::nextafter(right.x, -INFINITY), right.y);
+            const glm::vec2 out(std::nextafter(right.x, INFINITY), right.y);
+            Check(SignOf(Predicates::InCircle(p[0], p[1], p[2], in)) == winding, "InCircle one ulp inside", i);
+            Check(SignOf(Predicates::InCircle(p[0], p[1], p[2], out)) == -winding, "InCircle one ulp outside", i);
+        }
+    }
+
+    // Triangle r s t with r + s + t = target, so its centroid target / 3 lies in
+    // its plane; false when line p q does not properly cross that plane
+    bool AddPlaneThrough(std::mt19937& rng, std::vector<glm::vec3>& input, unsigned int p, unsigned int q, const glm::vec3& target)
+    {
+        // Around the centroid, on the grid so that t comes out exact
+        const glm::vec3 center = glm::round(target / 3.0f * 64.0f) / 64.0f;
+        const glm::vec3 r = center + glm::vec3(Grid(rng, 4096, 1.0f / 64), Grid(rng, 4096, 1.0f / 64), Grid(rng, 4096, 1.0f / 64));
+        const glm::vec3 s = center + glm::vec3(Grid(rng, 4096, 1.0f / 64), Grid(rng, 4096, 1.0f / 64), Grid(rng, 4096, 1.0f / 64));
+        const glm::vec3 t = target - r - s;
+        const int sideP = SignOf(Predicates::Orient3D(r, s, t, input[p]));
+        const int sideQ = SignOf(Predicates::Orient3D(r, s, t, input[q]));
+        input.push_back(r);
+        input.push_back(s);
+        input.push_back(t);
+        return sideP * sideQ < 0;
+    }
+
+    void CheckDeduplicate(std::mt19937& rng)
+    {
+        ImplicitPoints points;
+        std::vector<unsigned int> representative;
+        std::vector<glm::vec3> rounded;
+        for (int i = 0; i < 2000; ++i) {
+            // Line p q crosses three planes at (2p + q) / 3 and two at (p + 2q) / 3,
+            // neither of which is a float
+            std::vector<glm::vec3> input;
+            input.push_back(glm::vec3(Grid(rng, 1 << 10, 1.0f / 64), Grid(rng, 1 << 10, 1.0f / 64), Grid(rng, 1 << 10, 1.0f / 64)));
+            input.push_back(input[0] + glm::vec3(Grid(rng, 1 << 10, 1.0f / 64), Grid(rng, 1 << 10, 1.0f / 64), Grid(rng, 1 << 10, 1.0f / 64)));
+            // The midpoint is a float: an input vertex, two planes, and two lines through it
+            const glm::vec3 middle = 0.5f * (input[0] + input[1]);
+            const unsigned int middleId = 2;
+            input.push_back(middle);
+            bool crossing = true;
+            unsigned int planes[7];
+            for (unsigned int& plane : planes) {
+                plane = static_cast<unsigned int>(input.size());
+                const size_t k = &plane - planes;
+                const glm::vec3 target = k < 3 ? 2.0f * input[0] + input[1] : (k < 5 ? input[0] + 2.0f * input[1] : 3.0f * middle);
+                crossing = AddPlaneThrough(rng, input, 0, 1, target) && crossing;
+            }
+            if (!crossing || input[0] == input[1])
+                continue;
+            const glm::vec3 a(Grid(rng, 4096, 1.0f / 64), Grid(rng, 4096, 1.0f / 64), 0.0f);
+            const glm::vec3 b(Grid(rng, 4096, 1.0f / 64), Grid(rng, 4096, 1.0f / 64), 0.0f);
+            if (a.x * b.y == a.y * b.x)
+                continue;
+            const unsigned int lines = static_cast<unsigned int>(input.size());
+            input.push_back(middle - a);
+            input.push_back(middle + a);
+            input.push_back(middle - b);
+            input.push_back(middle + b);
+
+            points.Reset(input);
+            unsigned int ids[7];
+            for (int k = 0; k < 7; ++k)
+                ids[k] = points.AddLinePlane(1, 0, planes[k], planes[k] + 1, planes[k] + 2);
+            const unsigned int lineId = points.AddLineLine(lines + 2, lines + 3, lines, lines + 1, 2);
+            points.Deduplicate(representative, rounded);
+
+            Check(representative[ids[0]] == ids[0], "first crossing represents itself", i);
+            Check(representative[ids[1]] == ids[0] && representative[ids[2]] == ids[0], "crossings at one third share a representative", i);
+            Check(representative[ids[3]] == ids[3] && representative[ids[4]] == ids[3], "crossings at two thirds share a representative", i);
+            Check(representative[ids[0]] != representative[ids[3]], "distinct crossings stay apart", i);
+            Check(rounded[ids[1]] == rounded[ids[0]] && rounded[ids[4]] == rounded[ids[3]], "equal points round alike", i);
+            Check(representative[ids[5]] == middleId && representative[ids[6]] == middleId, "crossings on an input vertex take its id", i);
+            Check(representative[lineId] == middleId, "line crossing on an input vertex takes its id", i);
+            Check(rounded[ids[5]] == middle && rounded[lineId] == middle, "a float point rounds to itself", i);
+        }
+    }
+
+    // One separate triangle per operand and label, facing +z, run through Select
+    void CheckOperatorTable()
+    {
+        // keep[op][operand][label]: 1 as is, -1 turned over, 0 dropped
+        constexpr int keep[4][2][4] = {
+            { { 1, 0, 1, 0 }, { 1, 0, 0, 0 } },    // Union
+            { { 0, 1, 1, 0 }, { 0, 1, 0, 0 } },    // Intersection
+            { { 1, 0, 0, 1 }, { 0, -1, 0, 0 } },   // Difference
+            { { 1, -1, 0, 1 }, { 1, -1, 0, 1 } }   // SymmetricDifference
+        };
+        MeshBoolean arrangement;
+        arrangement.tolerance = 1e-6f;
+        for (int operand = 0; operand < 2; ++operand) {
+            for (unsigned char label = 0; label < 4; ++label) {
+                const float x = 10.0f * static_cast<float>(operand * 4 + label);
+                const unsigned int first = static_cast<unsigned int>(arrangement.positions.size());
+                arrangement.positions.push_back(glm::vec3(x, 0.0f, 0.0f));
+                arrangement.positions.push_back(glm::vec3(x + 1.0f, 0.0f, 0.0f));
+                arrangement.positions.push_back(glm::vec3(x, 1.0f, 0.0f));
+                arrangement.indices[operand].insert(arrangement.indices[operand].end(), { first, first + 1, first + 2 });
+                arrangement.labels[operand].push_back(label);
+            }
+        }
+
+        std::vector<glm::vec3> positions;
+        std::vector<unsigned int> indices;
+        std::vector<unsigned char> operands;
+        for (int op = 0; op < 4; ++op) {
+            arrangement.Select(static_cast<BooleanOp>(op), positions, indices, operands);
+            int found[8] = {};
+            bool wrongWay = false;
+            for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+                const glm::vec3& a = positions[indices[t]];
+                const float facing = glm::cross(positions[indices[t + 1]] - a, positions[indices[t + 2]] - a).z;
+                const int source = static_cast<int>(std::lround(a.x / 10.0f - 0.05f));
+                found[source]++;
+                wrongWay = wrongWay || (facing > 0.0f ? 1 : -1) != keep[op][source / 4][source % 4];
+            }
+            for (int source = 0; source < 8; ++source)
+                Check(found[source] == (keep[op][source / 4][source % 4] != 0 ? 1 : 0), "operator keeps the right fragments", op);
+            Check(!wrongWay, "operator orients kept fragments", op);
+        }
+    }
+
+    double Volume(const MeshData& mesh)
+    {
+        double volume = 0.0;
+        for (size_t t = 0; t + 2 < mesh.indices.size(); t += 3) {
+            const glm::dvec3 a = mesh.positions[mesh.indices[t]], b = mesh.positions[mesh.indices[t + 1]], c = mesh.positions[mesh.indices[t + 2]];
+            volume += glm::dot(a, glm::cross(b, c));
+        }
+        return volume / 6.0;
+    }
+
+    // Every edge used once each way round by index: shared by exactly two
+    // triangles, which agree on orientation
+    bool Watertight(const MeshData& mesh)
+    {
+        std::vector<uint64_t> edges;
+        edges.reserve(mesh.indices.size());
+        for (size_t t = 0; t + 2 < mesh.indices.size(); t += 3) {
+            for (int k = 0; k < 3; ++k)
+                edges.push_back(uint64_t(mesh.indices[t + k]) << 32 | mesh.indices[t + (k + 1) % 3]);
+        }
+        std::sort(edges.begin(), edges.end());
+        if (std::adjacent_find(edges.begin(), edges.end()) != edges.end())
+            return false;
+        for (uint64_t edge : edges) {
+            if (!std::binary_search(edges.begin(), edges.end(), edge << 32 | edge >> 32))
+                return false;
+        }
+        return true;
+    }
+
+    void CheckBooleans()
+    {
+        struct Case {
+            MeshData a, b;
+            glm::mat4 modelB;
+        };
+        const glm::mat4 identity(1.0f);
+        const Case cases[] = {
+            { Shapes::CreateSphere(1.0f, 32, 32, glm::vec3(1.0f)), Shapes::CreateBox(1.0f, 1.0f, 2.0f, glm::vec3(1.0f)),
+                glm::translate(identity, glm::vec3(0.5f, 0.3f, 0.2f)) },
+            { Shapes::CreateBox(2.0f, 2.0f, 2.0f, glm::vec3(1.0f)), Shapes::CreateBox(2.0f, 2.0f, 2.0f, glm::vec3(1.0f)),
+                glm::translate(identity, glm::vec3(0.5f, 0.3f, 0.2f)) },
+            // Faces in contact, labelled OppositeOn
+            { Shapes::CreateBox(2.0f, 2.0f, 2.0f, glm::vec3(1.0f)), Shapes::CreateBox(2.0f, 2.0f, 2.0f, glm::vec3(1.0f)),
+                glm::translate(identity, glm::vec3(2.0f, 0.0f, 0.0f)) }
+        };
+        const char* watertight[4] = { "union is watertight", "intersection is watertight",
+            "difference is watertight", "symmetric difference is watertight" };
+        int iteration = 0;
+        for (const Case& test : cases) {
+            for (BooleanArithmetic arithmetic : { BooleanArithmetic::Float, BooleanArithmetic::Exact }) {
+                const std::array<MeshData, 4> results = Shapes::BooleanAll(test.a, identity, test.b, test.modelB, arithmetic);
+                for (int op = 0; op < 4; ++op)
+                    Check(Watertight(results[op]), watertight[op], iteration);
+
+                // The inputs are not welded, but their volumes still add up
+                const double a = Volume(test.a), b = Volume(test.b);
+                const double u = Volume(results[0]), i = Volume(results[1]), d = Volume(results[2]), s = Volume(results[3]);
+                const double tolerance = 1e-5 * (a + b);
+                Check(std::abs(u + i - a - b) < tolerance, "union plus intersection is both volumes", iteration);
+                Check(std::abs(d - (a - i)) < tolerance, "difference is A less the intersection", iteration);
+                Check(std::abs(s - (u - i)) < tolerance, "symmetric difference is union less intersection", iteration);
+                iteration++;
+            }
+        }
+    }
+}
+
+int main()
+{
+    std::mt19937 rng(2024);
+    CheckOrient2D(rng);
+    CheckOrient3D(rng);
+    CheckInCircle(rng);
+    CheckDeduplicate(rng);
+    CheckOperatorTable();
+    CheckBooleans();
+    if (failures > 0) {
+        std::printf("%d self checks failed\n", failures);
+        return 1;
+    }
+    std::printf("All self checks passed\n");
+    return 0;
+}
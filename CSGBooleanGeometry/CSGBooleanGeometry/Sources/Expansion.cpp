@@ -0,0 +1,219 @@
+#include "Expansion.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+    void TwoSum(double a, double b, double& x, double& y)
+    {
+        x = a + b;
+        const double bVirtual = x - a;
+        const double aVirtual = x - bVirtual;
+        y = (a - aVirtual) + (b - bVirtual);
+    }
+
+    void FastTwoSum(double a, double b, double& x, double& y)
+    {
+        x = a + b;
+        y = b - (x - a);
+    }
+
+    void TwoProduct(double a, double b, double& x, double& y)
+    {
+        x = a * b;
+        y = std::fma(a, b, -x);
+    }
+}
+
+Expansion::Expansion(double value)
+{
+    if (value != 0.0)
+        c[n++] = value;
+}
+
+Expansion& Expansion::operator=(const Expansion& other)
+{
+    n = other.n;
+    for (int i = 0; i < n; ++i)
+        c[i] = other.c[i];
+    return *this;
+}
+
+double Expansion::Estimate() const
+{
+    double sum = 0.0;
+    for (int i = 0; i < n; ++i)
+        sum += c[i];
+    return sum;
+}
+
+void Expansion::Compress()
+{
+    // Shewchuk's COMPRESS: the same value in as few components as possible
+    if (n == 0)
+        return;
+    double h[Capacity];
+    int bottom = n - 1;
+    double q = c[bottom];
+    for (int i = n - 2; i >= 0; --i) {
+        double sum, error;
+        FastTwoSum(q, c[i], sum, error);
+        if (error != 0.0) {
+            h[bottom--] = sum;
+            q = error;
+        }
+        else {
+            q = sum;
+        }
+    }
+    int top = 0;
+    for (int i = bottom + 1; i < n; ++i) {
+        double sum, error;
+        FastTwoSum(h[i], q, sum, error);
+        if (error != 0.0)
+            c[top++] = error;
+        q = sum;
+    }
+    c[top++] = q;
+    n = q == 0.0 && top == 1 ? 0 : top;
+}
+
+[[noreturn]] void Expansion::Overflow()
+{
+    // A wrong sign would silently corrupt the caller's topology; stop instead
+    std::fputs("Expansion: result exceeds Capacity components\n", stderr);
+    std::abort();
+}
+
+void Expansion::Difference(double a, double b, Expansion& out)
+{
+    double x, y;
+    TwoSum(a, -b, x, y);
+    out.n = 0;
+    if (y != 0.0)
+        out.c[out.n++] = y;
+    if (x != 0.0)
+        out.c[out.n++] = x;
+}
+
+void Expansion::Sum(const Expansion& e, const Expansion& f, Expansion& out, double sign)
+{
+    // Grows e by one component of f at a time, to at most e.n + f.n components
+    if (e.n + f.n > Capacity)
+        Overflow();
+    if (&out != &e)
+        out = e;
+    for (int j = 0; j < f.n; ++j) {
+        double q = sign * f.c[j];
+        int count = 0;
+        for (int i = 0; i < out.n; ++i) {
+            double sum, error;
+            TwoSum(q, out.c[i], sum, error);
+            q = sum;
+            if (error != 0.0)
+                out.c[count++] = error;
+        }
+        if (q != 0.0)
+            out.c[count++] = q;
+        out.n = count;
+    }
+    out.Compress();
+}
+
+void Expansion::Scale(const Expansion& e, double b, Expansion& out)
+{
+    // Shewchuk's SCALE-EXPANSION with zero elimination, at most 2 * e.n components
+    if (2 * e.n > Capacity)
+        Overflow();
+    out.n = 0;
+    if (e.n == 0 || b == 0.0)
+        return;
+    double q, h;
+    TwoProduct(e.c[0], b, q, h);
+    if (h != 0.0)
+        out.c[out.n++] = h;
+    for (int i = 1; i < e.n; ++i) {
+        double product, productError, sum;
+        TwoProduct(e.c[i], b, product, productError);
+        TwoSum(q, productError, sum, h);
+        if (h != 0.0)
+            out.c[out.n++] = h;
+        TwoSum(product, sum, q, h);
+        if (h != 0.0)
+            out.c[out.n++] = h;
+    }
+    if (q != 0.0)
+        out.c[out.n++] = q;
+}
+
+void Expansion::Product(const Expansion& e, const Expansion& f, Expansion& out)
+{
+    Expansion term;
+    out.n = 0;
+    for (int j = 0; j < f.n; ++j) {
+        Scale(e, f.c[j], term);
+        Sum(out, term, out);
+    }
+}
+
+void Expansion::Determinant2(const Expansion& a, const Expansion& b, const Expansion& c, const Expansion& d, Expansion& out)
+{
+    Expansion bc;
+    Product(a, d, out);
+    Product(b, c, bc);
+    Sum(out, bc, out, -1.0);
+}
+
+void Expansion::Orient2D(const glm::vec2& a, const glm::vec2& b, const glm::vec2& c, Expansion& out)
+{
+    Expansion acx, acy, bcx, bcy;
+    Difference(a.x, c.x, acx);
+    Difference(a.y, c.y, acy);
+    Difference(b.x, c.x, bcx);
+    Difference(b.y, c.y, bcy);
+    Determinant2(acx, acy, bcx, bcy, out);
+}
+
+void Expansion::Orient3D(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const glm::vec3& d, Expansion& out)
+{
+    Orient3D(glm::dvec3(a), glm::dvec3(b), glm::dvec3(c), glm::dvec3(d), out);
+}
+
+void Expansion::Orient3D(const glm::dvec3& a, const glm::dvec3& b, const glm::dvec3& c, const glm::dvec3& d, Expansion& out)
+{
+    Expansion ab[3], ac[3], ad[3];
+    for (int k = 0; k < 3; ++k) {
+        Difference(b[k], a[k], ab[k]);
+        Difference(c[k], a[k], ac[k]);
+        Difference(d[k], a[k], ad[k]);
+    }
+    Expansion minor, term;
+    out.n = 0;
+    for (int k = 0; k < 3; ++k) {
+        const int i = (k + 1) % 3, j = (k + 2) % 3;
+        Determinant2(ab[i], ab[j], ac[i], ac[j], minor);
+        Product(minor, ad[k], term);
+        Sum(out, term, out);
+    }
+}
+
+void Expansion::InCircle(const glm::vec2& a, const glm::vec2& b, const glm::vec2& c, const glm::vec2& d, Expansion& out)
+{
+    Expansion x[3], y[3];
+    const glm::vec2 p[3] = { a, b, c };
+    for (int k = 0; k < 3; ++k) {
+        Difference(p[k].x, d.x, x[k]);
+        Difference(p[k].y, d.y, y[k]);
+    }
+    Expansion lift, square, minor, term;
+    out.n = 0;
+    for (int k = 0; k < 3; ++k) {
+        const int i = (k + 1) % 3, j = (k + 2) % 3;
+        Product(x[k], x[k], lift);
+        Product(y[k], y[k], square);
+        Sum(lift, square, lift);
+        Determinant2(x[i], y[i], x[j], y[j], minor);
+        Product(lift, minor, term);
+        Sum(out, term, out);
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "glm.hpp"
+
+// A real number held exactly as a sum of non-overlapping doubles, smallest
+// first and without zeros (Shewchuk's expansions). Sums, differences and
+// products of them are exact; every result is compressed, which keeps values
+// built from float input to a few dozen components. The exact fallbacks of
+// Predicates and ImplicitPoints are written in these.
+struct Expansion
+{
+    static constexpr int Capacity = 192;
+
+    Expansion() = default;
+    explicit Expansion(double value);
+    Expansion(const Expansion& other) { *this = other; }
+    Expansion& operator=(const Expansion& other);
+
+    double Estimate() const;
+    int Sign() const { return n == 0 ? 0 : (c[n - 1] > 0.0 ? 1 : -1); }
+
+    // Results are written to a caller-provided out, so the arrays are neither
+    // returned nor copied. out may be e in Sum and must not alias any other
+    // argument. A result that would not fit in Capacity aborts.
+    static void Difference(double a, double b, Expansion& out);
+    // e + sign * f
+    static void Sum(const Expansion& e, const Expansion& f, Expansion& out, double sign = 1.0);
+    static void Scale(const Expansion& e, double b, Expansion& out);
+    static void Product(const Expansion& e, const Expansion& f, Expansion& out);
+    // a * d - b * c
+    static void Determinant2(const Expansion& a, const Expansion& b, const Expansion& c, const Expansion& d, Expansion& out);
+
+    // The determinants of Predicates, exactly
+    static void Orient2D(const glm::vec2& a, const glm::vec2& b, const glm::vec2& c, Expansion& out);
+    static void Orient3D(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const glm::vec3& d, Expansion& out);
+    static void Orient3D(const glm::dvec3& a, const glm::dvec3& b, const glm::dvec3& c, const glm::dvec3& d, Expansion& out);
+    static void InCircle(const glm::vec2& a, const glm::vec2& b, const glm::vec2& c, const glm::vec2& d, Expansion& out);
+
+    double c[Capacity];
+    int n = 0;
+
+private:
+    void Compress();
+    [[noreturn]] static void Overflow();
+};
@@ -0,0 +1,381 @@
+#include "GJK.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+namespace {
+    // Point of the Minkowski difference with the shape vertices it came from
+    struct SupportPoint {
+        glm::vec3 w;
+        unsigned int a;
+        unsigned int b;
+    };
+
+    struct Simplex {
+        SupportPoint points[4];
+        int size = 0;
+    };
+
+    class MinkowskiDifference
+    {
+    public:
+        MinkowskiDifference(const ConvexShape& a, const glm::mat4& modelA, const ConvexShape& b, const glm::mat4& modelB,
+            unsigned int hintA, unsigned int hintB)
+            : a(a), b(b), modelA(modelA), modelB(modelB),
+            toLocalA(glm::transpose(glm::mat3(modelA))), toLocalB(glm::transpose(glm::mat3(modelB))),
+            hintA(hintA), hintB(hintB) {}
+
+        SupportPoint Support(const glm::vec3& direction)
+        {
+            hintA = a.Support(toLocalA * direction, hintA);
+            hintB = b.Support(toLocalB * -direction, hintB);
+            return Point(hintA, hintB);
+        }
+
+        SupportPoint Point(unsigned int vertexA, unsigned int vertexB) const
+        {
+            glm::vec3 pa = glm::vec3(modelA * glm::vec4(a.vertices[vertexA], 1.0f));
+            glm::vec3 pb = glm::vec3(modelB * glm::vec4(b.vertices[vertexB], 1.0f));
+            return { pa - pb, vertexA, vertexB };
+        }
+
+        glm::vec3 CenterOffset() const
+        {
+            return glm::vec3(modelA * glm::vec4(a.center, 1.0f)) - glm::vec3(modelB * glm::vec4(b.center, 1.0f));
+        }
+
+        const ConvexShape& a;
+        const ConvexShape& b;
+        const glm::mat4& modelA;
+        const glm::mat4& modelB;
+        glm::mat3 toLocalA, toLocalB; // Directions map with M^T: dot(d, M p) = dot(M^T d, p)
+        unsigned int hintA, hintB;
+    };
+
+    // Closest point to the origin on triangle abc (Ericson, Real-Time Collision
+    // Detection 5.1.5). Also returns which vertices span the closest feature.
+    glm::vec3 ClosestOnTriangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, int& featureMask)
+    {
+        glm::vec3 ab = b - a, ac = c - a;
+        float d1 = glm::dot(ab, -a), d2 = glm::dot(ac, -a);
+        if (d1 <= 0.0f && d2 <= 0.0f) { featureMask = 1; return a; }
+
+        float d3 = glm::dot(ab, -b), d4 = glm::dot(ac, -b);
+        if (d3 >= 0.0f && d4 <= d3) { featureMask = 2; return b; }
+
+        float vc = d1 * d4 - d3 * d2;
+        if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+            featureMask = 1 | 2;
+            return a + ab * (d1 / (d1 - d3));
+        }
+
+        float d5 = glm::dot(ab, -c), d6 = glm::dot(ac, -c);
+        if (d6 >= 0.0f && d5 <= d6) { featureMask = 4; return c; }
+
+        float vb = d5 * d2 - d1 * d6;
+        if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+            featureMask = 1 | 4;
+            return a + ac * (d2 / (d2 - d6));
+        }
+
+        float va = d3 * d6 - d5 * d4;
+        if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+            featureMask = 2 | 4;
+            return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+        }
+
+        float denom = va + vb + vc;
+        if (denom == 0.0f) { featureMask = 1; return a; } // Degenerate triangle
+        featureMask = 1 | 2 | 4;
+        return a + ab * (vb / denom) + ac * (vc / denom);
+    }
+
+    void KeepFeature(Simplex& simplex, const int (&vertices)[3], int featureMask)
+    {
+        SupportPoint kept[3];
+        int count = 0;
+        for (int i = 0; i < 3; ++i) {
+            if (featureMask & (1 << i))
+                kept[count++] = simplex.points[vertices[i]];
+        }
+        for (int i = 0; i < count; ++i)
+            simplex.points[i] = kept[i];
+        simplex.size = count;
+    }
+
+    // Closest point to the origin on the simplex, reducing the simplex to the
+    // feature it lies on. A tetrahedron that contains the origin is kept whole
+    // and returns the origin. Makes no assumption about how the simplex was
+    // built, so a simplex carried over from a previous query is valid input.
+    glm::vec3 ClosestOnSimplex(Simplex& simplex)
+    {
+        SupportPoint* p = simplex.points;
+        switch (simplex.size) {
+        case 1:
+            return p[0].w;
+        case 2: {
+            glm::vec3 ab = p[1].w - p[0].w;
+            float lengthSquared = glm::dot(ab, ab);
+            float t = lengthSquared > 0.0f ? glm::dot(-p[0].w, ab) / lengthSquared : 0.0f;
+            if (t <= 0.0f) { simplex.size = 1; return p[0].w; }
+            if (t >= 1.0f) { p[0] = p[1]; simplex.size = 1; return p[0].w; }
+            return p[0].w + ab * t;
+        }
+        case 3: {
+            int featureMask;
+            glm::vec3 closest = ClosestOnTriangle(p[0].w, p[1].w, p[2].w, featureMask);
+            KeepFeature(simplex, { 0, 1, 2 }, featureMask);
+            return closest;
+        }
+        default: {
+            // Faces the origin is in front of (on the far side from the fourth vertex)
+            static const int faces[4][4] = { { 0, 1, 2, 3 }, { 0, 3, 1, 2 }, { 0, 2, 3, 1 }, { 1, 3, 2, 0 } };
+            float bestDistance = FLT_MAX;
+            glm::vec3 best(0.0f);
+            int bestFace = -1, bestMask = 0;
+            for (int f = 0; f < 4; ++f) {
+                const glm::vec3& a = p[faces[f][0]].w;
+                glm::vec3 normal = glm::cross(p[faces[f][1]].w - a, p[faces[f][2]].w - a);
+                float originSide = glm::dot(-a, normal);
+                float oppositeSide = glm::dot(p[faces[f][3]].w - a, normal);
+                if (originSide * oppositeSide > 0.0f)
+                    continue;
+                int featureMask;
+                glm::vec3 closest = ClosestOnTriangle(a, p[faces[f][1]].w, p[faces[f][2]].w, featureMask);
+                float distance = glm::dot(closest, closest);
+                if (distance < bestDistance) {
+                    bestDistance = distance;
+                    best = closest;
+                    bestFace = f;
+                    bestMask = featureMask;
+                }
+            }
+            if (bestFace < 0)
+                return glm::vec3(0.0f); // Origin inside
+            KeepFeature(simplex, { faces[bestFace][0], faces[bestFace][1], faces[bestFace][2] }, bestMask);
+            return best;
+        }
+        }
+    }
+
+    bool RunGJK(MinkowskiDifference& difference, Simplex& simplex, glm::vec3& direction, int& iterations)
+    {
+        // Step 1: Start from the carried-over simplex, else one support point
+        if (simplex.size == 0) {
+            if (glm::dot(direction, direction) == 0.0f)
+                direction = difference.CenterOffset();
+            if (glm::dot(direction, direction) == 0.0f)
+                direction = glm::vec3(1.0f, 0.0f, 0.0f);
+            simplex.points[0] = difference.Support(-direction);
+            simplex.size = 1;
+        }
+
+        // Step 2: Move the simplex toward the origin until it encloses it or a
+        // support point fails to pass it
+        float scaleSquared = 0.0f;
+        for (iterations = 0; iterations < GJK::MaxIterations; ++iterations) {
+            for (int i = 0; i < simplex.size; ++i)
+                scaleSquared = std::max(scaleSquared, glm::dot(simplex.points[i].w, simplex.points[i].w));
+
+            glm::vec3 closest = ClosestOnSimplex(simplex);
+            float distanceSquared = glm::dot(closest, closest);
+            if (simplex.size == 4 || distanceSquared <= 1e-12f * scaleSquared)
+                return true;
+
+            direction = -closest;
+            SupportPoint next = difference.Support(direction);
+            if (glm::dot(next.w, direction) < 0.0f)
+                return false; // The whole difference is on the far side of a plane through the origin
+
+            // No progress toward the origin: closest is the true closest point, origin outside.
+            // A support point already in the simplex means the same, with rounding in the way.
+            if (glm::dot(next.w - closest, direction) <= 1e-6f * distanceSquared)
+                return false;
+            for (int i = 0; i < simplex.size; ++i) {
+                if (simplex.points[i].a == next.a && simplex.points[i].b == next.b)
+                    return false;
+            }
+
+            simplex.points[simplex.size++] = next;
+        }
+        return true; // Out of iterations while still closing in; report overlap
+    }
+
+    // Grows a simplex that touches the origin into a tetrahedron for EPA
+    bool BuildTetrahedron(MinkowskiDifference& difference, Simplex& simplex)
+    {
+        static const glm::vec3 directions[6] = {
+            { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+        auto tryAdd = [&](const glm::vec3& direction, auto isNew) {
+            SupportPoint p = difference.Support(direction);
+            if (!isNew(p.w))
+                return false;
+            simplex.points[simplex.size++] = p;
+            return true;
+        };
+
+        if (simplex.size == 1) {
+            for (const glm::vec3& d : directions) {
+                if (tryAdd(d, [&](const glm::vec3& w) { return glm::length(w - simplex.points[0].w) > 1e-6f; }))
+                    break;
+            }
+        }
+        if (simplex.size == 2) {
+            glm::vec3 axis = simplex.points[1].w - simplex.points[0].w;
+            glm::vec3 a = glm::abs(axis);
+            glm::vec3 helper = (a.x <= a.y && a.x <= a.z) ? glm::vec3(1, 0, 0) : (a.y <= a.z ? glm::vec3(0, 1, 0) : glm::vec3(0, 0, 1));
+            glm::vec3 perpendicular = glm::normalize(glm::cross(axis, helper));
+            glm::vec3 other = glm::normalize(glm::cross(axis, perpendicular));
+            for (int k = 0; k < 6 && simplex.size == 2; ++k) {
+                float angle = k * 3.14159265f / 3.0f;
+                glm::vec3 d = perpendicular * std::cos(angle) + other * std::sin(angle);
+                tryAdd(d, [&](const glm::vec3& w) {
+                    return glm::length(glm::cross(w - simplex.points[0].w, axis)) > 1e-6f * glm::length(axis);
+                });
+            }
+        }
+        if (simplex.size == 3) {
+            glm::vec3 normal = glm::cross(simplex.points[1].w - simplex.points[0].w, simplex.points[2].w - simplex.points[0].w);
+            auto offPlane = [&](const glm::vec3& w) { return std::abs(glm::dot(w - simplex.points[0].w, normal)) > 1e-6f * glm::length(normal); };
+            if (!tryAdd(normal, offPlane))
+                tryAdd(-normal, offPlane);
+        }
+        return simplex.size == 4;
+    }
+
+    struct PolytopeFace {
+        unsigned int v[3];
+        glm::vec3 normal;
+        float distance;
+    };
+
+    // Expanding polytope: push the face of the difference nearest the origin
+    // outward until the support point along its normal adds nothing
+    Penetration RunEPA(MinkowskiDifference& difference, const Simplex& simplex)
+    {
+        std::vector<SupportPoint> points(simplex.points, simplex.points + 4);
+        std::vector<PolytopeFace> faces;
+        glm::vec3 interior = (points[0].w + points[1].w + points[2].w + points[3].w) * 0.25f;
+
+        auto addFace = [&](unsigned int i, unsigned int j, unsigned int k) {
+            // A degenerate face keeps the infinite distance and is never chosen
+            PolytopeFace face{ { i, j, k }, glm::vec3(0.0f), FLT_MAX };
+            glm::vec3 normal = glm::cross(points[j].w - points[i].w, points[k].w - points[i].w);
+            float length = glm::length(normal);
+            if (length >= 1e-12f) {
+                // Wind outward, away from the polytope interior
+                if (glm::dot(normal, points[i].w - interior) < 0.0f) {
+                    std::swap(face.v[1], face.v[2]);
+                    normal = -normal;
+                }
+                face.normal = normal / length;
+                face.distance = glm::dot(face.normal, points[i].w);
+            }
+            faces.push_back(face);
+        };
+        addFace(0, 1, 2);
+        addFace(0, 3, 1);
+        addFace(0, 2, 3);
+        addFace(1, 3, 2);
+
+        Penetration result;
+        std::vector<std::pair<unsigned int, unsigned int>> horizon;
+        for (int iteration = 0; iteration < GJK::MaxEPAIterations; ++iteration) {
+            size_t closest = 0;
+            for (size_t f = 1; f < faces.size(); ++f) {
+                if (faces[f].distance < faces[closest].distance)
+                    closest = f;
+            }
+            result.normal = faces[closest].normal;
+            result.depth = std::max(0.0f, faces[closest].distance);
+
+            SupportPoint next = difference.Support(result.normal);
+            float reach = glm::dot(next.w, result.normal);
+            if (reach - faces[closest].distance <= 1e-5f * std::max(1.0f, reach))
+                break;
+
+            // Remove every face the new point sees; their unshared edges form the horizon
+            unsigned int nextIndex = static_cast<unsigned int>(points.size());
+            points.push_back(next);
+            horizon.clear();
+            for (size_t f = 0; f < faces.size();) {
+                const PolytopeFace& face = faces[f];
+                if (face.distance != FLT_MAX && glm::dot(face.normal, next.w - points[face.v[0]].w) <= 0.0f) {
+                    ++f;
+                    continue;
+                }
+                for (int e = 0; e < 3; ++e) {
+                    std::pair<unsigned int, unsigned int> edge(face.v[e], face.v[(e + 1) % 3]);
+                    auto shared = std::find(horizon.begin(), horizon.end(), std::make_pair(edge.second, edge.first));
+                    if (shared != horizon.end())
+                        horizon.erase(shared);
+                    else
+                        horizon.push_back(edge);
+                }
+                faces[f] = faces.back();
+                faces.pop_back();
+            }
+            if (horizon.empty())
+                break;
+            for (const auto& edge : horizon)
+                addFace(edge.first, edge.second, nextIndex);
+        }
+        return result;
+    }
+
+    bool Run(const ConvexShape& a, const glm::mat4& modelA, const ConvexShape& b, const glm::mat4& modelB,
+        GJKCache* cache, Penetration* penetration)
+    {
+        if (a.Empty() || b.Empty())
+            return false;
+
+        MinkowskiDifference difference(a, modelA, b, modelB, cache ? cache->hintA : 0, cache ? cache->hintB : 0);
+        Simplex simplex;
+        glm::vec3 direction(0.0f);
+        if (cache) {
+            // The cached ids are re-evaluated under the new transforms
+            for (int i = 0; i < cache->simplexSize; ++i) {
+                if (cache->simplexA[i] < a.vertices.size() && cache->simplexB[i] < b.vertices.size())
+                    simplex.points[simplex.size++] = difference.Point(cache->simplexA[i], cache->simplexB[i]);
+            }
+            direction = cache->direction;
+        }
+
+        int iterations = 0;
+        bool intersecting = RunGJK(difference, simplex, direction, iterations);
+
+        if (cache) {
+            cache->simplexSize = simplex.size;
+            for (int i = 0; i < simplex.size; ++i) {
+                cache->simplexA[i] = simplex.points[i].a;
+                cache->simplexB[i] = simplex.points[i].b;
+            }
+            cache->direction = direction;
+            cache->lastIterations = iterations;
+        }
+
+        if (intersecting && penetration) {
+            *penetration = Penetration();
+            if (BuildTetrahedron(difference, simplex))
+                *penetration = RunEPA(difference, simplex);
+        }
+
+        if (cache) {
+            cache->hintA = difference.hintA;
+            cache->hintB = difference.hintB;
+        }
+        return intersecting;
+    }
+}
+
+bool GJK::Intersect(const ConvexShape& a, const glm::mat4& modelA, const ConvexShape& b, const glm::mat4& modelB, GJKCache* cache)
+{
+    return Run(a, modelA, b, modelB, cache, nullptr);
+}
+
+bool GJK::Intersect(const ConvexShape& a, const glm::mat4& modelA, const ConvexShape& b, const glm::mat4& modelB,
+    Penetration& outPenetration, GJKCache* cache)
+{
+    return Run(a, modelA, b, modelB, cache, &outPenetration);
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include "glm.hpp"
+#include "ConvexShape.h"
+
+// State kept between GJK calls on the same pair of shapes. Reusing it starts
+// the next query from the last simplex and search direction, and starts the
+// support hill climbing from the last extreme vertices, so re-testing a pair
+// that moved a little converges in one or two iterations.
+struct GJKCache {
+    unsigned int simplexA[4] = {};  // ConvexShape vertex ids of the last simplex
+    unsigned int simplexB[4] = {};
+    int simplexSize = 0;
+    glm::vec3 direction = glm::vec3(0.0f); // Last search direction, world space
+    unsigned int hintA = 0;
+    unsigned int hintB = 0;
+    int lastIterations = 0;
+};
+
+// Penetration of two intersecting shapes: moving B by normal * depth (or A by
+// -normal * depth) makes them touch. World space.
+struct Penetration {
+    glm::vec3 normal = glm::vec3(0.0f);
+    float depth = 0.0f;
+};
+
+// Gilbert-Johnson-Keerthi overlap test on the Minkowski difference A - B, with
+// the expanding polytope algorithm for penetration depth. Shapes are treated
+// as the convex hull of their vertices.
+class GJK
+{
+public:
+    static bool Intersect(const ConvexShape& a, const glm::mat4& modelA, const ConvexShape& b, const glm::mat4& modelB,
+        GJKCache* cache = nullptr);
+
+    // Runs GJK and, when the shapes intersect, EPA to fill outPenetration
+    static bool Intersect(const ConvexShape& a, const glm::mat4& modelA, const ConvexShape& b, const glm::mat4& modelB,
+        Penetration& outPenetration, GJKCache* cache = nullptr);
+
+    static constexpr int MaxIterations = 64;
+    static constexpr int MaxEPAIterations = 64;
+};
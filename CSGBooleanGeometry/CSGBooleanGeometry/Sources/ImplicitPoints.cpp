@@ -0,0 +1,381 @@
+#include "ImplicitPoints.h"
+#include "Expansion.h"
+#include "Predicates.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+namespace {
+    // Closed interval with outward rounding. Widening a rounded result by two
+    // units in its last place (plus the smallest subnormal, for underflow) still
+    // contains the exact result after the widening itself is rounded.
+    struct Interval {
+        double lo, hi;
+    };
+
+    constexpr double Widen = 0x1p-51;
+    constexpr double Tiny = std::numeric_limits<double>::denorm_min();
+
+    double Down(double x) { return x - (std::abs(x) * Widen + Tiny); }
+    double Up(double x) { return x + (std::abs(x) * Widen + Tiny); }
+
+    Interval Point(double x) { return { x, x }; }
+    Interval operator+(const Interval& a, const Interval& b) { return { Down(a.lo + b.lo), Up(a.hi + b.hi) }; }
+    Interval operator-(const Interval& a, const Interval& b) { return { Down(a.lo - b.hi), Up(a.hi - b.lo) }; }
+    Interval operator*(const Interval& a, const Interval& b)
+    {
+        const double p[4] = { a.lo * b.lo, a.lo * b.hi, a.hi * b.lo, a.hi * b.hi };
+        return { Down(std::min(std::min(p[0], p[1]), std::min(p[2], p[3]))), Up(std::max(std::max(p[0], p[1]), std::max(p[2], p[3]))) };
+    }
+    Interval Abs(const Interval& a)
+    {
+        if (a.lo >= 0.0)
+            return a;
+        if (a.hi <= 0.0)
+            return { -a.hi, -a.lo };
+        return { 0.0, std::max(-a.lo, a.hi) };
+    }
+
+    glm::vec2 Project(const glm::vec3& p, int axis)
+    {
+        return glm::vec2(p[(axis + 1) % 3], p[(axis + 2) % 3]);
+    }
+
+    Interval Orient2DInterval(const glm::vec2& a, const glm::vec2& b, const glm::vec2& c)
+    {
+        const Interval acx = Point(a.x) - Point(c.x), acy = Point(a.y) - Point(c.y);
+        const Interval bcx = Point(b.x) - Point(c.x), bcy = Point(b.y) - Point(c.y);
+        return acx * bcy - acy * bcx;
+    }
+
+    // Predicates' double evaluation and error bound, which is far cheaper than
+    // the same determinant in interval arithmetic and about as tight
+    Interval Orient3DInterval(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const glm::vec3& d)
+    {
+        double bound;
+        const double det = Predicates::Orient3DApproximate(a, b, c, d, bound);
+        return { Down(det - bound), Up(det + bound) };
+    }
+
+    int Sign(const Interval& a)
+    {
+        return a.lo > 0.0 ? 1 : (a.hi < 0.0 ? -1 : 0);
+    }
+
+    // The point divides line p q at dp : -dq, dp and dq being its ends' signed
+    // distances of opposite signs: p + (q - p) * |dp| / (|dp| + |dq|). Bounding
+    // that ratio directly keeps the box tight, where the homogeneous quotient
+    // would count dp twice.
+    void CrossingBox(const glm::vec3& p, const glm::vec3& q, const Interval& dp, const Interval& dq, double lo[3], double hi[3])
+    {
+        const Interval a = Abs(dp), b = Abs(dq);
+        Interval t = { 0.0, 1.0 };
+        if (a.lo > 0.0)
+            t.lo = std::max(0.0, Down(a.lo / Up(a.lo + b.hi)));
+        if (b.lo > 0.0)
+            t.hi = std::min(1.0, Up(a.hi / Down(a.hi + b.lo)));
+        for (int k = 0; k < 3; ++k) {
+            if (p[k] == q[k]) {
+                // Exact: the whole line has this coordinate
+                lo[k] = hi[k] = p[k];
+                continue;
+            }
+            const Interval coordinate = Point(p[k]) + (Point(q[k]) - Point(p[k])) * t;
+            lo[k] = coordinate.lo;
+            hi[k] = coordinate.hi;
+        }
+    }
+
+    // Homogeneous coordinates (x / w, y / w, z / w) of a point
+    void Homogeneous(const ImplicitPoints::Point& point, const std::vector<glm::vec3>& input, Expansion x[3], Expansion& w)
+    {
+        if (point.kind == ImplicitPoints::Vertex) {
+            for (int k = 0; k < 3; ++k)
+                x[k] = Expansion(input[point.v[0]][k]);
+            w = Expansion(1.0);
+            return;
+        }
+        const glm::vec3& p = input[point.v[0]];
+        const glm::vec3& q = input[point.v[1]];
+        Expansion dp, dq;
+        if (point.kind == ImplicitPoints::LinePlane) {
+            Expansion::Orient3D(input[point.v[2]], input[point.v[3]], input[point.v[4]], p, dp);
+            Expansion::Orient3D(input[point.v[2]], input[point.v[3]], input[point.v[4]], q, dq);
+        }
+        else {
+            const glm::vec2 r = Project(input[point.v[2]], point.axis), s = Project(input[point.v[3]], point.axis);
+            Expansion::Orient2D(r, s, Project(p, point.axis), dp);
+            Expansion::Orient2D(r, s, Project(q, point.axis), dq);
+        }
+        // p + (q - p) * dp / (dp - dq) = (q * dp - p * dq) / (dp - dq)
+        Expansion qdp, pdq;
+        for (int k = 0; k < 3; ++k) {
+            Expansion::Scale(dp, q[k], qdp);
+            Expansion::Scale(dq, p[k], pdq);
+            Expansion::Sum(qdp, pdq, x[k], -1.0);
+        }
+        Expansion::Sum(dp, dq, w, -1.0);
+    }
+}
+
+bool ImplicitPoints::Point::operator==(const Point& other) const
+{
+    return kind == other.kind && axis == other.axis && std::equal(v, v + 5, other.v);
+}
+
+void ImplicitPoints::Reset(const std::vector<glm::vec3>& inputPositions)
+{
+    input = inputPositions;
+    points.clear();
+    boxes.clear();
+    points.reserve(input.size());
+    boxes.reserve(input.size());
+    for (unsigned int i = 0; i < input.size(); ++i) {
+        points.push_back({ Vertex, 0, { i, 0, 0, 0, 0 } });
+        const glm::vec3& p = input[i];
+        boxes.push_back({ { p.x, p.y, p.z }, { p.x, p.y, p.z } });
+    }
+}
+
+unsigned int ImplicitPoints::Add(const Point& point)
+{
+    Box box;
+    const glm::vec3& p = input[point.v[0]];
+    const glm::vec3& q = input[point.v[1]];
+    if (point.kind == LinePlane) {
+        const glm::vec3 &r = input[point.v[2]], &s = input[point.v[3]], &t = input[point.v[4]];
+        CrossingBox(p, q, Orient3DInterval(r, s, t, p), Orient3DInterval(r, s, t, q), box.lo, box.hi);
+    }
+    else {
+        const glm::vec2 r = Project(input[point.v[2]], point.axis), s = Project(input[point.v[3]], point.axis);
+        CrossingBox(p, q, Orient2DInterval(r, s, Project(p, point.axis)), Orient2DInterval(r, s, Project(q, point.axis)), box.lo, box.hi);
+    }
+    points.push_back(point);
+    boxes.push_back(box);
+    return static_cast<unsigned int>(points.size() - 1);
+}
+
+unsigned int ImplicitPoints::AddLinePlane(unsigned int p, unsigned int q, unsigned int r, unsigned int s, unsigned int t)
+{
+    Point point{ LinePlane, 0, { std::min(p, q), std::max(p, q), r, s, t } };
+    std::sort(point.v + 2, point.v + 5);
+    return Add(point);
+}
+
+unsigned int ImplicitPoints::AddLineLine(unsigned int p, unsigned int q, unsigned int r, unsigned int s, int axis)
+{
+    std::pair<unsigned int, unsigned int> first(std::min(p, q), std::max(p, q)), second(std::min(r, s), std::max(r, s));
+    if (second < first)
+        std::swap(first, second);
+    // The point is placed along its first line, whose ends must then straddle the other
+    const glm::vec2 a = Project(input[second.first], axis), b = Project(input[second.second], axis);
+    const double sideFirst = Predicates::Orient2D(a, b, Project(input[first.first], axis));
+    const double sideSecond = Predicates::Orient2D(a, b, Project(input[first.second], axis));
+    if (!((sideFirst < 0.0 && sideSecond > 0.0) || (sideFirst > 0.0 && sideSecond < 0.0)))
+        std::swap(first, second);
+    return Add({ LineLine, static_cast<unsigned char>(axis), { first.first, first.second, second.first, second.second, 0 } });
+}
+
+int ImplicitPoints::Orient2D(unsigned int a, unsigned int b, unsigned int c, int axis) const
+{
+    const unsigned int ids[3] = { a, b, c };
+    const int i = (axis + 1) % 3, j = (axis + 2) % 3;
+
+    // Coordinates known exactly (zero-width boxes) are floats: when all are,
+    // Predicates decides, and three points on one coordinate line are collinear
+    bool exactX = true, exactY = true;
+    for (int k = 0; k < 3; ++k) {
+        exactX = exactX && boxes[ids[k]].lo[i] == boxes[ids[k]].hi[i];
+        exactY = exactY && boxes[ids[k]].lo[j] == boxes[ids[k]].hi[j];
+    }
+    if (exactX && exactY) {
+        auto at = [&](unsigned int id) { return glm::vec2(float(boxes[id].lo[i]), float(boxes[id].lo[j])); };
+        const double det = Predicates::Orient2D(at(a), at(b), at(c));
+        return det > 0.0 ? 1 : (det < 0.0 ? -1 : 0);
+    }
+    if ((exactX && boxes[a].lo[i] == boxes[b].lo[i] && boxes[a].lo[i] == boxes[c].lo[i])
+        || (exactY && boxes[a].lo[j] == boxes[b].lo[j] && boxes[a].lo[j] == boxes[c].lo[j]))
+        return 0;
+
+    Interval x[3], y[3];
+    for (int k = 0; k < 3; ++k) {
+        x[k] = { boxes[ids[k]].lo[i], boxes[ids[k]].hi[i] };
+        y[k] = { boxes[ids[k]].lo[j], boxes[ids[k]].hi[j] };
+    }
+    const int filtered = Sign((x[0] - x[2]) * (y[1] - y[2]) - (y[0] - y[2]) * (x[1] - x[2]));
+    if (filtered != 0)
+        return filtered;
+
+    // det [x y w] of the three rows, over w_a * w_b * w_c
+    Expansion h[3][3], w[3];
+    int sign = 1;
+    for (int k = 0; k < 3; ++k) {
+        Expansion coordinates[3];
+        Homogeneous(points[ids[k]], input, coordinates, w[k]);
+        h[k][0] = coordinates[i];
+        h[k][1] = coordinates[j];
+        h[k][2] = w[k];
+        sign *= w[k].Sign();
+    }
+    Expansion minor, term, det;
+    Expansion::Determinant2(h[1][1], h[1][2], h[2][1], h[2][2], minor);
+    Expansion::Product(h[0][0], minor, det);
+    Expansion::Determinant2(h[1][0], h[1][2], h[2][0], h[2][2], minor);
+    Expansion::Product(h[0][1], minor, term);
+    Expansion::Sum(det, term, det, -1.0);
+    Expansion::Determinant2(h[1][0], h[1][1], h[2][0], h[2][1], minor);
+    Expansion::Product(h[0][2], minor, term);
+    Expansion::Sum(det, term, det);
+    return det.Sign() * sign;
+}
+
+int ImplicitPoints::Compare(unsigned int a, unsigned int b, int axis) const
+{
+    if (boxes[a].hi[axis] < boxes[b].lo[axis])
+        return -1;
+    if (boxes[a].lo[axis] > boxes[b].hi[axis])
+        return 1;
+    if (boxes[a].lo[axis] == boxes[a].hi[axis] && boxes[b].lo[axis] == boxes[b].hi[axis])
+        return 0; // Exact coordinates that overlap are equal
+    if (points[a] == points[b])
+        return 0;
+
+    Expansion xa[3], wa, xb[3], wb;
+    Homogeneous(points[a], input, xa, wa);
+    Homogeneous(points[b], input, xb, wb);
+    Expansion difference, term;
+    Expansion::Product(xa[axis], wb, difference);
+    Expansion::Product(xb[axis], wa, term);
+    Expansion::Sum(difference, term, difference, -1.0);
+    return difference.Sign() * wa.Sign() * wb.Sign();
+}
+
+bool ImplicitPoints::Equal(unsigned int a, unsigned int b) const
+{
+    if (a == b || points[a] == points[b])
+        return true;
+    for (int k = 0; k < 3; ++k) {
+        if (Compare(a, b, k) != 0)
+            return false;
+    }
+    return true;
+}
+
+int ImplicitPoints::ProjectionAxis(const unsigned int corners[3], int& outSign) const
+{
+    const glm::vec3 a = input[corners[0]];
+    const glm::vec3 normal = glm::abs(glm::cross(input[corners[1]] - a, input[corners[2]] - a));
+    int axes[3] = { 0, 1, 2 };
+    std::sort(axes, axes + 3, [&](int l, int r) { return normal[l] > normal[r]; });
+    for (int axis : axes) {
+        outSign = Orient2D(corners[0], corners[1], corners[2], axis);
+        if (outSign != 0)
+            return axis;
+    }
+    return axes[0];
+}
+
+glm::vec3 ImplicitPoints::Rounded(unsigned int i) const
+{
+    const Point& point = points[i];
+    if (point.kind == Vertex)
+        return input[point.v[0]];
+
+    const Box& box = boxes[i];
+    Expansion x[3], w, scaled, difference;
+    bool homogeneous = false;
+    glm::vec3 out;
+    for (int k = 0; k < 3; ++k) {
+        // Every value in the box rounds to the same float: so does the point
+        const float lo = static_cast<float>(box.lo[k]), hi = static_cast<float>(box.hi[k]);
+        if (lo == hi) {
+            out[k] = lo;
+            continue;
+        }
+        if (!homogeneous) {
+            Homogeneous(point, input, x, w);
+            homogeneous = true;
+        }
+        // Sign of the coordinate minus m
+        auto side = [&](double m) {
+            if (m < box.lo[k])
+                return 1;
+            if (m > box.hi[k])
+                return -1;
+            Expansion::Scale(w, m, scaled);
+            Expansion::Sum(x[k], scaled, difference, -1.0);
+            return difference.Sign() * w.Sign();
+        };
+        auto odd = [](float f) { return (std::bit_cast<uint32_t>(f) & 1u) != 0; };
+
+        // Step from the estimate to the float whose rounding interval, the
+        // midpoints to its neighbours, holds the coordinate
+        float f = static_cast<float>(x[k].Estimate() / w.Estimate());
+        for (int step = 0; step < 64; ++step) {
+            const float below = std::nextafter(f, -INFINITY), above = std::nextafter(f, INFINITY);
+            const int low = side(0.5 * (double(below) + double(f)));
+            if (low < 0 || (low == 0 && odd(f))) {
+                f = below;
+                continue;
+            }
+            const int high = side(0.5 * (double(f) + double(above)));
+            if (high > 0 || (high == 0 && odd(f))) {
+                f = above;
+                continue;
+            }
+            break;
+        }
+        out[k] = f;
+    }
+    return out;
+}
+
+glm::dvec3 ImplicitPoints::Approximate(unsigned int i) const
+{
+    const Box& box = boxes[i];
+    return glm::dvec3(0.5 * (box.lo[0] + box.hi[0]), 0.5 * (box.lo[1] + box.hi[1]), 0.5 * (box.lo[2] + box.hi[2]));
+}
+
+void ImplicitPoints::Deduplicate(std::vector<unsigned int>& outRepresentative, std::vector<glm::vec3>& outRounded) const
+{
+    const unsigned int count = static_cast<unsigned int>(points.size());
+    outRounded.resize(count);
+    for (unsigned int i = 0; i < count; ++i)
+        outRounded[i] = Rounded(i);
+
+    // Equal points round alike, so only points of one rounded position need an
+    // exact comparison; sorting by id within it makes the first one the smallest
+    std::vector<unsigned int> order(count);
+    for (unsigned int i = 0; i < count; ++i)
+        order[i] = i;
+    auto less = [&](unsigned int l, unsigned int r) {
+        const glm::vec3 &a = outRounded[l], &b = outRounded[r];
+        if (a.x != b.x)
+            return a.x < b.x;
+        if (a.y != b.y)
+            return a.y < b.y;
+        return a.z < b.z;
+    };
+    std::sort(order.begin(), order.end(), [&](unsigned int l, unsigned int r) { return less(l, r) || (!less(r, l) && l < r); });
+
+    outRepresentative.resize(count);
+    for (size_t first = 0; first < order.size();) {
+        size_t end = first + 1;
+        while (end < order.size() && !less(order[first], order[end]))
+            ++end;
+        for (size_t k = first; k < end; ++k) {
+            const unsigned int id = order[k];
+            outRepresentative[id] = id;
+            for (size_t m = first; m < k; ++m) {
+                if (outRepresentative[order[m]] == order[m] && Equal(order[m], id)) {
+                    outRepresentative[id] = order[m];
+                    break;
+                }
+            }
+        }
+        first = end;
+    }
+}
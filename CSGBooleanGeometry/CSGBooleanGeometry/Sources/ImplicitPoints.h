@@ -0,0 +1,75 @@
+#pragma once
+#include "glm.hpp"
+#include <vector>
+
+// Points given by the input they come from rather than by coordinates, for the
+// exact boolean: an input vertex, the crossing of an input edge with an input
+// triangle's plane, or the crossing of two coplanar input edges. Their
+// homogeneous coordinates are polynomials in input coordinates, so predicates
+// on them can be decided exactly. Each point caches an interval box around it;
+// a predicate first runs in interval arithmetic on the boxes and only falls
+// back to expansion arithmetic when the interval straddles zero.
+// Coordinates are rounded to floats only when asked for, and then to nearest,
+// so equal points always round alike.
+class ImplicitPoints
+{
+public:
+    enum Kind : unsigned char {
+        Vertex,    // Input vertex v[0]
+        LinePlane, // Line v[0] v[1] through the plane of triangle v[2] v[3] v[4]
+        LineLine   // Line v[0] v[1], whose ends straddle line v[2] v[3], through it; both in one plane, seen down axis
+    };
+
+    struct Point {
+        Kind kind;
+        unsigned char axis;
+        unsigned int v[5];
+        bool operator==(const Point& other) const;
+    };
+
+    // The input vertices become points 0 .. input.size() - 1
+    void Reset(const std::vector<glm::vec3>& input);
+
+    // Ids of new points. Line p q must properly cross the plane; for two lines,
+    // the ends of at least one must lie strictly on either side of the other.
+    // Endpoints are stored in a canonical order, so the same construction from
+    // either neighbouring triangle gives an equal Point.
+    unsigned int AddLinePlane(unsigned int p, unsigned int q, unsigned int r, unsigned int s, unsigned int t);
+    unsigned int AddLineLine(unsigned int p, unsigned int q, unsigned int r, unsigned int s, int axis);
+
+    size_t Size() const { return points.size(); }
+    const Point& operator[](unsigned int i) const { return points[i]; }
+    const std::vector<glm::vec3>& Input() const { return input; }
+
+    // Sign of the orientation of a, b, c projected along axis (onto coordinates
+    // axis + 1 and axis + 2, cyclically): positive counter-clockwise
+    int Orient2D(unsigned int a, unsigned int b, unsigned int c, int axis) const;
+    // Sign of coordinate axis of a minus that of b
+    int Compare(unsigned int a, unsigned int b, int axis) const;
+    bool Equal(unsigned int a, unsigned int b) const;
+    // Axis to project input triangle corners along: the one their normal is
+    // largest in, unless the triangle is exactly edge-on to it. outSign is
+    // Orient2D of the projected corners, 0 only for a degenerate triangle.
+    int ProjectionAxis(const unsigned int corners[3], int& outSign) const;
+    // Nearest float position (ties to even)
+    glm::vec3 Rounded(unsigned int i) const;
+    // Position to within a few double roundings: the middle of the point's box
+    glm::dvec3 Approximate(unsigned int i) const;
+
+    // outRepresentative[i] is the smallest id of a point equal to point i, so
+    // input vertices represent the constructed points landing on them.
+    // outRounded[i] is Rounded(i).
+    void Deduplicate(std::vector<unsigned int>& outRepresentative, std::vector<glm::vec3>& outRounded) const;
+
+private:
+    struct Box {
+        double lo[3];
+        double hi[3];
+    };
+
+    unsigned int Add(const Point& point);
+
+    std::vector<glm::vec3> input;
+    std::vector<Point> points;
+    std::vector<Box> boxes;
+};
@@ -0,0 +1,160 @@
+#include "IntersectionGraph.h"
+#include <algorithm>
+
+void IntersectionGraph::Build(const std::vector<TriangleSegment>& triangleSegmentList, VertexWelder& points,
+    size_t triangleCountA, size_t triangleCountB)
+{
+    segments.clear();
+    for (const TriangleSegment& segment : triangleSegmentList) {
+        if (segment.coplanar)
+            continue;
+        const unsigned int start = points.Insert(segment.start);
+        const unsigned int end = points.Insert(segment.end);
+        if (start != end)
+            segments.push_back({ segment.triangleA, segment.triangleB, start, end });
+    }
+    Index(triangleCountA, triangleCountB);
+}
+
+void IntersectionGraph::Build(const std::vector<ImplicitTriangleSegment>& triangleSegmentList, const std::vector<unsigned int>& representative,
+    size_t triangleCountA, size_t triangleCountB)
+{
+    segments.clear();
+    for (const ImplicitTriangleSegment& segment : triangleSegmentList) {
+        if (segment.coplanar)
+            continue;
+        const unsigned int start = representative[segment.start];
+        const unsigned int end = representative[segment.end];
+        if (start != end)
+            segments.push_back({ segment.triangleA, segment.triangleB, start, end });
+    }
+    Index(triangleCountA, triangleCountB);
+}
+
+void IntersectionGraph::Index(size_t triangleCountA, size_t triangleCountB)
+{
+    std::sort(segments.begin(), segments.end(), [](const Segment& l, const Segment& r) {
+        return l.triangleA != r.triangleA ? l.triangleA < r.triangleA : l.triangleB < r.triangleB;
+        });
+
+    // Segments of each triangle in CSR form, by counting sort
+    const size_t triangleCounts[2] = { triangleCountA, triangleCountB };
+    for (int operand = 0; operand < 2; ++operand) {
+        auto triangleOf = [operand](const Segment& segment) { return operand == 0 ? segment.triangleA : segment.triangleB; };
+        std::vector<unsigned int>& offset = offsets[operand];
+        offset.assign(triangleCounts[operand] + 1, 0);
+        for (const Segment& segment : segments)
+            offset[triangleOf(segment) + 1]++;
+        for (size_t t = 0; t < triangleCounts[operand]; ++t)
+            offset[t + 1] += offset[t];
+        triangleSegments[operand].resize(segments.size());
+        std::vector<unsigned int> fill(offset.begin(), offset.end() - 1);
+        for (unsigned int s = 0; s < segments.size(); ++s)
+            triangleSegments[operand][fill[triangleOf(segments[s])]++] = s;
+    }
+}
+
+std::pair<const unsigned int*, const unsigned int*> IntersectionGraph::TriangleSegments(int operand, unsigned int triangle) const
+{
+    const unsigned int* base = triangleSegments[operand].data();
+    return { base + offsets[operand][triangle], base + offsets[operand][triangle + 1] };
+}
+
+void IntersectionGraph::Polylines(std::vector<Polyline>& outPolylines) const
+{
+    std::vector<Link> links;
+    links.reserve(segments.size());
+    for (const Segment& segment : segments)
+        links.push_back({ segment.start, segment.end });
+    Chain(links, outPolylines);
+}
+
+void IntersectionGraph::Chain(const std::vector<Link>& links, std::vector<Polyline>& outPolylines)
+{
+    outPolylines.clear();
+
+    // Step 1: unique undirected links over compact vertex ids
+    std::vector<Link> unique;
+    unique.reserve(links.size());
+    for (Link link : links) {
+        if (link.first == link.second)
+            continue;
+        if (link.first > link.second)
+            std::swap(link.first, link.second);
+        unique.push_back(link);
+    }
+    std::sort(unique.begin(), unique.end());
+    unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+
+    std::vector<unsigned int> vertices;
+    vertices.reserve(unique.size() * 2);
+    for (const Link& link : unique) {
+        vertices.push_back(link.first);
+        vertices.push_back(link.second);
+    }
+    std::sort(vertices.begin(), vertices.end());
+    vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+    auto local = [&](unsigned int point) {
+        return static_cast<unsigned int>(std::lower_bound(vertices.begin(), vertices.end(), point) - vertices.begin());
+    };
+
+    // Step 2: links around each vertex in CSR form
+    std::vector<unsigned int> offset(vertices.size() + 1, 0);
+    for (const Link& link : unique) {
+        offset[local(link.first) + 1]++;
+        offset[local(link.second) + 1]++;
+    }
+    for (size_t v = 0; v < vertices.size(); ++v)
+        offset[v + 1] += offset[v];
+    std::vector<unsigned int> incident(offset.back());
+    std::vector<unsigned int> fill(offset.begin(), offset.end() - 1);
+    for (unsigned int l = 0; l < unique.size(); ++l) {
+        incident[fill[local(unique[l].first)]++] = l;
+        incident[fill[local(unique[l].second)]++] = l;
+    }
+    auto degree = [&](unsigned int v) { return offset[v + 1] - offset[v]; };
+
+    // Step 3: walk from vertex v along link l while the chain passes through
+    // vertices of degree two
+    std::vector<unsigned char> used(unique.size(), 0);
+    auto walk = [&](unsigned int v, unsigned int l, Polyline& polyline) {
+        polyline.points.push_back(vertices[v]);
+        while (!used[l]) {
+            used[l] = 1;
+            const unsigned int next = local(unique[l].first) == v ? local(unique[l].second) : local(unique[l].first);
+            v = next;
+            if (degree(v) != 2) {
+                polyline.points.push_back(vertices[v]);
+                return;
+            }
+            const unsigned int a = incident[offset[v]];
+            const unsigned int b = incident[offset[v] + 1];
+            const unsigned int following = a == l ? b : a;
+            if (used[following])
+                return; // Back at the start of a cycle
+            polyline.points.push_back(vertices[v]);
+            l = following;
+        }
+    };
+
+    // Open chains start at ends and branch points; whatever is left forms cycles
+    for (unsigned int v = 0; v < vertices.size(); ++v) {
+        if (degree(v) == 2)
+            continue;
+        for (unsigned int i = offset[v]; i < offset[v + 1]; ++i) {
+            if (used[incident[i]])
+                continue;
+            Polyline polyline;
+            walk(v, incident[i], polyline);
+            outPolylines.push_back(std::move(polyline));
+        }
+    }
+    for (unsigned int l = 0; l < unique.size(); ++l) {
+        if (used[l])
+            continue;
+        Polyline polyline;
+        polyline.closed = true;
+        walk(local(unique[l].first), l, polyline);
+        outPolylines.push_back(std::move(polyline));
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "glm.hpp"
+#include "TriangleIntersection.h"
+#include "VertexWelder.h"
+#include <utility>
+#include <vector>
+
+// Intersection curves of two meshes as a graph. Every crossing triangle pair
+// contributes one segment, kept under its (triangleA, triangleB) key, with its
+// endpoints welded so that the segments of neighbouring pairs share them. Each
+// triangle of either mesh lists the segments lying in it, so no consumer has to
+// recover their order by sorting; the whole curve chains into polylines on request.
+class IntersectionGraph
+{
+public:
+    struct Segment {
+        unsigned int triangleA;
+        unsigned int triangleB;
+        unsigned int start; // Point ids
+        unsigned int end;
+    };
+
+    struct Polyline {
+        std::vector<unsigned int> points; // In order; a closed polyline does not repeat its first point
+        bool closed = false;
+    };
+
+    using Link = std::pair<unsigned int, unsigned int>; // Undirected, by point id
+
+    // Takes the segments of TriangleIntersection::IntersectPairs; coplanar entries
+    // carry no segment and are skipped. Endpoints are welded through points, which
+    // may already hold other points (the meshes' vertices, say) to share ids with.
+    void Build(const std::vector<TriangleSegment>& triangleSegments, VertexWelder& points,
+        size_t triangleCountA, size_t triangleCountB);
+    // The same for the exact intersection, whose endpoints are already point ids;
+    // representative[id] is the id to use for each, equal points sharing one
+    void Build(const std::vector<ImplicitTriangleSegment>& triangleSegments, const std::vector<unsigned int>& representative,
+        size_t triangleCountA, size_t triangleCountB);
+
+    // Segments lying in a triangle of A (operand 0) or B (operand 1), as ids into segments
+    std::pair<const unsigned int*, const unsigned int*> TriangleSegments(int operand, unsigned int triangle) const;
+    // The whole curve as polylines, chained on each call
+    void Polylines(std::vector<Polyline>& outPolylines) const;
+
+    // Chains links into maximal polylines. A chain stops at points where other
+    // than two links meet; repeated links count once.
+    static void Chain(const std::vector<Link>& links, std::vector<Polyline>& outPolylines);
+
+    std::vector<Segment> segments; // Sorted by (triangleA, triangleB); point-sized ones are dropped
+
+private:
+    void Index(size_t triangleCountA, size_t triangleCountB);
+
+    std::vector<unsigned int> offsets[2]; // Per operand, CSR over triangles into triangleSegments
+    std::vector<unsigned int> triangleSegments[2];
+};
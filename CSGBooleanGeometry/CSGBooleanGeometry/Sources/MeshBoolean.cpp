@@ -0,0 +1,783 @@
+#include "MeshBoolean.h"
+#include "MeshData.h"
+#include "ImplicitPoints.h"
+#include "IntersectionGraph.h"
+#include "MeshPatches.h"
+#include "PlaneTable.h"
+#include "PolygonTriangulator.h"
+#include "Predicates.h"
+#include "Shapes.h"
+#include "TriangleIntersection.h"
+#include "TriangleSplitter.h"
+#include "VertexWelder.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace {
+    // Weld distance in multiples of the largest coordinate: far above the round-off
+    // of the intersection points, far below any feature worth keeping
+    constexpr float RelativeTolerance = 1e-6f;
+
+    struct PointRecord {
+        unsigned int triangle;
+        unsigned int point;
+        bool operator<(const PointRecord& other) const { return triangle != other.triangle ? triangle < other.triangle : point < other.point; }
+        bool operator==(const PointRecord& other) const { return triangle == other.triangle && point == other.point; }
+    };
+
+    struct SegmentRecord {
+        unsigned int triangle;
+        unsigned int a, b;
+    };
+
+    struct EdgePoint {
+        uint64_t edge;
+        unsigned int point;
+        bool operator<(const EdgePoint& other) const { return edge != other.edge ? edge < other.edge : point < other.point; }
+        bool operator==(const EdgePoint& other) const { return edge == other.edge && point == other.point; }
+    };
+
+    uint64_t EdgeKey(unsigned int a, unsigned int b)
+    {
+        if (a > b)
+            std::swap(a, b);
+        return (uint64_t(a) << 32) | b;
+    }
+
+    // Part of segment p0-p1, lying in the plane of triangle v, that is inside the
+    // triangle. Segments along an edge count as inside.
+    bool ClipToTriangle(const glm::vec3 v[3], const glm::vec3& p0, const glm::vec3& p1, float tolerance, glm::vec3& out0, glm::vec3& out1)
+    {
+        const glm::vec3 normal = glm::normalize(glm::cross(v[1] - v[0], v[2] - v[0]));
+        const glm::vec3 direction = p1 - p0;
+        const float length = glm::length(direction);
+        float enter = 0.0f;
+        float leave = 1.0f;
+        for (int e = 0; e < 3; ++e) {
+            const glm::vec3 inward = glm::normalize(glm::cross(normal, v[(e + 1) % 3] - v[e]));
+            const float start = glm::dot(inward, p0 - v[e]);
+            const float slope = glm::dot(inward, direction);
+            if (std::abs(slope) <= 1e-6f * length) {
+                if (start < -tolerance)
+                    return false;
+                continue;
+            }
+            const float t = -start / slope;
+            if (slope > 0.0f)
+                enter = std::max(enter, t);
+            else
+                leave = std::min(leave, t);
+        }
+        if ((leave - enter) * length <= tolerance)
+            return false;
+        out0 = p0 + enter * direction;
+        out1 = p0 + leave * direction;
+        return true;
+    }
+
+    // ClipToTriangle on implicit points: the part of input edge p-q, coplanar
+    // with input triangle v, inside the triangle, ending where it crosses the
+    // triangle's edges. Only a part of positive length counts.
+    bool ClipToTriangleExact(ImplicitPoints& points, const unsigned int v[3], unsigned int p, unsigned int q,
+        unsigned int& out0, unsigned int& out1)
+    {
+        int sign;
+        const int axis = points.ProjectionAxis(v, sign);
+        if (sign == 0)
+            return false;
+        int k = (axis + 1) % 3;
+        int direction = points.Compare(q, p, k);
+        if (direction == 0) {
+            k = (axis + 2) % 3;
+            direction = points.Compare(q, p, k);
+        }
+        if (direction == 0)
+            return false;
+        auto later = [&](unsigned int a, unsigned int b) { return points.Compare(a, b, k) * direction > 0; };
+
+        out0 = p;
+        out1 = q;
+        for (int e = 0; e < 3; ++e) {
+            const unsigned int a = v[e], b = v[(e + 1) % 3];
+            const int sideP = points.Orient2D(a, b, p, axis) * sign;
+            const int sideQ = points.Orient2D(a, b, q, axis) * sign;
+            if (sideP >= 0 && sideQ >= 0)
+                continue;
+            if (sideP <= 0 && sideQ <= 0)
+                return false; // Outside, or touching the edge's line at one end
+            const unsigned int crossing = points.AddLineLine(p, q, a, b, axis);
+            if (sideP < 0 && later(crossing, out0))
+                out0 = crossing;
+            else if (sideQ < 0 && later(out1, crossing))
+                out1 = crossing;
+        }
+        return later(out1, out0);
+    }
+
+    constexpr int Undecided = -2;
+
+    // Containment by ray parity with exact crossing tests, for points that may lie
+    // closer to the surface than PlaneTable and WindingNumber resolve: 1 inside,
+    // 0 outside, -1 on the surface. A ray that grazes an edge or a vertex is
+    // cast again in another direction; Undecided when every one of them grazed.
+    int SideExact(const BVH& bvh, const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices,
+        const glm::dvec3& point, double reach, float margin, std::vector<unsigned int>& candidates)
+    {
+        static const glm::dvec3 directions[] = {
+            { 0.5773503, 0.6154122, 0.5366563 }, { -0.3511234, 0.8017837, -0.4834938 },
+            { 0.7071068, -0.3162278, 0.6324555 }, { -0.6246950, -0.4902903, 0.6076436 } };
+        // After the fixed ones, directions spread over the sphere by the golden angle
+        constexpr int SpreadCount = 32;
+        for (int attempt = 0; attempt < 4 + SpreadCount; ++attempt) {
+            glm::dvec3 direction;
+            if (attempt < 4) {
+                direction = directions[attempt];
+            }
+            else {
+                const double z = 1.0 - (2.0 * (attempt - 4) + 1.0) / SpreadCount;
+                const double r = std::sqrt(1.0 - z * z);
+                const double phi = 2.399963229728653 * (attempt - 4);
+                direction = { r * std::cos(phi), r * std::sin(phi), z };
+            }
+            const glm::dvec3 end = point + reach * direction;
+            candidates.clear();
+            bvh.QuerySegment(glm::vec3(point), glm::vec3(end), candidates, margin);
+            bool inside = false;
+            bool grazing = false;
+            for (size_t k = 0; k < candidates.size() && !grazing; ++k) {
+                const unsigned int* t = indices.data() + size_t(candidates[k]) * 3;
+                const glm::dvec3 a = positions[t[0]], b = positions[t[1]], c = positions[t[2]];
+                const double start = Predicates::Orient3D(a, b, c, point);
+                const double stop = Predicates::Orient3D(a, b, c, end);
+                if (start == 0.0 && stop != 0.0) {
+                    // On the plane: on the surface when inside the triangle too
+                    const double sides[3] = { Predicates::Orient3D(point, end, a, b), Predicates::Orient3D(point, end, b, c),
+                        Predicates::Orient3D(point, end, c, a) };
+                    if ((sides[0] >= 0.0 && sides[1] >= 0.0 && sides[2] >= 0.0) || (sides[0] <= 0.0 && sides[1] <= 0.0 && sides[2] <= 0.0))
+                        return -1;
+                    continue;
+                }
+                if ((start > 0.0) == (stop > 0.0) && stop != 0.0)
+                    continue;
+                const double sides[3] = { Predicates::Orient3D(point, end, a, b), Predicates::Orient3D(point, end, b, c),
+                    Predicates::Orient3D(point, end, c, a) };
+                const bool anyPositive = sides[0] > 0.0 || sides[1] > 0.0 || sides[2] > 0.0;
+                const bool anyNegative = sides[0] < 0.0 || sides[1] < 0.0 || sides[2] < 0.0;
+                if (anyPositive && anyNegative)
+                    continue;
+                if (stop == 0.0 || sides[0] == 0.0 || sides[1] == 0.0 || sides[2] == 0.0)
+                    grazing = true;
+                else
+                    inside = !inside;
+            }
+            if (!grazing)
+                return inside ? 1 : 0;
+        }
+        return Undecided;
+    }
+
+    // 1 to keep a fragment as is, -1 to keep it turned over, 0 to drop it
+    int Keep(BooleanOp op, int operand, unsigned char label)
+    {
+        switch (op) {
+        case BooleanOp::Union:
+            return label == MeshBoolean::Outside || (operand == 0 && label == MeshBoolean::SameOn) ? 1 : 0;
+        case BooleanOp::Intersection:
+            return label == MeshBoolean::Inside || (operand == 0 && label == MeshBoolean::SameOn) ? 1 : 0;
+        case BooleanOp::Difference:
+            if (operand == 0)
+                return label == MeshBoolean::Outside || label == MeshBoolean::OppositeOn ? 1 : 0;
+            return label == MeshBoolean::Inside ? -1 : 0;
+        case BooleanOp::SymmetricDifference:
+            break; // Select builds it from the two differences
+        }
+        return 0;
+    }
+    // Merges edge-connected coplanar triangles into polygons and re-triangulates
+    // each with the fewest triangles its outline allows. Every outline vertex
+    // stays, so edges shared with the rest of the mesh keep their splits and the
+    // mesh stays watertight. A region whose outline is not one outer loop with
+    // holes, or that does not triangulate cleanly, is kept as it was.
+    void MergeCoplanarFragments(std::vector<glm::vec3>& positions, std::vector<unsigned int>& indices,
+        std::vector<unsigned char>& operand, float tolerance)
+    {
+        constexpr unsigned int None = 0xFFFFFFFFu;
+        const unsigned int triangleCount = static_cast<unsigned int>(indices.size() / 3);
+        auto corner = [&](unsigned int t, int k) -> const glm::vec3& { return positions[indices[size_t(t) * 3 + k]]; };
+
+        // Step 1: unit normals, and the neighbour across each manifold edge
+        std::vector<glm::vec3> normals(triangleCount);
+        std::vector<float> areas(triangleCount);
+        for (unsigned int t = 0; t < triangleCount; ++t) {
+            const glm::vec3 n = glm::cross(corner(t, 1) - corner(t, 0), corner(t, 2) - corner(t, 0));
+            const float length = glm::length(n);
+            areas[t] = 0.5f * length;
+            normals[t] = length > 0.0f ? n / length : glm::vec3(0.0f);
+        }
+        struct HalfEdge {
+            uint64_t edge;
+            unsigned int id; // Index of its first vertex in indices
+            bool operator<(const HalfEdge& other) const { return edge != other.edge ? edge < other.edge : id < other.id; }
+        };
+        std::vector<HalfEdge> halfEdges;
+        halfEdges.reserve(indices.size());
+        for (unsigned int h = 0; h < indices.size(); ++h)
+            halfEdges.push_back({ EdgeKey(indices[h], indices[h - h % 3 + (h + 1) % 3]), h });
+        std::sort(halfEdges.begin(), halfEdges.end());
+        std::vector<unsigned int> neighbour(indices.size(), None);
+        for (size_t i = 0; i < halfEdges.size();) {
+            size_t j = i + 1;
+            while (j < halfEdges.size() && halfEdges[j].edge == halfEdges[i].edge)
+                ++j;
+            // Two half-edges with different first vertices run opposite ways
+            const unsigned int h0 = halfEdges[i].id;
+            const unsigned int h1 = halfEdges[i + 1 < j ? i + 1 : i].id;
+            if (j - i == 2 && indices[h0] != indices[h1]) {
+                neighbour[h0] = h1 / 3;
+                neighbour[h1] = h0 / 3;
+            }
+            i = j;
+        }
+
+        // Step 2: regions, flood-filled from a seed across neighbours facing its
+        // way whose corners all lie on its plane
+        std::vector<unsigned int> region(triangleCount, None);
+        std::vector<unsigned int> members, regionOffsets{ 0 };
+        members.reserve(triangleCount);
+        for (unsigned int seed = 0; seed < triangleCount; ++seed) {
+            if (region[seed] != None || areas[seed] == 0.0f)
+                continue;
+            const unsigned int id = static_cast<unsigned int>(regionOffsets.size() - 1);
+            const glm::vec3 normal = normals[seed];
+            const float offset = glm::dot(normal, corner(seed, 0));
+            region[seed] = id;
+            members.push_back(seed);
+            for (size_t k = regionOffsets.back(); k < members.size(); ++k) {
+                for (int e = 0; e < 3; ++e) {
+                    const unsigned int u = neighbour[size_t(members[k]) * 3 + e];
+                    if (u == None || region[u] != None || areas[u] == 0.0f || glm::dot(normals[u], normal) < 1.0f - PlaneTable::NormalTolerance)
+                        continue;
+                    bool onPlane = true;
+                    for (int c = 0; c < 3 && onPlane; ++c)
+                        onPlane = std::abs(glm::dot(normal, corner(u, c)) - offset) <= tolerance;
+                    if (!onPlane)
+                        continue;
+                    region[u] = id;
+                    members.push_back(u);
+                }
+            }
+            regionOffsets.push_back(static_cast<unsigned int>(members.size()));
+        }
+
+        // Step 3: per region, the outline as loops of boundary edges, then ear clipping
+        PolygonTriangulator triangulator;
+        std::vector<TriangleSplitter::Segment> outline;
+        std::vector<unsigned char> used;
+        std::vector<unsigned int> loopPoints, loopOffsets, orderedPoints, orderedOffsets, merged;
+        std::vector<unsigned char> dropped(triangleCount, 0);
+        for (size_t r = 0; r + 1 < regionOffsets.size(); ++r) {
+            const unsigned int first = regionOffsets[r];
+            const unsigned int count = regionOffsets[r + 1] - first;
+            if (count < 3)
+                continue;
+            outline.clear();
+            for (unsigned int k = first; k < first + count; ++k) {
+                const unsigned int t = members[k];
+                for (int e = 0; e < 3; ++e) {
+                    const unsigned int u = neighbour[size_t(t) * 3 + e];
+                    if (u == None || region[u] != r)
+                        outline.push_back({ indices[size_t(t) * 3 + e], indices[size_t(t) * 3 + (e + 1) % 3] });
+                }
+            }
+            std::sort(outline.begin(), outline.end());
+            bool simple = true;
+            for (size_t k = 1; k < outline.size() && simple; ++k)
+                simple = outline[k].first != outline[k - 1].first; // Else the outline touches itself
+            if (!simple)
+                continue;
+
+            used.assign(outline.size(), 0);
+            loopPoints.clear();
+            loopOffsets.assign(1, 0);
+            for (size_t start = 0; start < outline.size() && simple; ++start) {
+                if (used[start])
+                    continue;
+                size_t k = start;
+                do {
+                    used[k] = 1;
+                    loopPoints.push_back(outline[k].first);
+                    auto it = std::lower_bound(outline.begin(), outline.end(), TriangleSplitter::Segment{ outline[k].second, 0 });
+                    if (it == outline.end() || it->first != outline[k].second) {
+                        simple = false;
+                        break;
+                    }
+                    k = static_cast<size_t>(it - outline.begin());
+                } while (k != start && !used[k]);
+                simple = simple && k == start;
+                loopOffsets.push_back(static_cast<unsigned int>(loopPoints.size()));
+            }
+            if (!simple)
+                continue;
+
+            // The one loop wound counter-clockwise about the normal is the outer
+            // boundary; the triangulator takes it first
+            const glm::vec3 normal = normals[members[first]];
+            size_t outer = 0, outerCount = 0;
+            for (size_t l = 0; l + 1 < loopOffsets.size(); ++l) {
+                glm::vec3 area(0.0f);
+                for (unsigned int k = loopOffsets[l]; k < loopOffsets[l + 1]; ++k) {
+                    const unsigned int next = k + 1 < loopOffsets[l + 1] ? k + 1 : loopOffsets[l];
+                    area += glm::cross(positions[loopPoints[k]], positions[loopPoints[next]]);
+                }
+                if (glm::dot(area, normal) > 0.0f) {
+                    outer = l;
+                    outerCount++;
+                }
+            }
+            const size_t holeCount = loopOffsets.size() - 2;
+            const size_t triangles = PolygonTriangulator::TriangleCount(loopPoints.size(), holeCount);
+            if (outerCount != 1 || triangles >= count)
+                continue;
+            orderedPoints.clear();
+            orderedOffsets.assign(1, 0);
+            for (size_t l = 0; l + 1 < loopOffsets.size(); ++l) {
+                const size_t loop = l == 0 ? outer : (l <= outer ? l - 1 : l);
+                orderedPoints.insert(orderedPoints.end(), loopPoints.begin() + loopOffsets[loop], loopPoints.begin() + loopOffsets[loop + 1]);
+                orderedOffsets.push_back(static_cast<unsigned int>(orderedPoints.size()));
+            }
+
+            const size_t base = merged.size();
+            merged.resize(base + triangles * 3);
+            const size_t written = triangulator.Triangulate(positions, normal, orderedPoints, orderedOffsets, merged.data() + base);
+            double area = 0.0, regionArea = 0.0;
+            for (size_t t = 0; t < written; ++t) {
+                const unsigned int* v = merged.data() + base + t * 3;
+                area += 0.5 * glm::dot(glm::cross(positions[v[1]] - positions[v[0]], positions[v[2]] - positions[v[0]]), normal);
+            }
+            for (unsigned int k = first; k < first + count; ++k)
+                regionArea += areas[members[k]];
+            if (written != triangles || std::abs(area - regionArea) > 1e-4 * regionArea) {
+                merged.resize(base);
+                continue;
+            }
+            for (unsigned int k = first; k < first + count; ++k)
+                dropped[members[k]] = 1;
+        }
+        if (merged.empty())
+            return;
+
+        // Step 4: the untouched triangles and the merged ones, over the vertices still used
+        size_t kept = 0;
+        for (unsigned int t = 0; t < triangleCount; ++t) {
+            if (dropped[t])
+                continue;
+            for (int k = 0; k < 3; ++k)
+                indices[kept * 3 + k] = indices[size_t(t) * 3 + k];
+            ++kept;
+        }
+        indices.resize(kept * 3);
+        indices.insert(indices.end(), merged.begin(), merged.end());
+        std::vector<unsigned int> remap(positions.size(), VertexWelder::NotFound);
+        std::vector<glm::vec3> usedPositions;
+        std::vector<unsigned char> usedOperand;
+        usedPositions.reserve(positions.size());
+        usedOperand.reserve(positions.size());
+        for (unsigned int& index : indices) {
+            if (remap[index] == VertexWelder::NotFound) {
+                remap[index] = static_cast<unsigned int>(usedPositions.size());
+                usedPositions.push_back(positions[index]);
+                usedOperand.push_back(operand[index]);
+            }
+            index = remap[index];
+        }
+        positions = std::move(usedPositions);
+        operand = std::move(usedOperand);
+    }
+
+}
+
+void MeshBoolean::Build(const MeshData& meshA, const glm::mat4& modelA, const MeshData& meshB, const glm::mat4& modelB,
+    BooleanArithmetic arithmetic)
+{
+    const MeshData* meshes[2] = { &meshA, &meshB };
+    const glm::mat4 models[2] = { modelA, modelB };
+    const bool exact = arithmetic == BooleanArithmetic::Exact;
+
+    // Step 1: welded world-space copies. Their vertices go into one point set, so
+    // vertices and edges the operands have in common are shared.
+    std::vector<glm::vec3> operandPositions[2];
+    std::vector<unsigned int> operandIndices[2];
+    float extent = 0.0f;
+    for (int op = 0; op < 2; ++op) {
+        Shapes::ExtractUniquePositionsAndIndicesWorld(*meshes[op], operandPositions[op], operandIndices[op], models[op]);
+        for (const glm::vec3& p : operandPositions[op])
+            extent = std::max(extent, std::max(std::abs(p.x), std::max(std::abs(p.y), std::abs(p.z))));
+    }
+    tolerance = std::max(RelativeTolerance * extent, VertexWelder::DefaultTolerance);
+    // Exact input is taken as it is: only identical vertices are shared
+    VertexWelder points(exact ? 0.0f : tolerance, operandPositions[0].size() + operandPositions[1].size());
+    std::vector<unsigned int> corners[2];
+    for (int op = 0; op < 2; ++op) {
+        std::vector<unsigned int> vertexPoint(operandPositions[op].size());
+        for (size_t v = 0; v < vertexPoint.size(); ++v)
+            vertexPoint[v] = points.Insert(operandPositions[op][v]);
+        corners[op].resize(operandIndices[op].size());
+        for (size_t k = 0; k < corners[op].size(); ++k)
+            corners[op][k] = vertexPoint[operandIndices[op][k]];
+    }
+
+    // Step 2: intersection segments of the overlapping triangle pairs
+    const BVH& bvhA = BVH::ForMesh(meshA);
+    const BVH& bvhB = BVH::ForMesh(meshB);
+    std::vector<TrianglePair> pairs;
+    if (!bvhA.Empty() && !bvhB.Empty())
+        pairs = BVH::FindOverlappingPairs(bvhA, bvhB, glm::inverse(modelA) * modelB, bvhA.QueryMargin() + bvhB.QueryMargin());
+    // Exact: the welded vertices are the input points, and intersection points
+    // are added as the edges and planes they lie on
+    std::vector<TriangleSegment> segments;
+    std::vector<ImplicitTriangleSegment> exactSegments;
+    ImplicitPoints implicit;
+    if (exact) {
+        implicit.Reset(points.Points());
+        TriangleIntersection::IntersectPairsExact(implicit, corners[0], corners[1], pairs.data(), pairs.size(), exactSegments);
+    }
+    else {
+        TriangleIntersection::IntersectPairs(operandPositions[0], operandIndices[0], operandPositions[1], operandIndices[1],
+            pairs.data(), pairs.size(), segments);
+    }
+
+    // Step 3: the points and constraint segments each triangle must take: its
+    // segments of the intersection curves, or for a coplanar pair the other
+    // triangle's edges clipped to it
+    IntersectionGraph curves;
+    if (!exact)
+        curves.Build(segments, points, corners[0].size() / 3, corners[1].size() / 3);
+    std::vector<PointRecord> pointRecords[2];
+    std::vector<SegmentRecord> coplanarSegments[2];
+    std::vector<PointRecord> coplanarPartners[2];
+    auto triangleCorners = [&](int op, unsigned int triangle, glm::vec3 out[3]) {
+        for (int k = 0; k < 3; ++k)
+            out[k] = operandPositions[op][operandIndices[op][size_t(triangle) * 3 + k]];
+    };
+    auto clipCoplanar = [&](unsigned int triangleA, unsigned int triangleB) {
+        const unsigned int triangles[2] = { triangleA, triangleB };
+        for (int op = 0; op < 2; ++op) {
+            coplanarPartners[op].push_back({ triangles[op], triangles[1 - op] });
+            glm::vec3 self[3], other[3];
+            triangleCorners(op, triangles[op], self);
+            triangleCorners(1 - op, triangles[1 - op], other);
+            const unsigned int* selfPoints = corners[op].data() + size_t(triangles[op]) * 3;
+            const unsigned int* otherPoints = corners[1 - op].data() + size_t(triangles[1 - op]) * 3;
+            for (int e = 0; e < 3; ++e) {
+                unsigned int a, b;
+                if (exact) {
+                    if (!ClipToTriangleExact(implicit, selfPoints, otherPoints[e], otherPoints[(e + 1) % 3], a, b))
+                        continue;
+                }
+                else {
+                    glm::vec3 start, end;
+                    if (!ClipToTriangle(self, other[e], other[(e + 1) % 3], tolerance, start, end))
+                        continue;
+                    a = points.Insert(start);
+                    b = points.Insert(end);
+                }
+                pointRecords[op].push_back({ triangles[op], a });
+                pointRecords[op].push_back({ triangles[op], b });
+                if (a != b)
+                    coplanarSegments[op].push_back({ triangles[op], a, b });
+            }
+        }
+    };
+    for (const TriangleSegment& segment : segments) {
+        if (segment.coplanar)
+            clipCoplanar(segment.triangleA, segment.triangleB);
+    }
+    for (const ImplicitTriangleSegment& segment : exactSegments) {
+        if (segment.coplanar)
+            clipCoplanar(segment.triangleA, segment.triangleB);
+    }
+
+    // Exact: every point is known now, so equal ones can share an id, the
+    // smallest; constructions landing on an input vertex become that vertex
+    std::vector<unsigned int> representative;
+    std::vector<glm::vec3> rounded;
+    if (exact) {
+        implicit.Deduplicate(representative, rounded);
+        for (int op = 0; op < 2; ++op) {
+            for (PointRecord& record : pointRecords[op])
+                record.point = representative[record.point];
+            size_t kept = 0;
+            for (const SegmentRecord& segment : coplanarSegments[op]) {
+                const unsigned int a = representative[segment.a], b = representative[segment.b];
+                if (a != b)
+                    coplanarSegments[op][kept++] = { segment.triangle, a, b };
+            }
+            coplanarSegments[op].resize(kept);
+        }
+        curves.Build(exactSegments, representative, corners[0].size() / 3, corners[1].size() / 3);
+    }
+    for (const IntersectionGraph::Segment& segment : curves.segments) {
+        const unsigned int triangles[2] = { segment.triangleA, segment.triangleB };
+        for (int op = 0; op < 2; ++op) {
+            pointRecords[op].push_back({ triangles[op], segment.start });
+            pointRecords[op].push_back({ triangles[op], segment.end });
+        }
+    }
+
+    // Step 4: points on a triangle edge are filed under the edge, so that both
+    // triangles sharing it split it alike
+    std::vector<EdgePoint> edgePoints;
+    for (int op = 0; op < 2; ++op) {
+        std::vector<PointRecord>& records = pointRecords[op];
+        size_t kept = 0;
+        for (const PointRecord& record : records) {
+            const unsigned int* c = corners[op].data() + size_t(record.triangle) * 3;
+            if (record.point == c[0] || record.point == c[1] || record.point == c[2])
+                continue;
+            unsigned char edge;
+            if (exact) {
+                edge = TriangleSplitter::EdgeOf(implicit, c, record.point);
+            }
+            else {
+                glm::vec3 v[3];
+                triangleCorners(op, record.triangle, v);
+                edge = TriangleSplitter::EdgeOf(v, points.Points()[record.point], tolerance);
+            }
+            if (edge < TriangleSplitter::Interior)
+                edgePoints.push_back({ EdgeKey(c[edge], c[(edge + 1) % 3]), record.point });
+            else
+                records[kept++] = record;
+        }
+        records.resize(kept);
+        std::sort(records.begin(), records.end());
+        records.erase(std::unique(records.begin(), records.end()), records.end());
+        std::sort(coplanarSegments[op].begin(), coplanarSegments[op].end(),
+            [](const SegmentRecord& l, const SegmentRecord& r) { return l.triangle < r.triangle; });
+        std::sort(coplanarPartners[op].begin(), coplanarPartners[op].end());
+    }
+    std::sort(edgePoints.begin(), edgePoints.end());
+    edgePoints.erase(std::unique(edgePoints.begin(), edgePoints.end()), edgePoints.end());
+
+    // Step 5: split every triangle that takes points; the recovered segments are
+    // the cut edges that patches do not cross
+    if (exact)
+        positions = std::move(rounded);
+    else
+        positions = points.Points();
+    failedSegments = 0;
+    TriangleSplitter splitter;
+    std::vector<glm::vec3> localPositions;
+    std::vector<unsigned int> localPoints, localTriangles, localVertex;
+    std::vector<unsigned char> localEdges;
+    std::vector<TriangleSplitter::Segment> localSegments, recovered;
+    std::vector<unsigned int> parents[2];
+    std::vector<MeshPatches::Edge> cutEdges[2];
+    for (int op = 0; op < 2; ++op) {
+        indices[op].clear();
+        size_t nextPoint = 0;
+        size_t nextSegment = 0;
+        const std::vector<PointRecord>& records = pointRecords[op];
+        const std::vector<SegmentRecord>& segmentList = coplanarSegments[op];
+        const unsigned int triangleCount = static_cast<unsigned int>(corners[op].size() / 3);
+        for (unsigned int t = 0; t < triangleCount; ++t) {
+            const unsigned int* c = corners[op].data() + size_t(t) * 3;
+            const size_t firstPoint = nextPoint;
+            const size_t firstSegment = nextSegment;
+            while (nextPoint < records.size() && records[nextPoint].triangle == t)
+                ++nextPoint;
+            while (nextSegment < segmentList.size() && segmentList[nextSegment].triangle == t)
+                ++nextSegment;
+            if (c[0] == c[1] || c[1] == c[2] || c[2] == c[0])
+                continue; // Collapsed by the weld; its neighbours close the gap
+
+            localPoints.clear();
+            localEdges.clear();
+            for (unsigned char e = 0; e < 3; ++e) {
+                const uint64_t key = EdgeKey(c[e], c[(e + 1) % 3]);
+                auto range = std::equal_range(edgePoints.begin(), edgePoints.end(), EdgePoint{ key, 0 },
+                    [](const EdgePoint& l, const EdgePoint& r) { return l.edge < r.edge; });
+                for (auto it = range.first; it != range.second; ++it) {
+                    localPoints.push_back(it->point);
+                    localEdges.push_back(e);
+                }
+            }
+            const size_t edgePointCount = localPoints.size();
+            for (size_t i = firstPoint; i < nextPoint; ++i) {
+                if (std::find(localPoints.begin(), localPoints.begin() + edgePointCount, records[i].point) == localPoints.begin() + edgePointCount) {
+                    localPoints.push_back(records[i].point);
+                    localEdges.push_back(TriangleSplitter::Interior);
+                }
+            }
+            const auto curveSegments = curves.TriangleSegments(op, t);
+            if (localPoints.empty() && firstSegment == nextSegment && curveSegments.first == curveSegments.second) {
+                indices[op].insert(indices[op].end(), c, c + 3);
+                parents[op].push_back(t);
+                continue;
+            }
+
+            auto local = [&](unsigned int point) {
+                for (unsigned int k = 0; k < 3; ++k) {
+                    if (c[k] == point)
+                        return k;
+                }
+                return 3 + static_cast<unsigned int>(std::find(localPoints.begin(), localPoints.end(), point) - localPoints.begin());
+            };
+            localSegments.clear();
+            for (const unsigned int* s = curveSegments.first; s != curveSegments.second; ++s)
+                localSegments.push_back({ local(curves.segments[*s].start), local(curves.segments[*s].end) });
+            for (size_t s = firstSegment; s < nextSegment; ++s)
+                localSegments.push_back({ local(segmentList[s].a), local(segmentList[s].b) });
+            if (exact) {
+                splitter.Split(implicit, positions, c, localPoints, localEdges, localSegments, localTriangles, localVertex, recovered);
+            }
+            else {
+                localPositions.clear();
+                for (unsigned int point : localPoints)
+                    localPositions.push_back(positions[point]);
+                const glm::vec3 cornerPositions[3] = { positions[c[0]], positions[c[1]], positions[c[2]] };
+
+                // Distinct points are at least tolerance apart in 3D, and the projection
+                // shrinks that by at most sqrt(3), so half of it merges none of them
+                splitter.Split(cornerPositions, localPositions, localEdges, localSegments, 0.5f * tolerance,
+                    localTriangles, localVertex, recovered);
+            }
+            failedSegments += splitter.FailedSegments();
+            auto global = [&](unsigned int vertex) { return vertex < 3 ? c[vertex] : localPoints[vertex - 3]; };
+            for (size_t k = 0; k < localTriangles.size(); k += 3) {
+                for (int j = 0; j < 3; ++j)
+                    indices[op].push_back(global(localTriangles[k + j]));
+                parents[op].push_back(t);
+            }
+            for (const TriangleSplitter::Segment& edge : recovered)
+                cutEdges[op].push_back({ global(edge.first), global(edge.second) });
+        }
+    }
+
+    // Step 6: label each patch of split triangles once. A fragment whose centroid
+    // lies on a coplanar partner is on the other surface; the rest are inside or
+    // outside, in one batched containment query per operand. Exact labelling
+    // casts rays through the other operand's world-space triangles instead.
+    const glm::mat4 identity(1.0f);
+    std::vector<unsigned int> candidates;
+    for (int op = 0; op < 2; ++op) {
+        const int other = 1 - op;
+        const std::vector<unsigned int>& triangles = indices[op];
+        // Cached on the mesh, so an operand that did not move keeps its tree
+        const BVH* world = exact ? &BVH::ForMeshWorld(*meshes[other], models[other]) : nullptr;
+        auto onSurface = [&](unsigned int fragment, const glm::vec3& centroid) -> int {
+            const glm::vec3& v0 = positions[triangles[size_t(fragment) * 3]];
+            const glm::vec3 normal = glm::cross(positions[triangles[size_t(fragment) * 3 + 1]] - v0, positions[triangles[size_t(fragment) * 3 + 2]] - v0);
+            auto range = std::equal_range(coplanarPartners[op].begin(), coplanarPartners[op].end(), PointRecord{ parents[op][fragment], 0 },
+                [](const PointRecord& l, const PointRecord& r) { return l.triangle < r.triangle; });
+            for (auto it = range.first; it != range.second; ++it) {
+                glm::vec3 w[3];
+                triangleCorners(other, it->point, w);
+                const glm::vec3 partnerNormal = glm::normalize(glm::cross(w[1] - w[0], w[2] - w[0]));
+                if (std::abs(glm::dot(partnerNormal, centroid - w[0])) > tolerance)
+                    continue;
+                bool inside = true;
+                for (int e = 0; e < 3 && inside; ++e)
+                    inside = glm::dot(glm::normalize(glm::cross(partnerNormal, w[(e + 1) % 3] - w[e])), centroid - w[e]) >= -tolerance;
+                if (inside)
+                    return glm::dot(normal, partnerNormal) > 0.0f ? SameOn : OppositeOn;
+            }
+            return -1;
+        };
+
+        MeshPatches patches;
+        patches.Build(positions, triangles, cutEdges[op]);
+        patches.LabelTriangles([&](const std::vector<unsigned int>& queries, std::vector<unsigned char>& outLabels) {
+            outLabels.assign(queries.size(), Outside);
+            std::vector<glm::vec3> centroids;
+            std::vector<unsigned int> queried;
+            for (size_t i = 0; i < queries.size(); ++i) {
+                const unsigned int* t = triangles.data() + size_t(queries[i]) * 3;
+                const glm::vec3 centroid = (positions[t[0]] + positions[t[1]] + positions[t[2]]) / 3.0f;
+                const int label = onSurface(queries[i], centroid);
+                if (label >= 0) {
+                    outLabels[i] = static_cast<unsigned char>(label);
+                    continue;
+                }
+                centroids.push_back(centroid);
+                queried.push_back(static_cast<unsigned int>(i));
+            }
+            if (centroids.empty())
+                return;
+            std::vector<unsigned char> inside;
+            if (exact) {
+                // An input vertex of the fragment is exact, so one off the other
+                // surface decides; else the centroid, from unrounded corners. The
+                // winding number takes the few whose rays all grazed.
+                inside.resize(centroids.size());
+                std::vector<glm::vec3> undecided;
+                std::vector<size_t> undecidedAt;
+                for (size_t k = 0; k < centroids.size(); ++k) {
+                    const unsigned int* t = triangles.data() + size_t(queries[queried[k]]) * 3;
+                    int side = -1;
+                    for (int c = 0; c < 3 && side < 0; ++c) {
+                        if (t[c] < points.Size())
+                            side = SideExact(*world, operandPositions[other], operandIndices[other], positions[t[c]], 4.0 * extent, tolerance, candidates);
+                    }
+                    if (side < 0) {
+                        const glm::dvec3 centroid = (implicit.Approximate(t[0]) + implicit.Approximate(t[1]) + implicit.Approximate(t[2])) / 3.0;
+                        side = SideExact(*world, operandPositions[other], operandIndices[other], centroid, 4.0 * extent, tolerance, candidates);
+                    }
+                    if (side == Undecided) {
+                        undecided.push_back(centroids[k]);
+                        undecidedAt.push_back(k);
+                    }
+                    inside[k] = side > 0 ? 1 : 0;
+                }
+                if (!undecided.empty()) {
+                    std::vector<unsigned char> undecidedInside;
+                    Shapes::ClassifyPoints(undecided, identity, *meshes[other], models[other], undecidedInside);
+                    for (size_t u = 0; u < undecidedAt.size(); ++u)
+                        inside[undecidedAt[u]] = undecidedInside[u];
+                }
+            }
+            else {
+                Shapes::ClassifyPoints(centroids, identity, *meshes[other], models[other], inside);
+            }
+            for (size_t k = 0; k < queried.size(); ++k)
+                outLabels[queried[k]] = inside[k] ? Inside : Outside;
+            }, labels[op]);
+    }
+}
+
+void MeshBoolean::Select(BooleanOp op, std::vector<glm::vec3>& outPositions, std::vector<unsigned int>& outIndices,
+    std::vector<unsigned char>& outOperand) const
+{
+    outPositions.clear();
+    outIndices.clear();
+    outOperand.clear();
+    // SymmetricDifference is the shells A - B and B - A. Each is welded on its
+    // own: sharing vertices along the intersection curves would put four
+    // triangles on every edge there.
+    const int shells = op == BooleanOp::SymmetricDifference ? 2 : 1;
+    std::vector<unsigned int> remap;
+    for (int shell = 0; shell < shells; ++shell) {
+        remap.assign(positions.size(), VertexWelder::NotFound);
+        for (int operand = 0; operand < 2; ++operand) {
+            const std::vector<unsigned int>& triangles = indices[operand];
+            for (size_t t = 0; t < labels[operand].size(); ++t) {
+                // B - A is A - B with the operands' roles swapped
+                const int keep = shells == 2 ? Keep(BooleanOp::Difference, operand ^ shell, labels[operand][t])
+                    : Keep(op, operand, labels[operand][t]);
+                if (keep == 0)
+                    continue;
+                const unsigned int corners[3] = { triangles[t * 3], keep > 0 ? triangles[t * 3 + 1] : triangles[t * 3 + 2],
+                    keep > 0 ? triangles[t * 3 + 2] : triangles[t * 3 + 1] };
+                for (unsigned int point : corners) {
+                    if (remap[point] == VertexWelder::NotFound) {
+                        remap[point] = static_cast<unsigned int>(outPositions.size());
+                        outPositions.push_back(positions[point]);
+                        outOperand.push_back(static_cast<unsigned char>(operand));
+                    }
+                    outIndices.push_back(remap[point]);
+                }
+            }
+        }
+    }
+    MergeCoplanarFragments(outPositions, outIndices, outOperand, tolerance);
+}
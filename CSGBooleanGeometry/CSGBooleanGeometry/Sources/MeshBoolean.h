@@ -0,0 +1,58 @@
+#pragma once
+#include "glm.hpp"
+#include <vector>
+
+struct MeshData;
+
+enum class BooleanOp {
+    Union,
+    Intersection,
+    Difference,         // A minus B
+    SymmetricDifference
+};
+
+// How a boolean finds its intersection points. Float welds points within a
+// tolerance of the scene's size. Exact keeps them as the input edge and plane
+// they come from, decides every orientation exactly and rounds only the final
+// positions, so nearly-coincident and chained operands split consistently.
+enum class BooleanArithmetic {
+    Float,
+    Exact
+};
+
+// Both operands of a boolean split along their intersection curves and labelled
+// against each other. Every operator's result is a selection of the labelled
+// fragments, so one Build serves all four. The operands must be closed meshes.
+// Both split meshes index one shared, welded world-space point set, and the
+// split is conforming: a triangle edge carrying intersection points is split
+// the same way on both of its sides, so selections stay watertight.
+class MeshBoolean
+{
+public:
+    // Where a fragment of one operand lies relative to the other
+    enum Label : unsigned char {
+        Outside,
+        Inside,
+        SameOn,    // On the other surface, facing the same way
+        OppositeOn // On the other surface, facing the other way
+    };
+
+    void Build(const MeshData& meshA, const glm::mat4& modelA, const MeshData& meshB, const glm::mat4& modelB,
+        BooleanArithmetic arithmetic = BooleanArithmetic::Float);
+
+    // Result of op as a welded triangle list over compacted vertices; outOperand[v]
+    // is 0 when vertex v comes from A's fragments and 1 when only from B's.
+    // Coplanar fragments are merged back into polygons and ear-clipped, so flat
+    // faces take no more triangles than their outlines need. Every edge is shared
+    // by exactly two triangles. SymmetricDifference is the two shells A - B and
+    // B - A, welded separately; they touch along the intersection curves but
+    // share no vertices there.
+    void Select(BooleanOp op, std::vector<glm::vec3>& outPositions, std::vector<unsigned int>& outIndices,
+        std::vector<unsigned char>& outOperand) const;
+
+    std::vector<glm::vec3> positions;     // World space, shared by both operands
+    std::vector<unsigned int> indices[2]; // Split triangles of A and B
+    std::vector<unsigned char> labels[2]; // Label of each split triangle
+    float tolerance = 0.0f;               // Weld distance, relative to the scene's size
+    size_t failedSegments = 0;            // Curve segments the splitter could not insert
+};
@@ -0,0 +1,9 @@
+#include "MeshData.h"
+#include <atomic>
+
+unsigned long long MeshData::NextRevision()
+{
+    // Process-wide so a stamp never repeats, even across different meshes
+    static std::atomic<unsigned long long> counter{ 0 };
+    return ++counter;
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include "glm.hpp"
+#include "BVH.h"
+#include "Bounds.h"
+#include "ConvexShape.h"
+#include "PlaneTable.h"
+#include "WindingNumber.h"
+#include <cstring>
+#include <vector>
+
+// Derived data for a few model matrices at once, keyed on (mesh revision,
+// matrix). Slots have fixed addresses: a returned entry stays valid until the
+// mesh is modified or Capacity other matrices have been requested since, so
+// callers can hold the results for two placements of one mesh side by side.
+// Not thread-safe: lookups write the slots.
+template <typename T>
+struct PerMatrixCache {
+    static constexpr int Capacity = 4;
+    struct Entry {
+        unsigned long long revision = 0; // 0 is never issued, so a new slot is always stale
+        glm::mat4 model = glm::mat4(0.0f);
+        unsigned long long lastUse = 0;
+        T value;
+    };
+
+    // Entry for (revision, model). On a miss the least recently used slot is
+    // taken over, preferring one built from an older revision, and hit is
+    // false: the caller rebuilds value.
+    Entry& Find(unsigned long long revision, const glm::mat4& model, bool& hit)
+    {
+        Entry* victim = &entries[0];
+        for (Entry& entry : entries) {
+            if (entry.revision == revision && std::memcmp(&entry.model, &model, sizeof(glm::mat4)) == 0) {
+                entry.lastUse = ++clock;
+                hit = true;
+                return entry;
+            }
+            const bool entryStale = entry.revision != revision, victimStale = victim->revision != revision;
+            if (entryStale != victimStale ? entryStale : entry.lastUse < victim->lastUse)
+                victim = &entry;
+        }
+        victim->revision = revision;
+        victim->model = model;
+        victim->lastUse = ++clock;
+        hit = false;
+        return *victim;
+    }
+
+    Entry entries[Capacity];
+    unsigned long long clock = 0;
+};
+
+// World-space copies of a mesh's positions (see TransformCache)
+using WorldPositionCache = PerMatrixCache<std::vector<glm::vec3>>;
+// World-space BVHs of a mesh (see BVH::ForMeshWorld)
+using WorldBVHCache = PerMatrixCache<BVH>;
+
+// CPU-side triangle mesh consumed and produced by the geometry code.
+// Positions are a contiguous stream so geometry kernels read only what they
+// use; normals and colors are separate attribute streams of the same length.
+// The interleaved GPU layout is built by the viewer at upload time.
+// revision: stamp that changes whenever the data changes; caches built from a
+// mesh (GPU buffers, acceleration structures) compare it to detect edits.
+struct MeshData {
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> normals;
+    std::vector<glm::vec3> colors;
+    std::vector<unsigned int> indices;
+    unsigned long long revision = NextRevision();
+
+    // Derived data, rebuilt on demand from the fields above
+    mutable WorldPositionCache worldPositions;
+    mutable BVH bvh; // Local space, see BVH::ForMesh
+    mutable WorldBVHCache worldBvh;
+    mutable ConvexShape convex; // Local space, see ConvexShape::ForMesh
+    mutable MeshBounds bounds;  // Local space, see MeshBounds::ForMesh
+    mutable PlaneTable planes;  // Local space, see PlaneTable::ForMesh
+    mutable WindingNumber winding; // Local space, see WindingNumber::ForMesh
+
+    size_t VertexCount() const { return positions.size(); }
+
+    // Call after editing positions/attributes/indices in place
+    void MarkModified() { revision = NextRevision(); }
+
+    static unsigned long long NextRevision();
+};
@@ -0,0 +1,164 @@
+#include "MeshPatches.h"
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+    uint64_t EdgeKey(unsigned int a, unsigned int b)
+    {
+        if (a > b)
+            std::swap(a, b);
+        return (uint64_t(a) << 32) | b;
+    }
+
+    glm::vec3 Centroid(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices, size_t triangle)
+    {
+        return (positions[indices[triangle * 3]] + positions[indices[triangle * 3 + 1]] + positions[indices[triangle * 3 + 2]]) / 3.0f;
+    }
+}
+
+void MeshPatches::Build(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices,
+    const std::vector<Edge>& cutEdges, const std::vector<unsigned char>& barrier)
+{
+    const size_t triangleCount = indices.size() / 3;
+    auto isBarrier = [&](size_t triangle) { return !barrier.empty() && barrier[triangle]; };
+
+    // Step 1: triangles around each vertex in CSR form, by counting sort. Two
+    // triangles are neighbours when one has an edge (a, b) and the other, found
+    // around a, also uses b.
+    std::vector<unsigned int> incidentOffsets(positions.size() + 1, 0);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        if (isBarrier(t))
+            continue;
+        for (int k = 0; k < 3; ++k)
+            incidentOffsets[indices[t * 3 + k] + 1]++;
+    }
+    for (size_t v = 0; v < positions.size(); ++v)
+        incidentOffsets[v + 1] += incidentOffsets[v];
+    std::vector<unsigned int> incident(incidentOffsets.back());
+    std::vector<unsigned int> fill(incidentOffsets.begin(), incidentOffsets.end() - 1);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        if (isBarrier(t))
+            continue;
+        for (int k = 0; k < 3; ++k)
+            incident[fill[indices[t * 3 + k]]++] = static_cast<unsigned int>(t);
+    }
+
+    std::vector<uint64_t> cuts;
+    cuts.reserve(cutEdges.size());
+    for (const Edge& edge : cutEdges)
+        cuts.push_back(EdgeKey(edge.first, edge.second));
+    std::sort(cuts.begin(), cuts.end());
+
+    // Step 2: flood fill across shared edges that are not cut; a non-manifold
+    // edge joins all of its triangles. Each patch is seeded by its largest
+    // triangle, whose centroid is the least likely to sit on the other surface.
+    trianglePatch.assign(triangleCount, NoPatch);
+    seeds.clear();
+    std::vector<unsigned int> stack;
+    for (size_t start = 0; start < triangleCount; ++start) {
+        if (trianglePatch[start] != NoPatch || isBarrier(start))
+            continue;
+        const unsigned int patch = static_cast<unsigned int>(seeds.size());
+        unsigned int seed = static_cast<unsigned int>(start);
+        float seedArea = -1.0f;
+        trianglePatch[start] = patch;
+        stack.push_back(static_cast<unsigned int>(start));
+        while (!stack.empty()) {
+            const unsigned int t = stack.back();
+            stack.pop_back();
+            const unsigned int* corners = indices.data() + size_t(t) * 3;
+            const glm::vec3& v0 = positions[corners[0]];
+            const float area = glm::length(glm::cross(positions[corners[1]] - v0, positions[corners[2]] - v0));
+            if (area > seedArea) {
+                seedArea = area;
+                seed = t;
+            }
+            for (int e = 0; e < 3; ++e) {
+                const unsigned int a = corners[e];
+                const unsigned int b = corners[(e + 1) % 3];
+                if (a == b || (!cuts.empty() && std::binary_search(cuts.begin(), cuts.end(), EdgeKey(a, b))))
+                    continue;
+                for (unsigned int n = incidentOffsets[a]; n < incidentOffsets[a + 1]; ++n) {
+                    const unsigned int neighbor = incident[n];
+                    if (trianglePatch[neighbor] != NoPatch)
+                        continue;
+                    const unsigned int* other = indices.data() + size_t(neighbor) * 3;
+                    if (other[0] == b || other[1] == b || other[2] == b) {
+                        trianglePatch[neighbor] = patch;
+                        stack.push_back(neighbor);
+                    }
+                }
+            }
+        }
+        seeds.push_back(seed);
+    }
+}
+
+void MeshPatches::LabelTriangles(const TriangleLabeler& label, std::vector<unsigned char>& outLabels) const
+{
+    const size_t triangleCount = trianglePatch.size();
+    std::vector<unsigned int> queries(seeds);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        if (trianglePatch[t] == NoPatch)
+            queries.push_back(static_cast<unsigned int>(t));
+    }
+
+    std::vector<unsigned char> labels;
+    if (!queries.empty())
+        label(queries, labels);
+
+    outLabels.resize(triangleCount);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        if (trianglePatch[t] != NoPatch)
+            outLabels[t] = labels[trianglePatch[t]];
+    }
+    for (size_t i = seeds.size(); i < queries.size(); ++i)
+        outLabels[queries[i]] = labels[i];
+}
+
+void MeshPatches::ClassifyTriangles(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices,
+    const PointClassifier& classify, std::vector<unsigned char>& outInside) const
+{
+    LabelTriangles([&](const std::vector<unsigned int>& triangles, std::vector<unsigned char>& outLabels) {
+        std::vector<glm::vec3> centroids;
+        centroids.reserve(triangles.size());
+        for (unsigned int t : triangles)
+            centroids.push_back(Centroid(positions, indices, t));
+        classify(centroids, outLabels);
+        }, outInside);
+}
+
+void MeshPatches::ClassifyVertices(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices,
+    const PointClassifier& classify, std::vector<unsigned char>& outInside) const
+{
+    std::vector<unsigned int> vertexPatch(positions.size(), NoPatch);
+    for (size_t t = 0; t < trianglePatch.size(); ++t) {
+        if (trianglePatch[t] == NoPatch)
+            continue;
+        for (int k = 0; k < 3; ++k)
+            vertexPatch[indices[t * 3 + k]] = trianglePatch[t];
+    }
+
+    std::vector<glm::vec3> queries;
+    std::vector<unsigned int> queriedVertices;
+    for (unsigned int seed : seeds)
+        queries.push_back(Centroid(positions, indices, seed));
+    for (size_t v = 0; v < positions.size(); ++v) {
+        if (vertexPatch[v] == NoPatch) {
+            queriedVertices.push_back(static_cast<unsigned int>(v));
+            queries.push_back(positions[v]);
+        }
+    }
+
+    std::vector<unsigned char> inside;
+    if (!queries.empty())
+        classify(queries, inside);
+
+    outInside.resize(positions.size());
+    for (size_t v = 0; v < positions.size(); ++v) {
+        if (vertexPatch[v] != NoPatch)
+            outInside[v] = inside[vertexPatch[v]];
+    }
+    for (size_t i = 0; i < queriedVertices.size(); ++i)
+        outInside[queriedVertices[i]] = inside[seeds.size() + i];
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "glm.hpp"
+#include <functional>
+#include <utility>
+#include <vector>
+
+// Edge-connected patches of a triangle mesh that the other operand's surface
+// does not pass through. Patches are flood-filled across shared edges, but
+// never across cut edges (the intersection curves, once the mesh is split
+// along them) or into barrier triangles (triangles the other surface may still
+// cross; each is classified on its own). Every point of a patch lies on the
+// same side of the other operand, so one containment query labels the patch.
+class MeshPatches
+{
+public:
+    static constexpr unsigned int NoPatch = 0xFFFFFFFFu;
+    using Edge = std::pair<unsigned int, unsigned int>; // Undirected, by vertex id
+    // Classifies a batch of points: outInside[i] is 1 when points[i] is inside the other operand
+    using PointClassifier = std::function<void(const std::vector<glm::vec3>& points, std::vector<unsigned char>& outInside)>;
+    // Labels a batch of triangles by id: outLabels[i] belongs to triangles[i]
+    using TriangleLabeler = std::function<void(const std::vector<unsigned int>& triangles, std::vector<unsigned char>& outLabels)>;
+
+    // indices: triangle list over welded vertices, so neighbours share vertex ids.
+    // barrier: optional per-triangle flags; flagged triangles join no patch.
+    void Build(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices,
+        const std::vector<Edge>& cutEdges, const std::vector<unsigned char>& barrier = {});
+
+    // Per-triangle labels with a single labeler call: each patch takes the label
+    // of its seed, every barrier triangle is labelled on its own
+    void LabelTriangles(const TriangleLabeler& label, std::vector<unsigned char>& outLabels) const;
+    // Per-triangle containment with a single classifier call: one query per patch
+    // at its seed's centroid, plus one per barrier triangle at its centroid
+    void ClassifyTriangles(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices,
+        const PointClassifier& classify, std::vector<unsigned char>& outInside) const;
+    // Per-vertex containment: a vertex takes the label of a patch using it; only
+    // vertices used by barrier triangles alone (or by none) are queried themselves
+    void ClassifyVertices(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices,
+        const PointClassifier& classify, std::vector<unsigned char>& outInside) const;
+
+    size_t PatchCount() const { return seeds.size(); }
+
+    std::vector<unsigned int> trianglePatch; // Patch of each triangle, NoPatch for barrier triangles
+    std::vector<unsigned int> seeds;         // Query triangle of each patch: its largest, away from the cuts
+};
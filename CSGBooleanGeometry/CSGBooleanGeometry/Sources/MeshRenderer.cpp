@@ -0,0 +1,104 @@
+#include "MeshRenderer.h"
+
+MeshRenderer::~MeshRenderer()
+{
+    ReleaseAll();
+}
+
+void MeshRenderer::Draw(const MeshData& mesh)
+{
+    GpuMesh& gpuMesh = Upload(mesh);
+    gpuMesh.drawn = true;
+
+    glBindVertexArray(gpuMesh.VAO);
+    glDrawElements(GL_TRIANGLES, gpuMesh.indexCount, GL_UNSIGNED_INT, 0);
+    glBindVertexArray(0);
+}
+
+void MeshRenderer::EndFrame()
+{
+    for (auto it = gpuMeshes.begin(); it != gpuMeshes.end();) {
+        if (it->second.drawn) {
+            it->second.drawn = false;
+            ++it;
+            continue;
+        }
+        Delete(it->second);
+        it = gpuMeshes.erase(it);
+    }
+}
+
+void MeshRenderer::Release(const MeshData& mesh)
+{
+    auto it = gpuMeshes.find(mesh.revision);
+    if (it == gpuMeshes.end())
+        return;
+
+    Delete(it->second);
+    gpuMeshes.erase(it);
+}
+
+void MeshRenderer::ReleaseAll()
+{
+    for (auto& entry : gpuMeshes)
+        Delete(entry.second);
+    gpuMeshes.clear();
+}
+
+void MeshRenderer::Delete(GpuMesh& gpuMesh)
+{
+    glDeleteVertexArrays(1, &gpuMesh.VAO);
+    glDeleteBuffers(1, &gpuMesh.VBO);
+    glDeleteBuffers(1, &gpuMesh.EBO);
+}
+
+MeshRenderer::GpuMesh& MeshRenderer::Upload(const MeshData& mesh)
+{
+    GpuMesh& gpuMesh = gpuMeshes[mesh.revision];
+    if (gpuMesh.VAO != 0)
+        return gpuMesh; // Already resident; a revision's data never changes
+
+    // OpenGL buffer setup
+    glGenVertexArrays(1, &gpuMesh.VAO);
+    glGenBuffers(1, &gpuMesh.VBO);
+    glGenBuffers(1, &gpuMesh.EBO);
+
+    glBindVertexArray(gpuMesh.VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, gpuMesh.VBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gpuMesh.EBO);
+
+    // Position: location = 0
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+
+    // Normal: location = 1
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    // Color: location = 2
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)(6 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+
+    // Interleave pos + normal + color only here; the geometry side keeps separate streams
+    const size_t vertexCount = mesh.positions.size();
+    const bool hasNormals = mesh.normals.size() == vertexCount;
+    const bool hasColors = mesh.colors.size() == vertexCount;
+    interleaved.resize(vertexCount * 9);
+    float* out = interleaved.data();
+    for (size_t i = 0; i < vertexCount; ++i, out += 9) {
+        const glm::vec3& pos = mesh.positions[i];
+        const glm::vec3 norm = hasNormals ? mesh.normals[i] : glm::vec3(0.0f);
+        const glm::vec3 color = hasColors ? mesh.colors[i] : glm::vec3(1.0f);
+        out[0] = pos.x;   out[1] = pos.y;   out[2] = pos.z;
+        out[3] = norm.x;  out[4] = norm.y;  out[5] = norm.z;
+        out[6] = color.r; out[7] = color.g; out[8] = color.b;
+    }
+
+    glBufferData(GL_ARRAY_BUFFER, interleaved.size() * sizeof(float), interleaved.data(), GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.indices.size() * sizeof(unsigned int), mesh.indices.data(), GL_STATIC_DRAW);
+
+    glBindVertexArray(0); // Unbind
+
+    gpuMesh.indexCount = static_cast<GLsizei>(mesh.indices.size());
+    return gpuMesh;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include "glad/glad.h"
+#include "MeshData.h"
+#include <unordered_map>
+#include <vector>
+
+// Viewer-side GPU residency for MeshData. Buffers are created the first time a
+// mesh is drawn, so meshes that are never drawn (boolean intermediates) never
+// reach the driver. They are keyed by the mesh revision rather than its address:
+// the stamp is never reused, so a mesh allocated where a freed one lived cannot
+// pick up its buffers. An edited mesh gets new buffers, and EndFrame releases
+// those of revisions not drawn since the previous call.
+class MeshRenderer
+{
+public:
+    ~MeshRenderer();
+
+    void Draw(const MeshData& mesh);
+    // Once per frame, after the draws
+    void EndFrame();
+    void Release(const MeshData& mesh);
+    void ReleaseAll();
+
+private:
+    struct GpuMesh {
+        GLuint VAO = 0;
+        GLuint VBO = 0;
+        GLuint EBO = 0;
+        GLsizei indexCount = 0;
+        bool drawn = false; // Since the last EndFrame
+    };
+
+    GpuMesh& Upload(const MeshData& mesh);
+    static void Delete(GpuMesh& gpuMesh);
+
+    std::unordered_map<unsigned long long, GpuMesh> gpuMeshes; // By MeshData::revision
+    std::vector<float> interleaved; // Upload scratch, reused across meshes
+};
@@ -0,0 +1,46 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Minimal fork/join helpers for the batch kernels. Work is split into
+// contiguous chunks so results can be written without synchronization.
+class Parallel
+{
+public:
+    // Hardware threads, at least 1
+    static unsigned int ThreadCount()
+    {
+        unsigned int count = std::thread::hardware_concurrency();
+        return count > 0 ? count : 1;
+    }
+
+    // Runs fn(begin, end, chunk) for chunkCount contiguous slices of [0, count).
+    // Chunk 0 runs on the calling thread.
+    template <typename Fn>
+    static void ForChunks(size_t count, unsigned int chunkCount, Fn&& fn)
+    {
+        chunkCount = static_cast<unsigned int>(std::max<size_t>(1, std::min<size_t>(chunkCount, count)));
+        if (chunkCount == 1) {
+            fn(size_t(0), count, 0u);
+            return;
+        }
+
+        std::vector<std::thread> threads;
+        threads.reserve(chunkCount - 1);
+        for (unsigned int chunk = 1; chunk < chunkCount; ++chunk) {
+            threads.emplace_back([&fn, count, chunkCount, chunk]() {
+                fn(ChunkBegin(count, chunkCount, chunk), ChunkBegin(count, chunkCount, chunk + 1), chunk);
+                });
+        }
+        fn(size_t(0), ChunkBegin(count, chunkCount, 1), 0u);
+        for (std::thread& thread : threads)
+            thread.join();
+    }
+
+    static size_t ChunkBegin(size_t count, unsigned int chunkCount, unsigned int chunk)
+    {
+        return count * chunk / chunkCount;
+    }
+};
@@ -0,0 +1,191 @@
+#include "PlaneTable.h"
+#include "AxisProjection.h"
+#include "MeshData.h"
+#include "VertexWelder.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CSG_PLANES_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CSG_PLANES_SSE 1
+#endif
+
+// Same scheme as AxisProjection: AVX2 is compiled per function and picked at runtime
+#if defined(CSG_PLANES_X86) && (defined(__GNUC__) || defined(__clang__))
+#define CSG_PLANES_AVX2 1
+#define CSG_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#elif defined(CSG_PLANES_X86) && defined(_MSC_VER)
+#define CSG_PLANES_AVX2 1
+#define CSG_TARGET_AVX2
+#endif
+
+namespace {
+    using ClassifyKernel = void (*)(const PlaneTable& table, const glm::vec3* points, size_t count, unsigned char* outInside);
+
+    void ClassifyScalar(const PlaneTable& table, const glm::vec3* points, size_t count, unsigned char* outInside)
+    {
+        const size_t planes = table.planeCount;
+        for (size_t i = 0; i < count; ++i) {
+            const glm::vec3& p = points[i];
+            unsigned char inside = 1;
+            for (size_t k = 0; k < planes; ++k) {
+                if (table.nx[k] * p.x + table.ny[k] * p.y + table.nz[k] * p.z - table.d[k] > 0.0f) {
+                    inside = 0;
+                    break;
+                }
+            }
+            outInside[i] = inside;
+        }
+    }
+
+#ifdef CSG_PLANES_SSE
+    void ClassifySSE2(const PlaneTable& table, const glm::vec3* points, size_t count, unsigned char* outInside)
+    {
+        const size_t padded = table.nx.size();
+        const float* nx = table.nx.data();
+        const float* ny = table.ny.data();
+        const float* nz = table.nz.data();
+        const float* d = table.d.data();
+        const __m128 zero = _mm_setzero_ps();
+        for (size_t i = 0; i < count; ++i) {
+            const __m128 px = _mm_set1_ps(points[i].x);
+            const __m128 py = _mm_set1_ps(points[i].y);
+            const __m128 pz = _mm_set1_ps(points[i].z);
+            unsigned char inside = 1;
+            for (size_t k = 0; k < padded; k += 4) {
+                __m128 s = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, _mm_loadu_ps(nx + k)), _mm_mul_ps(py, _mm_loadu_ps(ny + k))),
+                    _mm_mul_ps(pz, _mm_loadu_ps(nz + k)));
+                if (_mm_movemask_ps(_mm_cmpgt_ps(_mm_sub_ps(s, _mm_loadu_ps(d + k)), zero))) {
+                    inside = 0;
+                    break;
+                }
+            }
+            outInside[i] = inside;
+        }
+    }
+#endif
+
+#ifdef CSG_PLANES_AVX2
+    CSG_TARGET_AVX2 void ClassifyAVX2(const PlaneTable& table, const glm::vec3* points, size_t count, unsigned char* outInside)
+    {
+        const size_t padded = table.nx.size();
+        const float* nx = table.nx.data();
+        const float* ny = table.ny.data();
+        const float* nz = table.nz.data();
+        const float* d = table.d.data();
+        const __m256 zero = _mm256_setzero_ps();
+        for (size_t i = 0; i < count; ++i) {
+            const __m256 px = _mm256_set1_ps(points[i].x);
+            const __m256 py = _mm256_set1_ps(points[i].y);
+            const __m256 pz = _mm256_set1_ps(points[i].z);
+            unsigned char inside = 1;
+            for (size_t k = 0; k < padded; k += PlaneTable::BlockWidth) {
+                __m256 s = _mm256_fmadd_ps(pz, _mm256_loadu_ps(nz + k),
+                    _mm256_fmadd_ps(py, _mm256_loadu_ps(ny + k), _mm256_mul_ps(px, _mm256_loadu_ps(nx + k))));
+                if (_mm256_movemask_ps(_mm256_cmp_ps(_mm256_sub_ps(s, _mm256_loadu_ps(d + k)), zero, _CMP_GT_OQ))) {
+                    inside = 0;
+                    break;
+                }
+            }
+            outInside[i] = inside;
+        }
+    }
+#endif
+
+    ClassifyKernel KernelFor(AxisProjection::ISA isa)
+    {
+        switch (isa) {
+#ifdef CSG_PLANES_AVX2
+        case AxisProjection::ISA::AVX2: return ClassifyAVX2;
+#endif
+#ifdef CSG_PLANES_SSE
+        case AxisProjection::ISA::SSE2: return ClassifySSE2;
+#endif
+        default: return ClassifyScalar;
+        }
+    }
+}
+
+const PlaneTable& PlaneTable::ForMesh(const MeshData& mesh)
+{
+    PlaneTable& table = mesh.planes;
+    if (table.sourceRevision != mesh.revision) {
+        table.Build(mesh);
+        table.sourceRevision = mesh.revision;
+    }
+    return table;
+}
+
+void PlaneTable::Build(const MeshData& mesh)
+{
+    Build(mesh.positions, mesh.indices);
+}
+
+void PlaneTable::Build(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices)
+{
+    nx.clear();
+    ny.clear();
+    nz.clear();
+    d.clear();
+
+    // Step 1: one plane per triangle, merged with an earlier plane of the same
+    // normal and distance. Merged planes keep the smaller distance, the stricter one.
+    VertexWelder uniqueNormals(NormalTolerance);
+    std::vector<unsigned int> firstPlane; // Per welded normal, head of its chain of planes
+    std::vector<unsigned int> nextPlane;  // Chain of planes sharing a welded normal
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        const glm::vec3& v0 = positions[indices[i]];
+        glm::vec3 normal = glm::cross(positions[indices[i + 1]] - v0, positions[indices[i + 2]] - v0);
+        float length = glm::length(normal);
+        // Degenerate triangles have no plane
+        if (!(length > 1e-12f))
+            continue;
+        normal /= length;
+        float distance = glm::dot(normal, v0);
+
+        bool inserted;
+        unsigned int normalId = uniqueNormals.Insert(normal, inserted);
+        if (inserted)
+            firstPlane.push_back(VertexWelder::NotFound);
+        unsigned int plane = firstPlane[normalId];
+        const float tolerance = DistanceTolerance * std::max(1.0f, std::abs(distance));
+        while (plane != VertexWelder::NotFound && std::abs(d[plane] - distance) > tolerance)
+            plane = nextPlane[plane];
+        if (plane != VertexWelder::NotFound) {
+            d[plane] = std::min(d[plane], distance);
+            continue;
+        }
+
+        plane = static_cast<unsigned int>(d.size());
+        nx.push_back(normal.x);
+        ny.push_back(normal.y);
+        nz.push_back(normal.z);
+        d.push_back(distance);
+        nextPlane.push_back(firstPlane[normalId]);
+        firstPlane[normalId] = plane;
+    }
+    planeCount = d.size();
+
+    // Step 2: pad to whole blocks with planes every point is behind
+    const size_t padded = (planeCount + BlockWidth - 1) / BlockWidth * BlockWidth;
+    nx.resize(padded, 0.0f);
+    ny.resize(padded, 0.0f);
+    nz.resize(padded, 0.0f);
+    d.resize(padded, INFINITY);
+}
+
+bool PlaneTable::Contains(const glm::vec3& point) const
+{
+    unsigned char inside;
+    Classify(&point, 1, &inside);
+    return inside != 0;
+}
+
+void PlaneTable::Classify(const glm::vec3* points, size_t count, unsigned char* outInside) const
+{
+    KernelFor(AxisProjection::ActiveISA())(*this, points, count, outInside);
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include "glm.hpp"
+#include <cstddef>
+#include <vector>
+
+struct MeshData;
+
+// Outward face planes dot(n, p) = d of a mesh, one per distinct plane, for
+// point-in-convex tests. Stored as SoA and padded to a multiple of 8 with
+// planes no point is outside of, so the kernels classify a point against 8
+// planes per AVX instruction (4 with SSE2) and stop at the first block that
+// has a plane with the point in front of it. The ISA follows AxisProjection.
+class PlaneTable
+{
+public:
+    static constexpr size_t BlockWidth = 8;
+    // Planes closer than this in normal and in distance (relative) are merged
+    static constexpr float NormalTolerance = 1e-5f;
+    static constexpr float DistanceTolerance = 1e-5f;
+
+    void Build(const MeshData& mesh);
+    void Build(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices);
+
+    // Local-space table of the mesh, rebuilt when its revision changes
+    static const PlaneTable& ForMesh(const MeshData& mesh);
+
+    // True when the point is behind or on every plane; an empty table contains everything
+    bool Contains(const glm::vec3& point) const;
+    // outInside[i] = Contains(points[i]), in one pass of the SIMD kernel
+    void Classify(const glm::vec3* points, size_t count, unsigned char* outInside) const;
+
+    size_t Size() const { return planeCount; }
+
+    // SoA, size a multiple of BlockWidth
+    std::vector<float> nx, ny, nz, d;
+    size_t planeCount = 0;
+
+    unsigned long long sourceRevision = 0;
+};
@@ -0,0 +1,313 @@
+#include "PolygonTriangulator.h"
+#include "Predicates.h"
+#include <algorithm>
+#include <cmath>
+
+double PolygonTriangulator::Orient(unsigned int a, unsigned int b, unsigned int c) const
+{
+    return Predicates::Orient2D(position[a], position[b], position[c]);
+}
+
+void PolygonTriangulator::AddLoop(unsigned int first, unsigned int count, bool counterClockwise)
+{
+    // Nodes first .. first + count - 1 as a ring, reversed when its winding is not the wanted one
+    float area = 0.0f;
+    for (unsigned int k = 0; k < count; ++k) {
+        const glm::vec2& p = position[first + k];
+        const glm::vec2& q = position[first + (k + 1) % count];
+        area += p.x * q.y - q.x * p.y;
+    }
+    const bool reverse = (area > 0.0f) != counterClockwise;
+    for (unsigned int k = 0; k < count; ++k) {
+        const unsigned int after = first + (k + 1) % count;
+        const unsigned int before = first + (k + count - 1) % count;
+        next[first + k] = reverse ? before : after;
+        prev[first + k] = reverse ? after : before;
+    }
+}
+
+bool PolygonTriangulator::BridgeHole(unsigned int outer, unsigned int hole)
+{
+    // Cast a ray from the hole's rightmost vertex to +x; the nearest outer edge
+    // it hits gives a candidate, the end of that edge further along x
+    const glm::vec2 m = position[hole];
+    float hitX = INFINITY;
+    unsigned int candidate = 0;
+    bool found = false;
+    unsigned int p = outer;
+    do {
+        const unsigned int q = next[p];
+        const glm::vec2& a = position[p];
+        const glm::vec2& b = position[q];
+        if ((a.y <= m.y && b.y >= m.y) || (a.y >= m.y && b.y <= m.y)) {
+            const float x = a.y == b.y ? std::min(a.x, b.x) : a.x + (m.y - a.y) / (b.y - a.y) * (b.x - a.x);
+            if (x >= m.x && x < hitX) {
+                hitX = x;
+                candidate = a.x > b.x ? p : q;
+                found = true;
+            }
+        }
+        p = q;
+    } while (p != outer);
+    if (!found)
+        return false;
+
+    // A vertex inside triangle (m, hit, candidate) would hide the candidate; the
+    // one closest in angle to the ray is visible instead
+    if (position[candidate].x != hitX || position[candidate].y != m.y) {
+        const glm::vec2 hit(hitX, m.y);
+        const glm::vec2 c = position[candidate];
+        const float side = (hit.x - m.x) * (c.y - m.y) - (hit.y - m.y) * (c.x - m.x);
+        float bestTangent = INFINITY;
+        p = outer;
+        do {
+            const glm::vec2& r = position[p];
+            if (p != candidate && r.x > m.x) {
+                auto cross = [&](const glm::vec2& u, const glm::vec2& v) { return (v.x - u.x) * (r.y - u.y) - (v.y - u.y) * (r.x - u.x); };
+                const bool inside = side > 0.0f
+                    ? cross(m, hit) >= 0.0f && cross(hit, c) >= 0.0f && cross(c, m) >= 0.0f
+                    : cross(m, hit) <= 0.0f && cross(hit, c) <= 0.0f && cross(c, m) <= 0.0f;
+                // The bridge must leave r into the polygon, between its two edges
+                const unsigned int in = prev[p], out = next[p];
+                const bool convex = Orient(p, out, in) >= 0.0;
+                const bool between = convex ? Orient(p, out, hole) >= 0.0 && Orient(p, hole, in) >= 0.0
+                    : !(Orient(p, in, hole) > 0.0 && Orient(p, hole, out) > 0.0);
+                if (inside && between) {
+                    const float tangent = std::abs(r.y - m.y) / (r.x - m.x);
+                    if (tangent < bestTangent || (tangent == bestTangent && r.x < position[candidate].x)) {
+                        bestTangent = tangent;
+                        candidate = p;
+                    }
+                }
+            }
+            p = next[p];
+        } while (p != outer);
+    }
+
+    // Split the ring at candidate and hole with a pair of duplicated nodes:
+    // candidate -> hole ... around the hole ... hole' -> candidate' -> on round the outer loop
+    const unsigned int holeCopy = static_cast<unsigned int>(point.size());
+    const unsigned int candidateCopy = holeCopy + 1;
+    for (unsigned int copy : { hole, candidate }) {
+        position.push_back(position[copy]);
+        point.push_back(point[copy]);
+        prev.push_back(0);
+        next.push_back(0);
+    }
+    const unsigned int candidateNext = next[candidate];
+    const unsigned int holePrev = prev[hole];
+    next[candidate] = hole;
+    prev[hole] = candidate;
+    next[candidateCopy] = candidateNext;
+    prev[candidateNext] = candidateCopy;
+    next[holeCopy] = candidateCopy;
+    prev[candidateCopy] = holeCopy;
+    next[holePrev] = holeCopy;
+    prev[holeCopy] = holePrev;
+    return true;
+}
+
+int PolygonTriangulator::Cell(float x, float y, int axis) const
+{
+    const float coordinate = axis == 0 ? (x - gridMin.x) / cellSize.x : (y - gridMin.y) / cellSize.y;
+    return std::clamp(static_cast<int>(coordinate), 0, gridSize[axis] - 1);
+}
+
+void PolygonTriangulator::BuildGrid(unsigned int start)
+{
+    // Reflex (and straight) vertices by cell, about one per cell, by counting sort
+    glm::vec2 low(INFINITY), high(-INFINITY);
+    reflexCount = 0;
+    unsigned int node = start;
+    do {
+        reflex[node] = Orient(prev[node], node, next[node]) <= 0.0 ? 1 : 0;
+        reflexCount += reflex[node];
+        low = glm::min(low, position[node]);
+        high = glm::max(high, position[node]);
+        node = next[node];
+    } while (node != start);
+    const glm::vec2 extent = glm::max(high - low, glm::vec2(1e-30f));
+    const float cells = static_cast<float>(std::max<size_t>(reflexCount, 1));
+    gridSize[0] = std::clamp(static_cast<int>(std::sqrt(cells * extent.x / extent.y)), 1, 1024);
+    gridSize[1] = std::clamp(static_cast<int>(cells / gridSize[0]), 1, 1024);
+    gridMin = low;
+    cellSize = extent / glm::vec2(static_cast<float>(gridSize[0]), static_cast<float>(gridSize[1]));
+
+    cellOffsets.assign(size_t(gridSize[0]) * gridSize[1] + 1, 0);
+    auto cellOf = [&](unsigned int n) {
+        return size_t(Cell(position[n].x, position[n].y, 1)) * gridSize[0] + Cell(position[n].x, position[n].y, 0);
+    };
+    node = start;
+    do {
+        if (reflex[node])
+            cellOffsets[cellOf(node) + 1]++;
+        node = next[node];
+    } while (node != start);
+    for (size_t c = 1; c < cellOffsets.size(); ++c)
+        cellOffsets[c] += cellOffsets[c - 1];
+    cellNodes.resize(cellOffsets.back());
+    slot.resize(position.size());
+    node = start;
+    do {
+        if (reflex[node]) {
+            slot[node] = cellOffsets[cellOf(node)]++;
+            cellNodes[slot[node]] = node;
+        }
+        node = next[node];
+    } while (node != start);
+    // Filling moved each offset to the next cell's start, which is where the
+    // cell's live entries end; shift the starts back
+    cellEnds.assign(cellOffsets.begin(), cellOffsets.end() - 1);
+    for (size_t c = cellOffsets.size() - 1; c > 0; --c)
+        cellOffsets[c] = cellOffsets[c - 1];
+    cellOffsets[0] = 0;
+}
+
+void PolygonTriangulator::Unreflex(unsigned int node)
+{
+    // Swap the node with its cell's last live entry, so ear tests never see it again
+    reflex[node] = 0;
+    --reflexCount;
+    const glm::vec2& p = position[node];
+    const size_t cell = size_t(Cell(p.x, p.y, 1)) * gridSize[0] + Cell(p.x, p.y, 0);
+    const unsigned int last = cellNodes[--cellEnds[cell]];
+    cellNodes[slot[node]] = last;
+    slot[last] = slot[node];
+}
+
+bool PolygonTriangulator::IsEar(unsigned int b) const
+{
+    const unsigned int a = prev[b];
+    const unsigned int c = next[b];
+    if (Orient(a, b, c) <= 0.0)
+        return false;
+    if (reflexCount == 0)
+        return true; // What is left is convex
+
+    // No reflex vertex may lie in or on the triangle; copies of
+    // its own corners made by the bridges do not count
+    const glm::vec2 low = glm::min(position[a], glm::min(position[b], position[c]));
+    const glm::vec2 high = glm::max(position[a], glm::max(position[b], position[c]));
+    const int x0 = Cell(low.x, low.y, 0), x1 = Cell(high.x, high.y, 0);
+    const int y0 = Cell(low.x, low.y, 1), y1 = Cell(high.x, high.y, 1);
+    for (int y = y0; y <= y1; ++y) {
+        for (int x = x0; x <= x1; ++x) {
+            const size_t cell = size_t(y) * gridSize[0] + x;
+            for (unsigned int k = cellOffsets[cell]; k < cellEnds[cell]; ++k) {
+                const unsigned int r = cellNodes[k];
+                if (r == a || r == b || r == c || Coincident(r, a) || Coincident(r, b) || Coincident(r, c))
+                    continue;
+                if (Orient(a, b, r) >= 0.0 && Orient(b, c, r) >= 0.0 && Orient(c, a, r) >= 0.0)
+                    return false;
+            }
+        }
+    }
+    return true;
+}
+
+size_t PolygonTriangulator::Triangulate(const std::vector<glm::vec3>& points, const glm::vec3& normal,
+    const std::vector<unsigned int>& loopPoints, const std::vector<unsigned int>& loopOffsets, unsigned int* outIndices)
+{
+    if (loopOffsets.size() < 2 || loopOffsets[1] - loopOffsets[0] < 3)
+        return 0;
+
+    // Step 1: project, mirroring when the normal points down the dropped axis so
+    // that counter-clockwise about the normal stays counter-clockwise in 2D
+    const glm::vec3 absNormal = glm::abs(normal);
+    const int axis = absNormal.x > absNormal.y ? (absNormal.x > absNormal.z ? 0 : 2) : (absNormal.y > absNormal.z ? 1 : 2);
+    const float mirror = normal[axis] < 0.0f ? -1.0f : 1.0f;
+    const size_t loopCount = loopOffsets.size() - 1;
+    position.clear();
+    point.clear();
+    holes.clear();
+    const size_t nodeCount = loopPoints.size() + 2 * (loopCount - 1);
+    position.reserve(nodeCount);
+    point.reserve(nodeCount);
+    prev.resize(loopPoints.size());
+    next.resize(loopPoints.size());
+    prev.reserve(nodeCount);
+    next.reserve(nodeCount);
+
+    // Step 2: the outer loop counter-clockwise and the holes clockwise
+    unsigned int outer = 0;
+    for (size_t k = 0; k < loopCount; ++k) {
+        for (unsigned int i = loopOffsets[k]; i < loopOffsets[k + 1]; ++i) {
+            const glm::vec3& p = points[loopPoints[i]];
+            const glm::vec2 q = axis == 0 ? glm::vec2(p.y, p.z) : (axis == 1 ? glm::vec2(p.z, p.x) : glm::vec2(p.x, p.y));
+            position.push_back(glm::vec2(q.x * mirror, q.y));
+            point.push_back(loopPoints[i]);
+        }
+        const unsigned int first = loopOffsets[k];
+        AddLoop(first, loopOffsets[k + 1] - first, k == 0);
+        if (k == 0) {
+            outer = first;
+            continue;
+        }
+        if (loopOffsets[k + 1] - loopOffsets[k] < 3)
+            continue;
+        unsigned int rightmost = first;
+        for (unsigned int node = first; node < first + (loopOffsets[k + 1] - loopOffsets[k]); ++node) {
+            if (position[node].x > position[rightmost].x || (position[node].x == position[rightmost].x && position[node].y < position[rightmost].y))
+                rightmost = node;
+        }
+        holes.push_back(rightmost);
+    }
+
+    // Step 3: bridge the holes, rightmost first so that later bridges go to the
+    // outer loop or to holes already joined to it
+    std::sort(holes.begin(), holes.end(), [&](unsigned int l, unsigned int r) { return position[l].x > position[r].x; });
+    // A hole that reaches no outer vertex would be covered over, so give up
+    for (unsigned int hole : holes) {
+        if (!BridgeHole(outer, hole))
+            return 0;
+    }
+
+    // Step 4: clip ears until a triangle is left. A full turn round the ring
+    // without an ear means the loops were not simple, and clipping stops there.
+    reflex.assign(point.size(), 0);
+    BuildGrid(outer);
+    size_t remaining = 0;
+    unsigned int node = outer;
+    do {
+        ++remaining;
+        node = next[node];
+    } while (node != outer);
+    size_t written = 0;
+    auto emit = [&](unsigned int a, unsigned int b, unsigned int c) {
+        outIndices[written * 3] = point[a];
+        outIndices[written * 3 + 1] = point[b];
+        outIndices[written * 3 + 2] = point[c];
+        ++written;
+    };
+    auto remove = [&](unsigned int b) {
+        const unsigned int a = prev[b];
+        const unsigned int c = next[b];
+        next[a] = c;
+        prev[c] = a;
+        // Clipping only shrinks the angles at its neighbours
+        if (reflex[a] && Orient(prev[a], a, c) > 0.0)
+            Unreflex(a);
+        if (reflex[c] && Orient(a, c, next[c]) > 0.0)
+            Unreflex(c);
+        --remaining;
+    };
+    unsigned int b = outer;
+    unsigned int stop = b;
+    while (remaining > 3) {
+        if (IsEar(b)) {
+            // Going on past the next vertex keeps ears from fanning out of one
+            // vertex into long slivers whose boxes cover the whole grid
+            emit(prev[b], b, next[b]);
+            const unsigned int c = next[b];
+            remove(b);
+            b = stop = next[c];
+            continue;
+        }
+        b = next[b];
+        if (b == stop)
+            return written;
+    }
+    if (remaining == 3 && Orient(prev[b], b, next[b]) > 0.0)
+        emit(prev[b], b, next[b]);
+    return written;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "glm.hpp"
+#include <vector>
+
+// Ear clipping for planar polygons with holes, in 2D after dropping the axis
+// where the polygon's normal is largest. Each hole is bridged to the outer loop
+// (from its rightmost vertex to a visible outer vertex, rightmost holes first),
+// leaving one weakly simple loop to clip. Only reflex vertices can make an ear
+// invalid, and a vertex never turns reflex once clipping starts, so they are
+// bucketed once in a uniform grid over the polygon; an ear test looks at the
+// cells under its triangle instead of at every vertex.
+// Storage is reused between calls like TriangleSplitter's; one per thread.
+class PolygonTriangulator
+{
+public:
+    // A polygon of vertexCount vertices and holeCount holes has this many triangles
+    static size_t TriangleCount(size_t vertexCount, size_t holeCount) { return vertexCount + 2 * holeCount - 2; }
+
+    // points: positions the loops index. loopPoints / loopOffsets: the loops in CSR
+    // form, loop k being loopPoints[loopOffsets[k]] up to loopPoints[loopOffsets[k + 1]];
+    // loop 0 is the outer boundary and the rest are holes inside it, in either
+    // winding. Writes triangles as indices into points, counter-clockwise about
+    // normal, to outIndices, which must hold 3 * TriangleCount(...) entries.
+    // Returns the number of triangles written; fewer than TriangleCount means
+    // the loops were not a simple polygon: a hole found no bridge (none are
+    // written then) or clipping stopped part way.
+    size_t Triangulate(const std::vector<glm::vec3>& points, const glm::vec3& normal,
+        const std::vector<unsigned int>& loopPoints, const std::vector<unsigned int>& loopOffsets, unsigned int* outIndices);
+
+private:
+    double Orient(unsigned int a, unsigned int b, unsigned int c) const;
+    bool Coincident(unsigned int a, unsigned int b) const { return position[a] == position[b]; }
+    void AddLoop(unsigned int first, unsigned int count, bool counterClockwise);
+    bool BridgeHole(unsigned int outer, unsigned int hole);
+    void BuildGrid(unsigned int start);
+    void Unreflex(unsigned int node);
+    bool IsEar(unsigned int b) const;
+    int Cell(float x, float y, int axis) const;
+
+    std::vector<glm::vec2> position;  // Per node; bridges duplicate a vertex into two nodes
+    std::vector<unsigned int> point;  // Index into the caller's points
+    std::vector<unsigned int> prev, next;
+    std::vector<unsigned char> reflex;
+    std::vector<unsigned int> holes;  // Scratch: one node of each hole, rightmost first
+    std::vector<unsigned int> cellOffsets, cellNodes; // Reflex nodes per grid cell, CSR
+    std::vector<unsigned int> cellEnds;  // End of each cell's live entries; nodes turned convex are swapped out
+    std::vector<unsigned int> slot;      // Position of each reflex node in cellNodes
+    size_t reflexCount = 0;
+    glm::vec2 gridMin = glm::vec2(0.0f);
+    glm::vec2 cellSize = glm::vec2(1.0f);
+    int gridSize[2] = { 1, 1 };
+};
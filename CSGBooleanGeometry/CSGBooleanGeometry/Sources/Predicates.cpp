@@ -0,0 +1,23 @@
+#include "Predicates.h"
+#include "Expansion.h"
+
+double Predicates::Orient2DExact(const glm::vec2& a, const glm::vec2& b, const glm::vec2& c)
+{
+    Expansion determinant;
+    Expansion::Orient2D(a, b, c, determinant);
+    return determinant.Estimate();
+}
+
+double Predicates::Orient3DExact(const glm::dvec3& a, const glm::dvec3& b, const glm::dvec3& c, const glm::dvec3& d)
+{
+    Expansion determinant;
+    Expansion::Orient3D(a, b, c, d, determinant);
+    return determinant.Estimate();
+}
+
+double Predicates::InCircleExact(const glm::vec2& a, const glm::vec2& b, const glm::vec2& c, const glm::vec2& d)
+{
+    Expansion determinant;
+    Expansion::InCircle(a, b, c, d, determinant);
+    return determinant.Estimate();
+}
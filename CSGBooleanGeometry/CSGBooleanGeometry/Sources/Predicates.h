@@ -0,0 +1,96 @@
+#pragma once
+#include "glm.hpp"
+#include <cmath>
+
+// Orientation and in-circle tests on float coordinates (and double ones for
+// Orient3D) whose signs are exact, after Shewchuk. Each determinant is first evaluated in double together with a
+// bound on its round-off; only when the result is smaller than the bound is it
+// recomputed exactly with expansion arithmetic (sums of non-overlapping
+// doubles), so the common case costs a few multiplies and a compare and is
+// inlined here, while the exact fallbacks live in Predicates.cpp (see Expansion).
+// The returned values approximate the determinants; their signs, and zero for
+// degenerate input, are exact.
+class Predicates
+{
+public:
+    // Twice the signed area of a, b, c: positive when they run counter-clockwise
+    static double Orient2D(const glm::vec2& a, const glm::vec2& b, const glm::vec2& c)
+    {
+        const double left = (double(a.x) - c.x) * (double(b.y) - c.y);
+        const double right = (double(a.y) - c.y) * (double(b.x) - c.x);
+        const double det = left - right;
+        // Terms of opposite signs cannot cancel, so the sign is already right
+        if ((left > 0.0) != (right > 0.0) || left == 0.0 || right == 0.0)
+            return det;
+        if (std::abs(det) >= Orient2DBound * (std::abs(left) + std::abs(right)))
+            return det;
+        return Orient2DExact(a, b, c);
+    }
+
+    // dot(cross(b - a, c - a), d - a): positive when d lies on the side the
+    // normal of a, b, c (counter-clockwise, right hand) points to
+    static double Orient3D(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const glm::vec3& d)
+    {
+        return Orient3D(glm::dvec3(a), glm::dvec3(b), glm::dvec3(c), glm::dvec3(d));
+    }
+    // The same on double coordinates; the bound covers their rounded differences
+    static double Orient3D(const glm::dvec3& a, const glm::dvec3& b, const glm::dvec3& c, const glm::dvec3& d)
+    {
+        double bound;
+        const double det = Orient3DApproximate(a, b, c, d, bound);
+        if (std::abs(det) > bound)
+            return det;
+        return Orient3DExact(a, b, c, d);
+    }
+    // Orient3D in double alone, and a bound on its distance from the exact value
+    static double Orient3DApproximate(const glm::dvec3& a, const glm::dvec3& b, const glm::dvec3& c, const glm::dvec3& d,
+        double& outBound)
+    {
+        const double abx = b.x - a.x, aby = b.y - a.y, abz = b.z - a.z;
+        const double acx = c.x - a.x, acy = c.y - a.y, acz = c.z - a.z;
+        const double adx = d.x - a.x, ady = d.y - a.y, adz = d.z - a.z;
+        const double yz = aby * acz, zy = abz * acy;
+        const double zx = abz * acx, xz = abx * acz;
+        const double xy = abx * acy, yx = aby * acx;
+        const double det = (yz - zy) * adx + (zx - xz) * ady + (xy - yx) * adz;
+        const double permanent = (std::abs(yz) + std::abs(zy)) * std::abs(adx)
+            + (std::abs(zx) + std::abs(xz)) * std::abs(ady)
+            + (std::abs(xy) + std::abs(yx)) * std::abs(adz);
+        outBound = Orient3DBound * permanent;
+        return det;
+    }
+
+    // Positive when d lies inside the circle through a, b, c (counter-clockwise),
+    // negative outside, zero on it
+    static double InCircle(const glm::vec2& a, const glm::vec2& b, const glm::vec2& c, const glm::vec2& d)
+    {
+        const double adx = double(a.x) - d.x, ady = double(a.y) - d.y;
+        const double bdx = double(b.x) - d.x, bdy = double(b.y) - d.y;
+        const double cdx = double(c.x) - d.x, cdy = double(c.y) - d.y;
+        const double bc = bdx * cdy, cb = cdx * bdy;
+        const double ca = cdx * ady, ac = adx * cdy;
+        const double ab = adx * bdy, ba = bdx * ady;
+        const double aLift = adx * adx + ady * ady;
+        const double bLift = bdx * bdx + bdy * bdy;
+        const double cLift = cdx * cdx + cdy * cdy;
+        const double det = aLift * (bc - cb) + bLift * (ca - ac) + cLift * (ab - ba);
+        const double permanent = (std::abs(bc) + std::abs(cb)) * aLift
+            + (std::abs(ca) + std::abs(ac)) * bLift
+            + (std::abs(ab) + std::abs(ba)) * cLift;
+        if (std::abs(det) > InCircleBound * permanent)
+            return det;
+        return InCircleExact(a, b, c, d);
+    }
+
+private:
+    // Round-off bounds of the double evaluations, relative to the sum of the
+    // magnitudes of their terms (Shewchuk's errboundA constants)
+    static constexpr double Epsilon = 1.1102230246251565e-16; // 2^-53
+    static constexpr double Orient2DBound = (3.0 + 16.0 * Epsilon) * Epsilon;
+    static constexpr double Orient3DBound = (7.0 + 56.0 * Epsilon) * Epsilon;
+    static constexpr double InCircleBound = (10.0 + 96.0 * Epsilon) * Epsilon;
+
+    static double Orient2DExact(const glm::vec2& a, const glm::vec2& b, const glm::vec2& c);
+    static double Orient3DExact(const glm::dvec3& a, const glm::dvec3& b, const glm::dvec3& c, const glm::dvec3& d);
+    static double InCircleExact(const glm::vec2& a, const glm::vec2& b, const glm::vec2& c, const glm::vec2& d);
+};
@@ -1,5 +1,16 @@
 
 #include "Shapes.h"
+#include "AxisProjection.h"
+#include "IntersectionGraph.h"
+#include "MeshBoolean.h"
+#include "MeshPatches.h"
+#include "PlaneTable.h"
+#include "Predicates.h"
+#include "TransformCache.h"
+#include "TriangleIntersection.h"
+#include "TriangleSplitter.h"
+#include "VertexWelder.h"
+#include "WindingNumber.h"
 #include <array>
 #include <gtc/matrix_transform.hpp>
 #include <gtc/type_ptr.hpp>
@@ -12,31 +23,54 @@
 #include <iostream>
 #include <algorithm>
 #include <cmath>
+#include <utility>
 
-void DebugPrintTriangleNormals(const std::vector<glm::vec3>& points, const std::vector<unsigned int>& indices,glm::vec3 normalT) {
-    std::cout << glm::to_string(normalT) << "\n\n";
-    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
-        glm::vec3 v0 = points[indices[i]];
-        glm::vec3 v1 = points[indices[i + 1]];
-        glm::vec3 v2 = points[indices[i + 2]];
-
-        glm::vec3 normal = glm::normalize(glm::cross(v1 - v0, v2 - v0));
+// Containment of every vertex of a welded operand in the other mesh. Triangles
+// flagged in barrier may touch the other surface; the rest form patches that
+// are wholly inside or outside, so the patches cost one query each.
+static std::vector<unsigned char> ClassifyVerticesByPatch(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices,
+    const glm::mat4& model, const std::vector<unsigned char>& barrier, const MeshData& other, const glm::mat4& otherModel)
+{
+    MeshPatches patches;
+    patches.Build(positions, indices, {}, barrier);
+    std::vector<unsigned char> inside;
+    patches.ClassifyVertices(positions, indices, [&](const std::vector<glm::vec3>& points, std::vector<unsigned char>& outInside) {
+        Shapes::ClassifyPoints(points, model, other, otherModel, outInside);
+        }, inside);
+    return inside;
+}
 
-        std::cout << glm::to_string(normal) << "\n";
-        std::cout << glm::to_string(v0) << "\n";
-        std::cout << glm::to_string(v1) << "\n";
-        std::cout << glm::to_string(v2) << "\n\n";
+// Overlap of two coplanar triangles: subject clipped by each edge of clip in turn
+// (Sutherland-Hodgman), which leaves the convex result in boundary order
+static void ClipTriangleToTriangle(const glm::vec3 subject[3], const glm::vec3 clip[3], std::vector<glm::vec3>& outPolygon)
+{
+    const glm::vec3 normal = glm::cross(clip[1] - clip[0], clip[2] - clip[0]);
+    outPolygon.assign(subject, subject + 3);
+    std::vector<glm::vec3> input;
+    for (int e = 0; e < 3 && !outPolygon.empty(); ++e) {
+        const glm::vec3 inward = glm::cross(normal, clip[(e + 1) % 3] - clip[e]);
+        input.swap(outPolygon);
+        outPolygon.clear();
+        for (size_t k = 0; k < input.size(); ++k) {
+            const glm::vec3& p = input[k];
+            const glm::vec3& q = input[(k + 1) % input.size()];
+            const float dp = glm::dot(inward, p - clip[e]);
+            const float dq = glm::dot(inward, q - clip[e]);
+            if (dp >= 0.0f)
+                outPolygon.push_back(p);
+            if ((dp >= 0.0f) != (dq >= 0.0f))
+                outPolygon.push_back(p + (q - p) * (dp / (dp - dq)));
+        }
     }
 }
 
-void BuildVertexBufferFromPositionsAndIndices(
+void BuildVertexNormalsFromPositionsAndIndices(
     const std::vector<glm::vec3>& positions,
     const std::vector<unsigned int>& indices,
-    std::vector<float>& outVertexBuffer,
-    const glm::vec3& color)
+    std::vector<glm::vec3>& outNormals)
 {
     const size_t vertexCount = positions.size();
-    std::vector<glm::vec3> normals(vertexCount, glm::vec3(0.0f));
+    outNormals.assign(vertexCount, glm::vec3(0.0f));
 
     // Step 1: Accumulate triangle normals per vertex
     for (size_t i = 0; i < indices.size(); i += 3) {
@@ -48,41 +82,45 @@ void BuildVertexBufferFromPositionsAndIndices(
         const glm::vec3& v1 = positions[i1];
         const glm::vec3& v2 = positions[i2];
 
-        glm::vec3 normal = glm::normalize(glm::cross(v1 - v0, v2 - v0));
+        glm::vec3 normal = glm::cross(v1 - v0, v2 - v0);
+        const float length = glm::length(normal);
+        if (length == 0.0f)
+            continue; // Degenerate: no direction to contribute
+        normal /= length;
 
-        normals[i0] += normal;
-        normals[i1] += normal;
-        normals[i2] += normal;
+        outNormals[i0] += normal;
+        outNormals[i1] += normal;
+        outNormals[i2] += normal;
     }
 
     // Step 2: Normalize the accumulated normals
-    for (glm::vec3& n : normals) {
-        n = glm::normalize(n);
+    for (glm::vec3& n : outNormals) {
+        const float length = glm::length(n);
+        if (length > 0.0f)
+            n /= length;
     }
+}
 
-    // Step 3: Build the vertex buffer (pos + normal + color)
-    outVertexBuffer.clear();
-    outVertexBuffer.reserve(vertexCount * 9);
-
-    for (size_t i = 0; i < vertexCount; ++i) {
-        const glm::vec3& pos = positions[i];
-        const glm::vec3& norm = normals[i];
-
-        // Position
-        outVertexBuffer.push_back(pos.x);
-        outVertexBuffer.push_back(pos.y);
-        outVertexBuffer.push_back(pos.z);
+// Where segment p0 p1 passes through triangle v0 v1 v2, boundaries included, as
+// a parameter along the segment. Every decision is an exact orientation sign;
+// a segment lying in the triangle's plane is reported as not crossing.
+static bool SegmentCrossesTriangle(const glm::vec3& p0, const glm::vec3& p1,
+    const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2, float& t)
+{
+    const double side0 = Predicates::Orient3D(v0, v1, v2, p0);
+    const double side1 = Predicates::Orient3D(v0, v1, v2, p1);
+    if ((side0 > 0.0 && side1 > 0.0) || (side0 < 0.0 && side1 < 0.0) || (side0 == 0.0 && side1 == 0.0))
+        return false;
 
-        // Normal
-        outVertexBuffer.push_back(norm.x);
-        outVertexBuffer.push_back(norm.y);
-        outVertexBuffer.push_back(norm.z);
+    // The line meets the triangle when it passes all three edges the same way round
+    const double edge0 = Predicates::Orient3D(p0, p1, v0, v1);
+    const double edge1 = Predicates::Orient3D(p0, p1, v1, v2);
+    const double edge2 = Predicates::Orient3D(p0, p1, v2, v0);
+    if ((edge0 < 0.0 || edge1 < 0.0 || edge2 < 0.0) && (edge0 > 0.0 || edge1 > 0.0 || edge2 > 0.0))
+        return false;
 
-        // Color
-        outVertexBuffer.push_back(color.r);
-        outVertexBuffer.push_back(color.g);
-        outVertexBuffer.push_back(color.b);
-    }
+    t = static_cast<float>(side0 / (side0 - side1));
+    return true;
 }
 
 bool LineIntersectsTriangle2(
@@ -92,22 +130,12 @@ bool LineIntersectsTriangle2(
     bool& isSegmentIntersection)
 {
     const glm::vec3 dir = p1 - p0;
-    const glm::vec3 e1 = v1 - v0;
-    const glm::vec3 e2 = v2 - v0;
-
-    const glm::vec3 normal = glm::normalize(glm::cross(e1, e2));
-    const float denom = glm::dot(normal, dir);
-
-    // Check if line and triangle are parallel
-    if (fabs(denom) < std::numeric_limits<float>::epsilon()) {
-        // Coplanar check
-        const float dist = glm::dot(normal, p0 - v0);
-        if (fabs(dist) > std::numeric_limits<float>::epsilon()) {
-            return false; // Parallel but not coplanar
-        }
 
+    // Coplanar only when both ends lie exactly in the triangle's plane
+    if (Predicates::Orient3D(v0, v1, v2, p0) == 0.0 && Predicates::Orient3D(v0, v1, v2, p1) == 0.0) {
         // Segment and triangle are coplanar – check for 2D overlap
         // Project onto best 2D plane
+        const glm::vec3 normal = glm::cross(v1 - v0, v2 - v0);
         int axis = 0;
         glm::vec3 n = glm::abs(normal);
         if (n.y > n.x) axis = 1;
@@ -127,15 +155,14 @@ bool LineIntersectsTriangle2(
         glm::vec2 tri0 = project2D(v0);
         glm::vec2 tri1 = project2D(v1);
         glm::vec2 tri2 = project2D(v2);
+        if (Predicates::Orient2D(tri0, tri1, tri2) == 0.0)
+            return false; // Degenerate triangle
 
         // Check if either endpoint is inside the triangle
         auto PointInTri = [](const glm::vec2& pt, const glm::vec2& a, const glm::vec2& b, const glm::vec2& c) {
-            auto sign = [](const glm::vec2& p1, const glm::vec2& p2, const glm::vec2& p3) {
-                return (p1.x - p3.x) * (p2.y - p3.y) - (p2.x - p3.x) * (p1.y - p3.y);
-                };
-            float d1 = sign(pt, a, b);
-            float d2 = sign(pt, b, c);
-            float d3 = sign(pt, c, a);
+            double d1 = Predicates::Orient2D(pt, a, b);
+            double d2 = Predicates::Orient2D(pt, b, c);
+            double d3 = Predicates::Orient2D(pt, c, a);
             bool hasNeg = (d1 < 0) || (d2 < 0) || (d3 < 0);
             bool hasPos = (d1 > 0) || (d2 > 0) || (d3 > 0);
             return !(hasNeg && hasPos);
@@ -145,21 +172,17 @@ bool LineIntersectsTriangle2(
         if (PointInTri(segA, tri0, tri1, tri2)) insidePoints.push_back(p0);
         if (PointInTri(segB, tri0, tri1, tri2)) insidePoints.push_back(p1);
 
-        // Also check for segment-triangle edge intersections in 2D
-        auto SegmentIntersect = [](glm::vec2 p, glm::vec2 r, glm::vec2 q, glm::vec2 s, glm::vec2& out) -> bool {
-            float rxs = r.x * s.y - r.y * s.x;
-            if (fabs(rxs) < std::numeric_limits<float>::epsilon()) return false; // parallel
-            glm::vec2 qp = q - p;
-            float t = (qp.x * s.y - qp.y * s.x) / rxs;
-            float u = (qp.x * r.y - qp.y * r.x) / rxs;
-            if (t >= 0 && t <= 1 && u >= 0 && u <= 1) {
-                out = p + t * r;
-                return true;
-            }
-            return false;
+        // Also check for segment-triangle edge intersections in 2D; t is along a b
+        auto SegmentIntersect = [](glm::vec2 a, glm::vec2 b, glm::vec2 c, glm::vec2 d, float& t) -> bool {
+            const double abc = Predicates::Orient2D(a, b, c), abd = Predicates::Orient2D(a, b, d);
+            if (abc == 0.0 && abd == 0.0) return false; // collinear, the ends cover it
+            if ((abc > 0.0 && abd > 0.0) || (abc < 0.0 && abd < 0.0)) return false;
+            const double cda = Predicates::Orient2D(c, d, a), cdb = Predicates::Orient2D(c, d, b);
+            if ((cda > 0.0 && cdb > 0.0) || (cda < 0.0 && cdb < 0.0)) return false;
+            t = static_cast<float>(cda / (cda - cdb));
+            return true;
             };
 
-        glm::vec2 segVec = segB - segA;
         std::vector<glm::vec2> triEdges[3] = {
             {tri0, tri1},
             {tri1, tri2},
@@ -167,9 +190,9 @@ bool LineIntersectsTriangle2(
         };
 
         for (auto& edge : triEdges) {
-            glm::vec2 ip;
-            if (SegmentIntersect(segA, segVec, edge[0], edge[1] - edge[0], ip)) {
-                glm::vec3 full = p0 + dir * glm::length(ip - segA) / glm::length(segVec);
+            float t;
+            if (SegmentIntersect(segA, segB, edge[0], edge[1], t)) {
+                glm::vec3 full = p0 + dir * t;
                 insidePoints.push_back(full);
             }
         }
@@ -190,20 +213,9 @@ bool LineIntersectsTriangle2(
         return false;
     }
 
-    // Not coplanar – use Möller–Trumbore for intersection point
-    const glm::vec3 h = glm::cross(dir, e2);
-    const float a = glm::dot(e1, h);
-    const float f = 1.0f / a;
-    const glm::vec3 s = p0 - v0;
-    const float u = f * glm::dot(s, h);
-    if (u < 0.0f || u > 1.0f) return false;
-
-    const glm::vec3 q = glm::cross(s, e1);
-    const float v = f * glm::dot(dir, q);
-    if (v < 0.0f || u + v > 1.0f) return false;
-
-    const float t = f * glm::dot(e2, q);
-    if (t < 0.0f || t > 1.0f) return false;
+    // Not coplanar
+    float t;
+    if (!SegmentCrossesTriangle(p0, p1, v0, v1, v2, t)) return false;
 
     intersectionStart = p0 + t * dir;
     intersectionEnd = intersectionStart;
@@ -219,104 +231,21 @@ glm::vec3 CalculateCentroid(const std::vector<glm::vec3>& points) {
     return centroid / static_cast<float>(points.size());
 }
 
-// Function to calculate the angle between the point and the centroid
-float AngleBetweenPoints(const glm::vec3& point, const glm::vec3& centroid) {
-    glm::vec2 diff = glm::vec2(point.x - centroid.x, point.y - centroid.y);
-    return std::atan2(diff.y, diff.x); // Use atan2 to get angle in 2D
-}
-
-// Sort the points by angle relative to the centroid
-void SortPointsByAngle(std::vector<glm::vec3>& points) {
-    glm::vec3 centroid = CalculateCentroid(points);
-    if (points.size() < 3)
-        return;
-    // Sort the points based on their angle relative to the centroid
-    std::sort(points.begin(), points.end(), [&centroid](const glm::vec3& a, const glm::vec3& b) {
-        return AngleBetweenPoints(a, centroid) < AngleBetweenPoints(b, centroid);
-        });
-    points.push_back(centroid);
-}
-
-void SortPointsOnPlaneByAngle(std::vector<glm::vec3>& points, const glm::vec3& normal) {
-    glm::vec3 centroid = CalculateCentroid(points);
-
-    // Create a 2D basis on the plane
-    glm::vec3 refAxis = glm::normalize(glm::cross(normal, glm::vec3(0, 1, 0)));
-    if (glm::length(refAxis) < 0.01f)
-        refAxis = glm::normalize(glm::cross(normal, glm::vec3(1, 0, 0)));
-    glm::vec3 upAxis = glm::normalize(glm::cross(normal, refAxis));
-
-    std::sort(points.begin(), points.end(), [&](const glm::vec3& a, const glm::vec3& b) {
-        glm::vec3 da = a - centroid;
-        glm::vec3 db = b - centroid;
-
-        float angleA = atan2(glm::dot(da, upAxis), glm::dot(da, refAxis));
-        float angleB = atan2(glm::dot(db, upAxis), glm::dot(db, refAxis));
-
-        return angleA < angleB;
-        });
-}
-
 ////////////////////////////////
-void Shapes::ExtractUniquePositionsAndIndices(const Mesh& mesh, std::vector<glm::vec3>& outPositions, std::vector<unsigned int>& outIndices)
+void Shapes::ExtractUniquePositionsAndIndices(const MeshData& mesh, std::vector<glm::vec3>& outPositions, std::vector<unsigned int>& outIndices)
 {
-    std::unordered_map<glm::vec3, unsigned int, Vec3Hash, Vec3Equal> positionToIndex;
-    outPositions.clear();
-    outIndices.clear();
-
-    for (size_t i = 0; i < mesh.indices.size(); ++i) {
-        unsigned int originalIndex = mesh.indices[i];
-        glm::vec3 position(
-            mesh.vertices[originalIndex * 9 + 0],
-            mesh.vertices[originalIndex * 9 + 1],
-            mesh.vertices[originalIndex * 9 + 2]
-        );
-
-        if (positionToIndex.count(position) == 0) {
-            // New unique position
-            unsigned int newIndex = static_cast<unsigned int>(outPositions.size());
-            outPositions.push_back(position);
-            positionToIndex[position] = newIndex;
-        }
-
-        outIndices.push_back(positionToIndex[position]);
-    }
+    VertexWelder::Weld(mesh.positions, mesh.indices, VertexWelder::DefaultTolerance, outPositions, outIndices, 0);
 }
 
-void Shapes::ExtractUniquePositionsAndIndicesWorld(const Mesh& mesh, std::vector<glm::vec3>& outPositions, std::vector<unsigned int>& outIndices, const glm::mat4& model)
+void Shapes::ExtractUniquePositionsAndIndicesWorld(const MeshData& mesh, std::vector<glm::vec3>& outPositions, std::vector<unsigned int>& outIndices, const glm::mat4& model)
 {
-    std::unordered_map<glm::vec3, unsigned int, Vec3Hash, Vec3Equal> positionToIndex;
-    outPositions.clear();
-    outIndices.clear();
-
-    for (size_t i = 0; i < mesh.indices.size(); ++i) {
-        unsigned int originalIndex = mesh.indices[i];
-
-        glm::vec3 localPosition(
-            mesh.vertices[originalIndex * 9 + 0],
-            mesh.vertices[originalIndex * 9 + 1],
-            mesh.vertices[originalIndex * 9 + 2]
-        );
-
-        glm::vec3 worldPosition = glm::vec3(model * glm::vec4(localPosition, 1.0f));
-
-        auto it = positionToIndex.find(worldPosition);
-        if (it == positionToIndex.end()) {
-            // New unique position
-            unsigned int newIndex = static_cast<unsigned int>(outPositions.size());
-            outPositions.push_back(worldPosition);
-            positionToIndex[worldPosition] = newIndex;
-            outIndices.push_back(newIndex);
-        }
-        else {
-            outIndices.push_back(it->second);
-        }
-    }
+    const std::vector<glm::vec3>& worldPositions = TransformCache::GetWorldPositions(mesh, model);
+    VertexWelder::Weld(worldPositions, mesh.indices, VertexWelder::DefaultTolerance, outPositions, outIndices, 0);
 }
 
 
-Mesh Shapes::CreateSphere(float radius, unsigned int sectorCount, unsigned int stackCount, glm::vec3 color) {
-    std::vector<float> vertices;
+MeshData Shapes::CreateSphere(float radius, unsigned int sectorCount, unsigned int stackCount, glm::vec3 color) {
+    std::vector<glm::vec3> positions, normals, colors;
     std::vector<unsigned int> indices;
     sectorCount -= 1;
     stackCount -= 1;
@@ -331,20 +260,13 @@ Mesh Shapes::CreateSphere(float radius, unsigned int sectorCount, unsigned int s
             float y = xy * sinf(sectorAngle);
 
             // Vertex position
-            vertices.push_back(x);
-            vertices.push_back(y);
-            vertices.push_back(z);
+            positions.push_back(glm::vec3(x, y, z));
 
             // Normalized normal (for a sphere centered at origin, normal = position normalized)
-            glm::vec3 normal = glm::normalize(glm::vec3(x, y, z));
-            vertices.push_back(normal.x);
-            vertices.push_back(normal.y);
-            vertices.push_back(normal.z);
+            normals.push_back(glm::normalize(glm::vec3(x, y, z)));
 
             // Vertex color
-            vertices.push_back(color.r);
-            vertices.push_back(color.g);
-            vertices.push_back(color.b);
+            colors.push_back(color);
         }
     }
 
@@ -368,11 +290,11 @@ Mesh Shapes::CreateSphere(float radius, unsigned int sectorCount, unsigned int s
         }
     }
 
-    return OpenGLDataInitialize(vertices, indices);
+    return BuildMesh(std::move(positions), std::move(normals), std::move(colors), std::move(indices));
 }
 
-Mesh Shapes::CreateBox(float width, float height, float length, glm::vec3 color) {
-    std::vector<float> vertices;
+MeshData Shapes::CreateBox(float width, float height, float length, glm::vec3 color) {
+    std::vector<glm::vec3> positions, normals, colors;
     std::vector<unsigned int> indices;
 
     float w = width / 2.0f;
@@ -411,30 +333,19 @@ Mesh Shapes::CreateBox(float width, float height, float length, glm::vec3 color)
 
         std::vector<glm::vec3> corners = { face.v0, face.v1, face.v2, face.v3 };
         for (const auto& v : corners) {
-            // Position
-            vertices.push_back(v.x);
-            vertices.push_back(v.y);
-            vertices.push_back(v.z);
-
-            // Normal
-            vertices.push_back(face.normal.x);
-            vertices.push_back(face.normal.y);
-            vertices.push_back(face.normal.z);
-
-            // Color
-            vertices.push_back(color.r);
-            vertices.push_back(color.g);
-            vertices.push_back(color.b);
+            positions.push_back(v);
+            normals.push_back(face.normal);
+            colors.push_back(color);
         }
 
         index += 4;
     }
 
-    return OpenGLDataInitialize(vertices, indices);
+    return BuildMesh(std::move(positions), std::move(normals), std::move(colors), std::move(indices));
 }
 
-Mesh Shapes::CreateCylinder(float radius, float height, unsigned int sectorCount, glm::vec3 color) {
-    std::vector<float> vertices;
+MeshData Shapes::CreateCylinder(float radius, float height, unsigned int sectorCount, glm::vec3 color) {
+    std::vector<glm::vec3> positions, normals, colors;
     std::vector<unsigned int> indices;
 
     float halfHeight = height / 2.0f;
@@ -448,18 +359,14 @@ Mesh Shapes::CreateCylinder(float radius, float height, unsigned int sectorCount
         glm::vec3 normal = glm::normalize(glm::vec3(x, y, 0.0f));
 
         // Bottom vertex
-        vertices.insert(vertices.end(), {
-            radius * x, radius * y, -halfHeight,
-            normal.x, normal.y, normal.z,
-            color.r, color.g, color.b
-            });
+        positions.push_back(glm::vec3(radius * x, radius * y, -halfHeight));
+        normals.push_back(normal);
+        colors.push_back(color);
 
         // Top vertex
-        vertices.insert(vertices.end(), {
-            radius * x, radius * y, halfHeight,
-            normal.x, normal.y, normal.z,
-            color.r, color.g, color.b
-            });
+        positions.push_back(glm::vec3(radius * x, radius * y, halfHeight));
+        normals.push_back(normal);
+        colors.push_back(color);
     }
 
     // Side indices (CCW winding from outside view)
@@ -477,16 +384,15 @@ Mesh Shapes::CreateCylinder(float radius, float height, unsigned int sectorCount
     }
 
     // Add center vertices for caps
-    unsigned int baseIndex = static_cast<unsigned int>(vertices.size() / 9); // each vertex = 9 floats
+    unsigned int baseIndex = static_cast<unsigned int>(positions.size());
     unsigned int bottomCenterIndex = baseIndex;
     unsigned int topCenterIndex = baseIndex + 1;
 
     glm::vec3 bottomNormal(0, 0, -1), topNormal(0, 0, 1);
 
-    vertices.insert(vertices.end(), {
-        0.0f, 0.0f, -halfHeight, bottomNormal.x, bottomNormal.y, bottomNormal.z, color.r, color.g, color.b,
-        0.0f, 0.0f,  halfHeight, topNormal.x,    topNormal.y,    topNormal.z,    color.r, color.g, color.b
-        });
+    positions.insert(positions.end(), { glm::vec3(0.0f, 0.0f, -halfHeight), glm::vec3(0.0f, 0.0f, halfHeight) });
+    normals.insert(normals.end(), { bottomNormal, topNormal });
+    colors.insert(colors.end(), { color, color });
 
     // Bottom + top caps
     for (unsigned int i = 0; i < sectorCount; ++i) {
@@ -497,22 +403,20 @@ Mesh Shapes::CreateCylinder(float radius, float height, unsigned int sectorCount
         float x1 = cos(nextAngle), y1 = sin(nextAngle);
 
         // Bottom triangle (CCW from bottom view)
-        unsigned int i0 = static_cast<unsigned int>(vertices.size() / 9);
-        vertices.insert(vertices.end(), {
-            radius * x1, radius * y1, -halfHeight, bottomNormal.x, bottomNormal.y, bottomNormal.z, color.r, color.g, color.b,
-            radius * x0, radius * y0, -halfHeight, bottomNormal.x, bottomNormal.y, bottomNormal.z, color.r, color.g, color.b
-            });
+        unsigned int i0 = static_cast<unsigned int>(positions.size());
+        positions.insert(positions.end(), { glm::vec3(radius * x1, radius * y1, -halfHeight), glm::vec3(radius * x0, radius * y0, -halfHeight) });
+        normals.insert(normals.end(), { bottomNormal, bottomNormal });
+        colors.insert(colors.end(), { color, color });
 
         indices.insert(indices.end(), {
             bottomCenterIndex, i0, i0 + 1
             });
 
         // Top triangle (CCW from top view)
-        unsigned int i1 = static_cast<unsigned int>(vertices.size() / 9);
-        vertices.insert(vertices.end(), {
-            radius * x0, radius * y0, halfHeight, topNormal.x, topNormal.y, topNormal.z, color.r, color.g, color.b,
-            radius * x1, radius * y1, halfHeight, topNormal.x, topNormal.y, topNormal.z, color.r, color.g, color.b
-            });
+        unsigned int i1 = static_cast<unsigned int>(positions.size());
+        positions.insert(positions.end(), { glm::vec3(radius * x0, radius * y0, halfHeight), glm::vec3(radius * x1, radius * y1, halfHeight) });
+        normals.insert(normals.end(), { topNormal, topNormal });
+        colors.insert(colors.end(), { color, color });
 
         indices.insert(indices.end(), {
             topCenterIndex, i1, i1 + 1
@@ -520,76 +424,31 @@ Mesh Shapes::CreateCylinder(float radius, float height, unsigned int sectorCount
     }
 
 
-    return OpenGLDataInitialize(vertices, indices);
+    return BuildMesh(std::move(positions), std::move(normals), std::move(colors), std::move(indices));
 }
 
-Mesh Shapes::FaceToMesh(Face& face, glm::vec3 color) {
-    Mesh mesh;
-    std::vector<float> vertices;
-
-    // Add the 4 vertices of the face, along with their normals and colors
-    for (const auto& v : face.facePoints) {
-        // Position
-        vertices.push_back(v.x);
-        vertices.push_back(v.y);
-        vertices.push_back(v.z);
-
-        // Normal (same for all vertices of this face)
-        vertices.push_back(face.normal.x);
-        vertices.push_back(face.normal.y);
-        vertices.push_back(face.normal.z);
-
-        // Color
-        vertices.push_back(color.r);
-        vertices.push_back(color.g);
-        vertices.push_back(color.b);
-    }
+MeshData Shapes::FaceToMesh(const Face& face, glm::vec3 color) {
+    std::vector<glm::vec3> positions = face.facePoints;
+    // Normal (same for all vertices of this face)
+    std::vector<glm::vec3> normals(positions.size(), face.normal);
+    std::vector<glm::vec3> colors(positions.size(), color);
+    std::vector<unsigned int> indices = face.indeces;
 
-    // Initialize OpenGL buffers and return the Mesh
-    return OpenGLDataInitialize(vertices, face.indeces);
+    return BuildMesh(std::move(positions), std::move(normals), std::move(colors), std::move(indices));
 }
 
-Mesh Shapes::OpenGLDataInitialize(std::vector<float>& vertices, std::vector<unsigned int>& indices)
+MeshData Shapes::BuildMesh(std::vector<glm::vec3>&& positions, std::vector<glm::vec3>&& normals, std::vector<glm::vec3>&& colors, std::vector<unsigned int>&& indices)
 {
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_BACK);
-    glFrontFace(GL_CCW);
-
-    // OpenGL buffer setup
-    GLuint VAO, VBO, EBO;
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
-
-    glBindVertexArray(VAO);
-
-    // VBO
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_DYNAMIC_DRAW);
-
-    // EBO
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_DYNAMIC_DRAW);
-
-    // Position: location = 0
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-
-    // Normal: location = 1
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    // Color: location = 2
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
-
-    glBindVertexArray(0); // Unbind
-
-    return { VAO, VBO, EBO, static_cast<GLsizei>(indices.size()),vertices,indices };
+    MeshData mesh;
+    mesh.positions = std::move(positions);
+    mesh.normals = std::move(normals);
+    mesh.colors = std::move(colors);
+    mesh.indices = std::move(indices);
+    return mesh;
 }
 
 void Shapes::ProjectOntoAxis(
-    const std::vector<float>& vertices,
+    const std::vector<glm::vec3>& positions,
     const glm::vec3& axis,
     const glm::mat4& modelMatrix,
     float& min,
@@ -597,59 +456,214 @@ void Shapes::ProjectOntoAxis(
 ) {
     min = std::numeric_limits<float>::infinity();
     max = -std::numeric_limits<float>::infinity();
-    for (int i = 0;i < vertices.size() / 9; i++) {
-        glm::vec4 localPos(vertices[i * 9], vertices[i * 9 + 1], vertices[i * 9 + 2], 1.0f);
-        glm::vec3 worldPos = glm::vec3(modelMatrix * localPos);
-        float projection = glm::dot(worldPos, axis);
+    // dot(M * p, axis) == dot(p, M^T * axis) + dot(t, axis): project the
+    // contiguous local positions on a local axis instead of transforming each one
+    const glm::vec3 localAxis = glm::transpose(glm::mat3(modelMatrix)) * axis;
+    const float offset = glm::dot(glm::vec3(modelMatrix[3]), axis);
+    const size_t count = positions.size();
+    const glm::vec3* p = positions.data();
+
+    float localMin = std::numeric_limits<float>::infinity();
+    float localMax = -std::numeric_limits<float>::infinity();
+    for (size_t i = 0; i < count; i++) {
+        float projection = p[i].x * localAxis.x + p[i].y * localAxis.y + p[i].z * localAxis.z;
+        localMin = std::min(localMin, projection);
+        localMax = std::max(localMax, projection);
+    }
 
-        min = std::min(min, projection);
-        max = std::max(max, projection);
+    if (count > 0) {
+        min = localMin + offset;
+        max = localMax + offset;
     }
 }
 
 bool Shapes::AreMeshesIntersectingSAT(
-    const Mesh& meshA, const glm::mat4& modelA,
-    const Mesh& meshB, const glm::mat4& modelB
+    const MeshData& meshA, const glm::mat4& modelA,
+    const MeshData& meshB, const glm::mat4& modelB,
+    glm::vec3* outSeparatingAxis
 ) {
-    const std::vector<glm::vec3>& faceNormalsA = CalculateFaceNormals(meshA, modelA);
-    const std::vector<glm::vec3>& faceNormalsB = CalculateFaceNormals(meshB, modelB);
+    const ConvexShape& shapeA = ConvexShape::ForMesh(meshA);
+    const ConvexShape& shapeB = ConvexShape::ForMesh(meshB);
+    if (shapeA.Empty() || shapeB.Empty())
+        return false;
 
-    std::vector<glm::vec3> axes = faceNormalsA;
-    axes.insert(axes.end(), faceNormalsB.begin(), faceNormalsB.end());
+    const glm::mat3 linearA(modelA), linearB(modelB);
+    const glm::vec3 translationA(modelA[3]), translationB(modelB[3]);
+
+    // Tests the axes of `own` against `other`. A local face normal n maps to the
+    // world axis N = normalize(M^-T n), along which own's extent is its cached
+    // local extent scaled by 1/|M^-T n|; other's extent comes from support queries.
+    auto separatedOnAxesOf = [outSeparatingAxis](const ConvexShape& own, const glm::mat3& linearOwn, const glm::vec3& translationOwn,
+        const ConvexShape& other, const glm::mat4& modelOther) {
+        const glm::mat3 inverseOwn = glm::inverse(linearOwn);
+        const glm::mat3 normalMatrix = glm::transpose(inverseOwn);
+        const glm::mat3 linearOther(modelOther);
+        const glm::vec3 translationOther(modelOther[3]);
+
+        // Disjoint operands are usually separated by the face facing the other
+        // centroid, so that axis goes first and most rejections take one test
+        glm::vec3 towardOther = inverseOwn * (linearOther * other.center + translationOther - (linearOwn * own.center + translationOwn));
+        size_t firstAxis = 0;
+        float bestAlignment = -1.0f;
+        for (size_t a = 0; a < own.axes.size(); ++a) {
+            float alignment = std::abs(glm::dot(own.axes[a], towardOther));
+            if (alignment > bestAlignment) {
+                bestAlignment = alignment;
+                firstAxis = a;
+            }
+        }
 
+        // Other's hull is projected per axis by warm-started hill climbing. Without one,
+        // axes are queued and projected in batches with the SIMD kernel, on other's
+        // local vertices through local axes M^T N, so nothing is transformed.
+        constexpr size_t BatchSize = 64;
+        glm::vec3 worldAxes[BatchSize], localAxes[BatchSize];
+        float minOwn[BatchSize], maxOwn[BatchSize], minOther[BatchSize], maxOther[BatchSize];
+        size_t pending = 0;
+        unsigned int maxVertex = 0, minVertex = 0;
+        const glm::mat3 worldToOther = glm::transpose(linearOther);
+
+        auto flush = [&]() {
+            if (other.hull) {
+                other.Project(modelOther, worldAxes[0], minOther[0], maxOther[0], minVertex, maxVertex);
+            }
+            else {
+                AxisProjection::Project(other.vertices.data(), other.vertices.size(), localAxes, pending, minOther, maxOther);
+                for (size_t i = 0; i < pending; ++i) {
+                    float offsetOther = glm::dot(worldAxes[i], translationOther);
+                    minOther[i] += offsetOther;
+                    maxOther[i] += offsetOther;
+                }
+            }
+            for (size_t i = 0; i < pending; ++i) {
+                if (maxOwn[i] < minOther[i] || maxOther[i] < minOwn[i]) {
+                    if (outSeparatingAxis)
+                        *outSeparatingAxis = worldAxes[i];
+                    return true; // Separating axis found
+                }
+            }
+            pending = 0;
+            return false;
+        };
+
+        for (size_t k = 0; k <= own.axes.size(); ++k) {
+            // k == 0 is the preferred axis, then every axis in order (skipping it)
+            size_t a = k == 0 ? firstAxis : k - 1;
+            if (k > 0 && a == firstAxis) continue;
+            glm::vec3 worldAxis = normalMatrix * own.axes[a];
+            float length = glm::length(worldAxis);
+            if (length < 1e-6f) continue; // skip tiny vectors
+            float scale = 1.0f / length;
+            worldAxis *= scale;
+
+            float offsetOwn = glm::dot(worldAxis, translationOwn);
+            worldAxes[pending] = worldAxis;
+            localAxes[pending] = worldToOther * worldAxis;
+            minOwn[pending] = own.axisMin[a] * scale + offsetOwn;
+            maxOwn[pending] = own.axisMax[a] * scale + offsetOwn;
+            pending++;
+
+            // The preferred axis is tested alone so an early rejection stays cheap
+            if ((k == 0 || other.hull || pending == BatchSize) && flush())
+                return true;
+        }
+        return pending > 0 && flush();
+    };
+
+    if (separatedOnAxesOf(shapeA, linearA, translationA, shapeB, modelB))
+        return false;
+    if (separatedOnAxesOf(shapeB, linearB, translationB, shapeA, modelA))
+        return false;
 
     // Optional: Add edge cross-products if using polyhedra like cylinders and boxes
 
-    for (const glm::vec3& axis : axes) {
-        if (glm::length(axis) < 1e-6f) continue; // skip tiny vectors
+    return true; // No separating axis => Intersection
+}
+
+bool Shapes::AreMeshesIntersectingGJK(
+    const MeshData& meshA, const glm::mat4& modelA,
+    const MeshData& meshB, const glm::mat4& modelB,
+    GJKCache* cache, Penetration* outPenetration
+) {
+    const ConvexShape& shapeA = ConvexShape::ForMesh(meshA);
+    const ConvexShape& shapeB = ConvexShape::ForMesh(meshB);
+    if (outPenetration)
+        return GJK::Intersect(shapeA, modelA, shapeB, modelB, *outPenetration, cache);
+    return GJK::Intersect(shapeA, modelA, shapeB, modelB, cache);
+}
 
-        float minA, maxA, minB, maxB;
-        ProjectOntoAxis(meshA.vertices,  axis, modelA, minA, maxA);
-        ProjectOntoAxis(meshB.vertices,  axis, modelB, minB, maxB);
+bool Shapes::AreMeshesIntersecting(
+    const MeshData& meshA, const glm::mat4& modelA,
+    const MeshData& meshB, const glm::mat4& modelB,
+    OverlapTest test, SeparatingAxisCache* cache
+) {
+    const MeshBounds& boundsA = MeshBounds::ForMesh(meshA);
+    const MeshBounds& boundsB = MeshBounds::ForMesh(meshB);
+    if (boundsA.empty || boundsB.empty)
+        return false;
 
+    // Tier 0: last query's separating axis, four warm-started support lookups
+    if (cache && cache->axis != glm::vec3(0.0f)) {
+        float minA, maxA, minB, maxB;
+        ConvexShape::ForMesh(meshA).Project(modelA, cache->axis, minA, maxA, cache->hintsA[0], cache->hintsA[1]);
+        ConvexShape::ForMesh(meshB).Project(modelB, cache->axis, minB, maxB, cache->hintsB[0], cache->hintsB[1]);
         if (maxA < minB || maxB < minA) {
-            return false; // Separating axis found
+            cache->axisHits++;
+            return false;
         }
+        cache->axisMisses++;
     }
 
-    return true; // No separating axis => Intersection
+    glm::vec3 separatingAxis(0.0f);
+    bool intersecting = true;
+    if (!boundsA.WorldAABB(modelA).Overlaps(boundsB.WorldAABB(modelB), &separatingAxis)) {
+        // Tier 1: world AABBs, a few dozen flops
+        intersecting = false;
+    }
+    else if (!OBB::Overlap(boundsA.WorldOBB(modelA), boundsB.WorldOBB(modelB), &separatingAxis)) {
+        // Tier 2: fitted boxes, which reject rotated and elongated operands the AABBs cannot
+        intersecting = false;
+    }
+    else if (test == OverlapTest::GJK) {
+        // Tier 3: the full convex test. GJK stops on a direction that separates the pair.
+        GJKCache localCache;
+        GJKCache& gjk = cache ? cache->gjk : localCache;
+        intersecting = AreMeshesIntersectingGJK(meshA, modelA, meshB, modelB, &gjk);
+        if (!intersecting && glm::dot(gjk.direction, gjk.direction) > 0.0f)
+            separatingAxis = glm::normalize(gjk.direction);
+    }
+    else {
+        intersecting = AreMeshesIntersectingSAT(meshA, modelA, meshB, modelB, &separatingAxis);
+    }
+
+    if (cache)
+        cache->axis = intersecting ? glm::vec3(0.0f) : separatingAxis;
+    return intersecting;
+}
+
+std::vector<BroadphasePair> Shapes::FindIntersectingPairs(SweepAndPrune& scene, OverlapTest test) {
+    std::vector<BroadphasePair> intersecting;
+    for (const BroadphasePair& pair : scene.FindPairs()) {
+        const MeshData* meshA = scene.Mesh(pair.bodyA);
+        const MeshData* meshB = scene.Mesh(pair.bodyB);
+        // Bodies registered by bounds alone have nothing to test further
+        if (!meshA || !meshB)
+            continue;
+        if (AreMeshesIntersecting(*meshA, scene.Model(pair.bodyA), *meshB, scene.Model(pair.bodyB), test))
+            intersecting.push_back(pair);
+    }
+    return intersecting;
 }
 
-std::vector<glm::vec3> Shapes::CalculateFaceNormals(const Mesh& mesh, const glm::mat4& modelMatrix) {
+std::vector<glm::vec3> Shapes::CalculateFaceNormals(const MeshData& mesh, const glm::mat4& modelMatrix) {
     std::vector<glm::vec3> normals;
+    normals.reserve(mesh.indices.size() / 3);
+    const std::vector<glm::vec3>& worldPositions = TransformCache::GetWorldPositions(mesh, modelMatrix);
 
     for (size_t i = 0; i < mesh.indices.size(); i += 3) {
-        unsigned int idx0 = mesh.indices[i];
-        unsigned int idx1 = mesh.indices[i + 1];
-        unsigned int idx2 = mesh.indices[i + 2];
-
-        glm::vec4 p0(mesh.vertices[idx0 * 9], mesh.vertices[idx0 * 9 + 1], mesh.vertices[idx0 * 9 + 2], 1.0f);
-        glm::vec4 p1(mesh.vertices[idx1 * 9], mesh.vertices[idx1 * 9 + 1], mesh.vertices[idx1 * 9 + 2], 1.0f);
-        glm::vec4 p2(mesh.vertices[idx2 * 9], mesh.vertices[idx2 * 9 + 1], mesh.vertices[idx2 * 9 + 2], 1.0f);
-
-        glm::vec3 v0 = glm::vec3(modelMatrix * p0);
-        glm::vec3 v1 = glm::vec3(modelMatrix * p1);
-        glm::vec3 v2 = glm::vec3(modelMatrix * p2);
+        const glm::vec3& v0 = worldPositions[mesh.indices[i]];
+        const glm::vec3& v1 = worldPositions[mesh.indices[i + 1]];
+        const glm::vec3& v2 = worldPositions[mesh.indices[i + 2]];
 
         glm::vec3 edge1 = v1 - v0;
         glm::vec3 edge2 = v2 - v0;
@@ -677,13 +691,8 @@ bool Shapes::IsPointInsideConvexMesh(const glm::vec3& point,
         glm::vec3 v1 = vertexPositions[idx1];
         glm::vec3 v2 = vertexPositions[idx2];
 
-        // Compute face normal
-        glm::vec3 normal = glm::normalize(glm::cross(v1 - v0, v2 - v0));
-
-        // Check point against the face plane
-        float dotProduct = glm::dot(normal, point - v0);
-
-        if (dotProduct > 0.0f) {
+        // Check point against the face plane, exactly
+        if (Predicates::Orient3D(v0, v1, v2, point) > 0.0) {
             return false; // Point is outside this face
         }
     }
@@ -710,21 +719,43 @@ std::vector<unsigned int> Shapes::GetConnectedVertices(const std::vector<unsigne
     return std::vector<unsigned int>(connectedVertices.begin(), connectedVertices.end());
 }
 
-std::vector<unsigned int> Shapes::GetVertexesWithinMesh(const Mesh& meshA, const glm::mat4& modelMatrixA, const Mesh& meshB, const glm::mat4& modelMatrixB)
+void Shapes::ClassifyPoints(const std::vector<glm::vec3>& points, const glm::mat4& pointsModel,
+    const MeshData& mesh, const glm::mat4& meshModel, std::vector<unsigned char>& outInside)
+{
+    // Classify in the mesh's local space against its cached tables; containment
+    // does not change under the mesh's model matrix
+    std::vector<glm::vec3> localPoints;
+    TransformCache::TransformPositions(points, glm::inverse(meshModel) * pointsModel, localPoints);
+    outInside.resize(localPoints.size());
+    if (ConvexShape::ForMesh(mesh).convex)
+        PlaneTable::ForMesh(mesh).Classify(localPoints.data(), localPoints.size(), outInside.data());
+    else
+        WindingNumber::ForMesh(mesh).Classify(localPoints.data(), localPoints.size(), outInside.data());
+}
+
+std::vector<unsigned int> Shapes::GetVertexesWithinMesh(const MeshData& meshA, const glm::mat4& modelMatrixA, const MeshData& meshB, const glm::mat4& modelMatrixB)
 {
     std::vector<unsigned int> pointsWithin;
     std::vector<glm::vec3> vertexPositionA;
-    std::vector<glm::vec3> vertexPositionB;
     std::vector<unsigned int> IndicesA;
-    std::vector<unsigned int> IndicesB;
 
     ExtractUniquePositionsAndIndices(meshA, vertexPositionA, IndicesA);
-    ExtractUniquePositionsAndIndices(meshB, vertexPositionB, IndicesB);
 
-    //firstMeshPoints = true;
-    for (int i = 0;i < vertexPositionA.size();i++) {
-        glm::vec3 worldV0 = glm::vec3(modelMatrixA * glm::vec4(vertexPositionA[i], 1.0f));
-        if (IsPointInsideConvexMesh(worldV0, vertexPositionB, IndicesB)) {
+    // A's triangles near B's surface, from both cached BVHs, bound the patches
+    std::vector<unsigned char> barrierA(IndicesA.size() / 3, 0);
+    const BVH& bvhA = BVH::ForMesh(meshA);
+    const BVH& bvhB = BVH::ForMesh(meshB);
+    if (!bvhA.Empty() && !bvhB.Empty()) {
+        BVH::FindOverlappingPairs(bvhA, bvhB, glm::inverse(modelMatrixA) * modelMatrixB,
+            [&](const TrianglePair* pairs, size_t count) {
+                for (size_t i = 0; i < count; ++i)
+                    barrierA[pairs[i].triangleA] = 1;
+            }, bvhA.QueryMargin() + bvhB.QueryMargin());
+    }
+    std::vector<unsigned char> inside = ClassifyVerticesByPatch(vertexPositionA, IndicesA, modelMatrixA, barrierA, meshB, modelMatrixB);
+
+    for (unsigned int i = 0; i < inside.size(); i++) {
+        if (inside[i]) {
             pointsWithin.push_back(i);
         }
     }
@@ -735,39 +766,45 @@ std::vector<unsigned int> Shapes::GetVertexesWithinMesh(const Mesh& meshA, const
 std::vector<glm::vec3> Shapes::GetVertexesWithinMesh2(const std::vector<glm::vec3>& vertexPositionA,
     const std::vector<glm::vec3>& vertexPositionB,
     const std::vector<unsigned int>& IndicesA,
-    const std::vector<unsigned int> IndicesB)
+    const std::vector<unsigned int> IndicesB,
+    float tolerance)
 {
-    std::vector<glm::vec3> pointsWithin;
+    // Duplicate points (within tolerance) are dropped as they are found
+    VertexWelder uniquePoints(tolerance);
+
+    // B's face planes once, instead of once per point of A
+    PlaneTable planesB;
+    planesB.Build(vertexPositionB, IndicesB);
+    std::vector<unsigned char> inside(vertexPositionA.size());
+    planesB.Classify(vertexPositionA.data(), vertexPositionA.size(), inside.data());
 
     for (int i = 0;i < vertexPositionA.size();i++) {
-        if (IsPointInsideConvexMesh(vertexPositionA[i], vertexPositionB, IndicesB)) {
-            pointsWithin.push_back(vertexPositionA[i]);
-        }
-    }
-    const float tolerance = 0.001f;  // Define a small tolerance for duplicate points
-    std::vector<glm::vec3> uniquePoints;
-
-    for (const auto& point : pointsWithin) {
-        bool isDuplicate = false;
-        for (const auto& uniquePoint : uniquePoints) {
-            if (glm::length(point - uniquePoint) < tolerance) {
-                isDuplicate = true;
-                break;
-            }
-        }
-        if (!isDuplicate) {
-            uniquePoints.push_back(point);
+        if (inside[i]) {
+            uniquePoints.Insert(vertexPositionA[i]);
         }
     }
 
-    pointsWithin = uniquePoints;
+    return uniquePoints.Points();
+}
 
-    return pointsWithin;
+std::vector<glm::vec3> Shapes::GetVertexesWithinMesh2(const std::vector<glm::vec3>& vertexPositionA,
+    const MeshData& meshB, const glm::mat4& modelMatrixB, float tolerance)
+{
+    VertexWelder uniquePoints(tolerance);
+    std::vector<unsigned char> inside;
+    ClassifyPoints(vertexPositionA, glm::mat4(1.0f), meshB, modelMatrixB, inside);
+    for (size_t i = 0; i < vertexPositionA.size(); i++) {
+        if (inside[i]) {
+            uniquePoints.Insert(vertexPositionA[i]);
+        }
+    }
+    return uniquePoints.Points();
 }
 
-std::vector<glm::vec3> Shapes::GetIntersectionPoints(const Mesh& meshA, const glm::mat4& modelMatrixA, const Mesh& meshB, const glm::mat4& modelMatrixB, bool firstMeshPoints)
+std::vector<glm::vec3> Shapes::GetIntersectionPoints(const MeshData& meshA, const glm::mat4& modelMatrixA, const MeshData& meshB, const glm::mat4& modelMatrixB, bool firstMeshPoints, float tolerance)
 {
-    std::vector<glm::vec3> intersectionPoints;
+    // Duplicate points (within tolerance) are dropped as they are found
+    VertexWelder intersectionPoints(tolerance);
     std::vector<unsigned int> pointsWithinB = GetVertexesWithinMesh(meshA, modelMatrixA, meshB, modelMatrixB);
     std::vector<unsigned int> pointsWithinA = GetVertexesWithinMesh(meshB, modelMatrixB, meshA, modelMatrixA);
     std::vector<glm::vec3> vertexPositionA;
@@ -778,91 +815,73 @@ std::vector<glm::vec3> Shapes::GetIntersectionPoints(const Mesh& meshA, const gl
     ExtractUniquePositionsAndIndices(meshA, vertexPositionA, IndicesA);
     ExtractUniquePositionsAndIndices(meshB, vertexPositionB, IndicesB);
 
-    const float tolerance = 0.001f;  // Define a small tolerance for duplicate points
+    // Transform each operand once instead of once per edge test
+    std::vector<glm::vec3> worldPositionA, worldPositionB;
+    TransformCache::TransformPositions(vertexPositionA, modelMatrixA, worldPositionA);
+    TransformCache::TransformPositions(vertexPositionB, modelMatrixB, worldPositionB);
+    const BVH& bvhA = BVH::ForMesh(meshA);
+    const BVH& bvhB = BVH::ForMesh(meshB);
+
     std::vector<unsigned int> edges;
         for (auto point : pointsWithinB) {
-            intersectionPoints.push_back(glm::vec3(modelMatrixA * glm::vec4(vertexPositionA[point], 1.0f)));
+            intersectionPoints.Insert(worldPositionA[point]);
             edges = GetConnectedVertices(IndicesA, point);
             // For each edge, check for intersection with the other mesh
             for (auto edge : edges) {
                 // Here you would need to check if the edge intersects with any faces of the other mesh
-                glm::vec3 v0 = glm::vec3(modelMatrixA * glm::vec4(vertexPositionA[point], 1.0f));
-                glm::vec3 v1 = glm::vec3(modelMatrixA * glm::vec4(vertexPositionA[edge], 1.0f));
+                const glm::vec3& v0 = worldPositionA[point];
+                const glm::vec3& v1 = worldPositionA[edge];
                 //This needs to be fixed later!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-                glm::vec3 intersection = GetEdgeIntersection(v0, v1, vertexPositionB, IndicesB, modelMatrixB)[0];
+                std::vector<glm::vec3> edgeIntersections = GetEdgeIntersection(v0, v1, worldPositionB, IndicesB, bvhB, modelMatrixB);
+                if (edgeIntersections.empty())
+                    continue;
+                glm::vec3 intersection = edgeIntersections[0];
                 if (glm::length(intersection) > 0.0f) {
-                    bool add = true;
-                    for(auto pointI: intersectionPoints){
-                        if (glm::length(intersection - pointI) < tolerance) {
-                            add = false;
-                            break;
-                        }
-                    }
-                    if (add) {
-                        intersectionPoints.push_back(intersection);
-                    }
+                    intersectionPoints.Insert(intersection);
                 }
             }
         }
         for (auto point : pointsWithinA) {
-            intersectionPoints.push_back(glm::vec3(modelMatrixB * glm::vec4(vertexPositionB[point], 1.0f)));
+            intersectionPoints.Insert(worldPositionB[point]);
             edges = GetConnectedVertices(IndicesB, point);
             for (auto edge : edges) {
-                glm::vec3 v0 = glm::vec3(modelMatrixB * glm::vec4(vertexPositionB[point], 1.0f));
-                glm::vec3 v1 = glm::vec3(modelMatrixB * glm::vec4(vertexPositionB[edge], 1.0f));
+                const glm::vec3& v0 = worldPositionB[point];
+                const glm::vec3& v1 = worldPositionB[edge];
                 //This needs to be fixed later!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-                glm::vec3 intersection = GetEdgeIntersection(v0, v1, vertexPositionA, IndicesA, modelMatrixA)[0];
+                std::vector<glm::vec3> edgeIntersections = GetEdgeIntersection(v0, v1, worldPositionA, IndicesA, bvhA, modelMatrixA);
+                if (edgeIntersections.empty())
+                    continue;
+                glm::vec3 intersection = edgeIntersections[0];
                 if (glm::length(intersection) > 0.0f) {
-                    bool add = true;
-                    for (auto pointI : intersectionPoints) {
-                        if (glm::length(intersection - pointI) < tolerance) {
-                            add = false;
-                            break;
-                        }
-                    }
-                    if (add) {
-                        intersectionPoints.push_back(intersection);
-                    }
+                    intersectionPoints.Insert(intersection);
                 }
             }
         }
 
-    std::vector<glm::vec3> uniquePoints;
-
-    for (const auto& point : intersectionPoints) {
-        bool isDuplicate = false;
-        for (const auto& uniquePoint : uniquePoints) {
-            if (glm::length(point - uniquePoint) < tolerance) {
-                isDuplicate = true;
-                break;
-            }
-        }
-        if (!isDuplicate) {
-            uniquePoints.push_back(point);
-        }
-    }
-
-    intersectionPoints = uniquePoints;  // Update points with unique ones
+    const std::vector<glm::vec3>& uniquePoints = intersectionPoints.Points();
     for (auto& point : uniquePoints) {
         std::cout << glm::to_string(point) << "\n";
     }
-    return intersectionPoints;
+    return uniquePoints;
 }
 
 
 std::vector<glm::vec3> Shapes::GetEdgeIntersection(const glm::vec3& v0, const glm::vec3& v1, const std::vector<glm::vec3>& vertices, const std::vector<unsigned int>& indices, const glm::mat4& modelMatrix)
+{
+    std::vector<glm::vec3> worldVertices;
+    TransformCache::TransformPositions(vertices, modelMatrix, worldVertices);
+    return GetEdgeIntersection(v0, v1, worldVertices, indices);
+}
+
+std::vector<glm::vec3> Shapes::GetEdgeIntersection(const glm::vec3& v0, const glm::vec3& v1, const std::vector<glm::vec3>& worldVertices, const std::vector<unsigned int>& indices)
 {
     std::vector<glm::vec3> intersections;  // To store the intersection points
 
     // Iterate over all triangles in the mesh
     for (size_t i = 0; i < indices.size() / 3; ++i) {
-        unsigned int idx0 = indices[i * 3];
-        unsigned int idx1 = indices[i * 3 + 1];
-        unsigned int idx2 = indices[i * 3 + 2];
-
-        glm::vec3 v2 = glm::vec3(modelMatrix * glm::vec4(vertices[idx0], 1.0f));
-        glm::vec3 v3 = glm::vec3(modelMatrix * glm::vec4(vertices[idx1], 1.0f));
-        glm::vec3 v4 = glm::vec3(modelMatrix * glm::vec4(vertices[idx2], 1.0f));
+        const glm::vec3& v2 = worldVertices[indices[i * 3]];
+        const glm::vec3& v3 = worldVertices[indices[i * 3 + 1]];
+        const glm::vec3& v4 = worldVertices[indices[i * 3 + 2]];
 
         // Check for intersection of the line segment [v0, v1] with the triangle [v2, v3, v4]
         glm::vec3 intersection;
@@ -877,23 +896,77 @@ std::vector<glm::vec3> Shapes::GetEdgeIntersection(const glm::vec3& v0, const gl
     return intersections;
 }
 
+std::vector<glm::vec3> Shapes::GetEdgeIntersection(const glm::vec3& v0, const glm::vec3& v1, const std::vector<glm::vec3>& worldVertices, const std::vector<unsigned int>& indices, const BVH& bvh, const glm::mat4& modelMatrix)
+{
+    std::vector<glm::vec3> intersections;
+    if (bvh.Empty())
+        return intersections;
+
+    // Query in the BVH's space; candidates come back in index order, so the
+    // first two hits match the exhaustive loop above
+    glm::mat4 inverseModel = glm::inverse(modelMatrix);
+    glm::vec3 localV0 = glm::vec3(inverseModel * glm::vec4(v0, 1.0f));
+    glm::vec3 localV1 = glm::vec3(inverseModel * glm::vec4(v1, 1.0f));
+    std::vector<unsigned int> candidates;
+    bvh.QuerySegment(localV0, localV1, candidates, bvh.QueryMargin());
+
+    for (unsigned int triangle : candidates) {
+        glm::vec3 intersection;
+        if (LineIntersectsTriangle(v0, v1, worldVertices[indices[triangle * 3]], worldVertices[indices[triangle * 3 + 1]], worldVertices[indices[triangle * 3 + 2]], intersection)) {
+            intersections.push_back(intersection);
+            if (intersections.size() == 2)
+                break;
+        }
+    }
+    return intersections;
+}
+
 
 
-std::vector<Face> Shapes::GeneratePolygonIntersectionFaces(Mesh& meshA, const glm::mat4& modelMatrixA, const Mesh& meshB, const glm::mat4& modelMatrixB)
+std::vector<Face> Shapes::GeneratePolygonIntersectionFaces(const MeshData& meshA, const glm::mat4& modelMatrixA, const MeshData& meshB, const glm::mat4& modelMatrixB, float tolerance)
 {
     std::vector<glm::vec3> vertexPositionA;
     std::vector<glm::vec3> vertexPositionB;
     std::vector<unsigned int> IndicesA;
     std::vector<unsigned int> IndicesB;
-    const float tolerance = 0.00001f;  // Define a small tolerance for duplicate points
     ExtractUniquePositionsAndIndicesWorld(meshA, vertexPositionA, IndicesA, modelMatrixA);
     ExtractUniquePositionsAndIndicesWorld(meshB, vertexPositionB, IndicesB, modelMatrixB);;
-    std::vector<glm::vec3> pointsWithinB = GetVertexesWithinMesh2(vertexPositionA, vertexPositionB, IndicesA, IndicesB);
-    std::vector<glm::vec3> pointsWithinA = GetVertexesWithinMesh2(vertexPositionB, vertexPositionA, IndicesB, IndicesA);
-    //BuildVertexBufferFromPositionsAndIndices(vertexPositionA, IndicesA, meshA.vertices, glm::vec3(0.0f, 1.0f, 0.0f));
+    //BuildVertexNormalsFromPositionsAndIndices(vertexPositionA, IndicesA, meshA.normals);
     std::vector<Face> faces;
 
-    bool intersect;
+    // Overlapping (A, B) triangle pairs from both cached BVHs, grouped per B
+    // triangle with A ascending, so each face sees its candidates in index order
+    const BVH& bvhA = BVH::ForMesh(meshA);
+    const BVH& bvhB = BVH::ForMesh(meshB);
+    std::vector<TrianglePair> pairs;
+    if (!bvhA.Empty() && !bvhB.Empty()) {
+        pairs = BVH::FindOverlappingPairs(bvhA, bvhB, glm::inverse(modelMatrixA) * modelMatrixB,
+            bvhA.QueryMargin() + bvhB.QueryMargin());
+    }
+
+    // B's vertices inside A, classified per patch: the paired triangles are the
+    // only ones A's surface can reach
+    std::vector<unsigned char> barrierB(IndicesB.size() / 3, 0);
+    for (const TrianglePair& pair : pairs)
+        barrierB[pair.triangleB] = 1;
+    const glm::mat4 identity(1.0f);
+    std::vector<unsigned char> insideA = ClassifyVerticesByPatch(vertexPositionB, IndicesB, identity, barrierB, meshA, modelMatrixA);
+    std::vector<TriangleSegment> segments;
+    TriangleIntersection::IntersectPairs(vertexPositionA, IndicesA, vertexPositionB, IndicesB, pairs.data(), pairs.size(), segments);
+    size_t nextSegment = 0;
+
+    // The intersection curves with their endpoints welded; each B triangle takes
+    // its segments from the graph as constraints of a constrained Delaunay split
+    VertexWelder curvePoints(tolerance);
+    IntersectionGraph curves;
+    curves.Build(segments, curvePoints, IndicesA.size() / 3, IndicesB.size() / 3);
+    TriangleSplitter splitter;
+    std::vector<unsigned int> trianglePoints, splitTriangles, pointVertex;
+    std::vector<glm::vec3> splitPoints;
+    std::vector<unsigned char> pointEdges, sides;
+    std::vector<TriangleSplitter::Segment> constraints, recovered;
+    std::vector<std::vector<glm::vec3>> polygons;
+
     //for (int i = 0;i < IndicesA.size();i += 3) {
     //    Face face;
     //    glm::vec3 v0 = vertexPositionA[IndicesA[i]];
@@ -951,154 +1024,234 @@ std::vector<Face> Shapes::GeneratePolygonIntersectionFaces(Mesh& meshA, const gl
     //}
 
     for (int i = 0;i < IndicesB.size();i += 3) {
-        Face face;
         glm::vec3 v0 = vertexPositionB[IndicesB[i]];
         glm::vec3 v1 = vertexPositionB[IndicesB[i + 1]];
         glm::vec3 v2 = vertexPositionB[IndicesB[i + 2]];
 
         glm::vec3 normal = glm::normalize(glm::cross(v1 - v0, v2 - v0));
-        face.normal = normal; // You’ll need to add this to your Face struct
-        bool SegmentIntersection;
-        glm::vec3 intersectionA,intersectionB;
-        for (int j = 0;j < IndicesA.size();j += 3) {
-            intersect = LineIntersectsTriangle2(vertexPositionA[IndicesA[j]], vertexPositionA[IndicesA[j + 1]], vertexPositionB[IndicesB[i]], vertexPositionB[IndicesB[i + 1]], vertexPositionB[IndicesB[i + 2]], intersectionA, intersectionB, SegmentIntersection);
-            if (intersect) {
-                if (SegmentIntersection) {
-                    face.facePoints.push_back(intersectionA);
-                    face.facePoints.push_back(intersectionB);
-                }else
-                    face.facePoints.push_back(intersectionA);
+        const glm::vec3 corners[3] = { v0, v1, v2 };
+        const unsigned int triangleB = static_cast<unsigned int>(i / 3);
+        polygons.clear();
+        // Coplanar overlap is a polygon, not a segment: B's triangle clipped to each coplanar A triangle
+        for (; nextSegment < segments.size() && segments[nextSegment].triangleB == triangleB; ++nextSegment) {
+            const TriangleSegment& segment = segments[nextSegment];
+            if (!segment.coplanar)
+                continue;
+            size_t j = size_t(segment.triangleA) * 3;
+            const glm::vec3 clip[3] = { vertexPositionA[IndicesA[j]], vertexPositionA[IndicesA[j + 1]], vertexPositionA[IndicesA[j + 2]] };
+            polygons.emplace_back();
+            ClipTriangleToTriangle(corners, clip, polygons.back());
+        }
+        if (polygons.empty()) {
+            const auto range = curves.TriangleSegments(1, triangleB);
+            trianglePoints.clear();
+            for (const unsigned int* s = range.first; s != range.second; ++s) {
+                trianglePoints.push_back(curves.segments[*s].start);
+                trianglePoints.push_back(curves.segments[*s].end);
             }
-            intersect = LineIntersectsTriangle2(vertexPositionA[IndicesA[j]], vertexPositionA[IndicesA[j + 2]], vertexPositionB[IndicesB[i]], vertexPositionB[IndicesB[i + 1]], vertexPositionB[IndicesB[i + 2]], intersectionA, intersectionB, SegmentIntersection);
-            if (intersect) {
-                if (SegmentIntersection) {
-                    face.facePoints.push_back(intersectionA);
-                    face.facePoints.push_back(intersectionB);
-                }
-                else
-                    face.facePoints.push_back(intersectionA);
+            std::sort(trianglePoints.begin(), trianglePoints.end());
+            trianglePoints.erase(std::unique(trianglePoints.begin(), trianglePoints.end()), trianglePoints.end());
+            splitPoints.clear();
+            pointEdges.clear();
+            for (unsigned int point : trianglePoints) {
+                splitPoints.push_back(curvePoints.Points()[point]);
+                pointEdges.push_back(TriangleSplitter::EdgeOf(corners, splitPoints.back(), tolerance));
             }
-            intersect = LineIntersectsTriangle2(vertexPositionA[IndicesA[j]], vertexPositionA[IndicesA[j + 1]], vertexPositionB[IndicesB[i]], vertexPositionB[IndicesB[i + 1]], vertexPositionB[IndicesB[i + 2]], intersectionA, intersectionB, SegmentIntersection);
-            if (intersect) {
-                if (SegmentIntersection) {
-                    face.facePoints.push_back(intersectionA);
-                    face.facePoints.push_back(intersectionB);
-                }
-                else
-                    face.facePoints.push_back(intersectionA);
+            auto local = [&](unsigned int point) {
+                return 3 + static_cast<unsigned int>(std::lower_bound(trianglePoints.begin(), trianglePoints.end(), point) - trianglePoints.begin());
+            };
+            constraints.clear();
+            for (const unsigned int* s = range.first; s != range.second; ++s)
+                constraints.push_back({ local(curves.segments[*s].start), local(curves.segments[*s].end) });
+
+            // The curve cuts the triangle into regions that alternate between
+            // inside and outside A; the corners tell which are which
+            splitter.Split(corners, splitPoints, pointEdges, constraints, 0.5f * tolerance, splitTriangles, pointVertex, recovered);
+            const bool cornerInside[3] = { insideA[IndicesB[i]] != 0, insideA[IndicesB[i + 1]] != 0, insideA[IndicesB[i + 2]] != 0 };
+            splitter.LabelBySides(cornerInside, sides);
+            Face face;
+            face.normal = normal;
+            face.facePoints.assign(corners, corners + 3);
+            face.facePoints.insert(face.facePoints.end(), splitPoints.begin(), splitPoints.end());
+            for (size_t t = 0; t < sides.size(); ++t) {
+                if (sides[t])
+                    face.indeces.insert(face.indeces.end(), splitTriangles.begin() + t * 3, splitTriangles.begin() + t * 3 + 3);
             }
+            if (!face.indeces.empty())
+                faces.push_back(std::move(face));
+            continue;
         }
-        /*for (auto& point : pointsWithinB) {
-            if (IsPointInTriangle(point, vertexPositionB[IndicesB[i]], vertexPositionB[IndicesB[i + 1]], vertexPositionB[IndicesB[i + 2]])) {
-                face.facePoints.push_back(point);
-            }
-        }*/
 
-       for (auto& point : pointsWithinA) {
-            if (IsPointInTriangle(point, vertexPositionB[IndicesB[i]], vertexPositionB[IndicesB[i + 1]], vertexPositionB[IndicesB[i + 2]])) {
-                face.facePoints.push_back(point);
-            }
+        // Coplanar overlaps are convex, so a fan around the centroid covers them
+        for (std::vector<glm::vec3>& polygon : polygons) {
+            if (polygon.size() < 3)
+                continue;
+            Face face;
+            face.normal = normal;
+            face.facePoints = std::move(polygon);
+            // The centroid goes last, as the fan center TriangulateConvexPolygon expects
+            const glm::vec3 centroid = CalculateCentroid(face.facePoints);
+            face.facePoints.push_back(centroid);
+            face.indeces = TriangulateConvexPolygon(face.facePoints, face.normal);
+            faces.push_back(face);
         }
+    }
 
-        std::vector<glm::vec3> uniquePoints;
+    return faces;
+}
 
-        for (const auto& point : face.facePoints) {
-            bool isDuplicate = false;
-            for (const auto& uniquePoint : uniquePoints) {
-                if (glm::length(uniquePoint - point) < tolerance) {
-                    isDuplicate = true;
-                    break;
-                }
+// Normals averaged per corner over the faces around its vertex that meet the
+// corner's own face within the crease angle. A vertex whose corners end up with
+// different normals is split, one copy per normal, so sharp edges stay sharp.
+// colors, when per vertex, is split along with the positions.
+static void BuildCreaseNormals(std::vector<glm::vec3>& positions, std::vector<unsigned int>& indices,
+    std::vector<glm::vec3>& colors, float creaseCos, std::vector<glm::vec3>& outNormals)
+{
+    // Step 1: unit face normals, zero for degenerate triangles
+    const size_t triangleCount = indices.size() / 3;
+    std::vector<glm::vec3> faceNormals(triangleCount);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        const glm::vec3& v0 = positions[indices[t * 3]];
+        const glm::vec3 normal = glm::cross(positions[indices[t * 3 + 1]] - v0, positions[indices[t * 3 + 2]] - v0);
+        const float length = glm::length(normal);
+        faceNormals[t] = length > 0.0f ? normal / length : glm::vec3(0.0f);
+    }
+
+    // Step 2: corners around each vertex in CSR form
+    const size_t vertexCount = positions.size();
+    std::vector<unsigned int> offset(vertexCount + 1, 0);
+    for (unsigned int index : indices)
+        offset[index + 1]++;
+    for (size_t v = 0; v < vertexCount; ++v)
+        offset[v + 1] += offset[v];
+    std::vector<unsigned int> cornersOf(indices.size());
+    std::vector<unsigned int> fill(offset.begin(), offset.end() - 1);
+    for (unsigned int k = 0; k < indices.size(); ++k)
+        cornersOf[fill[indices[k]]++] = k;
+
+    // Step 3: each corner's normal; the first distinct normal of a vertex keeps
+    // it, later ones go to appended copies
+    outNormals.assign(vertexCount, glm::vec3(0.0f));
+    std::vector<unsigned int> copies;
+    for (size_t v = 0; v < vertexCount; ++v) {
+        copies.clear();
+        for (unsigned int i = offset[v]; i < offset[v + 1]; ++i) {
+            const glm::vec3& face = faceNormals[cornersOf[i] / 3];
+            glm::vec3 sum(0.0f);
+            for (unsigned int j = offset[v]; j < offset[v + 1]; ++j) {
+                const glm::vec3& neighbour = faceNormals[cornersOf[j] / 3];
+                if (glm::dot(face, neighbour) >= creaseCos)
+                    sum += neighbour;
             }
-            if (!isDuplicate) {
-                uniquePoints.push_back(point);
+            const float length = glm::length(sum);
+            const glm::vec3 normal = length > 0.0f ? sum / length : face;
+            unsigned int vertex = static_cast<unsigned int>(positions.size());
+            for (unsigned int copy : copies) {
+                if (outNormals[copy] == normal)
+                    vertex = copy;
             }
-        }
-
-        SortPointsByAngle(uniquePoints);
-        face.facePoints = uniquePoints;
-        face.indeces = TriangulateConvexPolygon(face.facePoints, face.normal);
-
-        if (face.facePoints.size() > 0) {
-            faces.push_back(face);
-            DebugPrintTriangleNormals(face.facePoints, face.indeces, face.normal);
+            if (vertex == positions.size()) {
+                if (copies.empty()) {
+                    vertex = static_cast<unsigned int>(v);
+                }
+                else {
+                    positions.push_back(positions[v]);
+                    if (colors.size() + 1 == positions.size())
+                        colors.push_back(colors[v]);
+                    outNormals.push_back(glm::vec3(0.0f));
+                }
+                outNormals[vertex] = normal;
+                copies.push_back(vertex);
+            }
+            indices[cornersOf[i]] = vertex;
         }
     }
-
-    return faces;
 }
 
-bool Shapes::LineIntersectsTriangle(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2, glm::vec3& intersection)
+MeshData Shapes::SplitCreases(const MeshData& mesh, float creaseDegrees)
 {
-    const glm::vec3 dir = p1 - p0;
-    const glm::vec3 e1 = v1 - v0;
-    const glm::vec3 e2 = v2 - v0;
+    std::vector<glm::vec3> positions = mesh.positions, normals;
+    std::vector<glm::vec3> colors = mesh.colors.size() == mesh.positions.size() ? mesh.colors : std::vector<glm::vec3>();
+    std::vector<unsigned int> indices = mesh.indices;
+    BuildCreaseNormals(positions, indices, colors, std::cos(glm::radians(creaseDegrees)), normals);
+    return BuildMesh(std::move(positions), std::move(normals), std::move(colors), std::move(indices));
+}
 
-    const glm::vec3 h = glm::cross(dir, e2);
-    const float a = glm::dot(e1, h);
+// Mesh for one selection of a boolean's fragments: the welded result as Select
+// returns it, normals smooth across it, each vertex colored like the operand it came from
+static MeshData BooleanResultMesh(const MeshBoolean& arrangement, BooleanOp op, const MeshData& meshA, const MeshData& meshB)
+{
+    std::vector<glm::vec3> positions, normals, colors;
+    std::vector<unsigned int> indices;
+    std::vector<unsigned char> operand;
+    arrangement.Select(op, positions, indices, operand);
+    BuildVertexNormalsFromPositionsAndIndices(positions, indices, normals);
+    const glm::vec3 operandColors[2] = {
+        meshA.colors.empty() ? glm::vec3(1.0f) : meshA.colors[0],
+        meshB.colors.empty() ? glm::vec3(1.0f) : meshB.colors[0]
+    };
+    colors.reserve(positions.size());
+    for (unsigned char source : operand)
+        colors.push_back(operandColors[source]);
+    return Shapes::BuildMesh(std::move(positions), std::move(normals), std::move(colors), std::move(indices));
+}
 
-    // Parallel check
-    if (fabs(a) < std::numeric_limits<float>::epsilon()) {
-        return false;
-    }
+MeshData Shapes::Boolean(const MeshData& meshA, const glm::mat4& modelA, const MeshData& meshB, const glm::mat4& modelB, BooleanOp op,
+    BooleanArithmetic arithmetic)
+{
+    MeshBoolean arrangement;
+    arrangement.Build(meshA, modelA, meshB, modelB, arithmetic);
+    return BooleanResultMesh(arrangement, op, meshA, meshB);
+}
 
-    const float f = 1.0f / a;
-    const glm::vec3 s = p0 - v0;
-    const float u = f * glm::dot(s, h);
-    if (u < 0.0f || u > 1.0f) {
-        return false;
-    }
+std::array<MeshData, 4> Shapes::BooleanAll(const MeshData& meshA, const glm::mat4& modelA, const MeshData& meshB, const glm::mat4& modelB,
+    BooleanArithmetic arithmetic)
+{
+    MeshBoolean arrangement;
+    arrangement.Build(meshA, modelA, meshB, modelB, arithmetic);
+    return {
+        BooleanResultMesh(arrangement, BooleanOp::Union, meshA, meshB),
+        BooleanResultMesh(arrangement, BooleanOp::Intersection, meshA, meshB),
+        BooleanResultMesh(arrangement, BooleanOp::Difference, meshA, meshB),
+        BooleanResultMesh(arrangement, BooleanOp::SymmetricDifference, meshA, meshB)
+    };
+}
 
-    const glm::vec3 q = glm::cross(s, e1);
-    const float v = f * glm::dot(dir, q);
-    if (v < 0.0f || u + v > 1.0f) {
+bool Shapes::LineIntersectsTriangle(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2, glm::vec3& intersection)
+{
+    float t;
+    if (!SegmentCrossesTriangle(p0, p1, v0, v1, v2, t)) {
         return false;
     }
 
-    const float t = f * glm::dot(e2, q);
-    if (t < 0.0f || t > 1.0f) {
-        return false; // Outside segment bounds
-    }
-
-    intersection = p0 + dir * t;
+    intersection = p0 + (p1 - p0) * t;
     return true;
 }
 
 bool Shapes::IsPointInTriangle(const glm::vec3& point, const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2, float epsilon)
 {
-
     // Compute the normal of the triangle
-    glm::vec3 normal = glm::normalize(glm::cross(v1 - v0, v2 - v0));
-
-    // Project point onto triangle plane
-    float distance = glm::dot(normal, point - v0);
-    glm::vec3 projectedPoint = point - distance * normal;
-
-    if (fabs(distance) > epsilon)
-        return false; // Point not on triangle's plane
-
-    // Compute vectors
-    glm::vec3 v0v1 = v1 - v0;
-    glm::vec3 v0v2 = v2 - v0;
-    glm::vec3 v0p = projectedPoint - v0;
-
-    // Compute dot products
-    float d00 = glm::dot(v0v1, v0v1);
-    float d01 = glm::dot(v0v1, v0v2);
-    float d11 = glm::dot(v0v2, v0v2);
-    float d20 = glm::dot(v0p, v0v1);
-    float d21 = glm::dot(v0p, v0v2);
-
-    float denom = d00 * d11 - d01 * d01;
-    if (fabs(denom) < epsilon)
+    const glm::vec3 normal = glm::cross(v1 - v0, v2 - v0);
+    const float length = glm::length(normal);
+    if (length == 0.0f)
         return false; // Degenerate triangle
 
-    float v = (d11 * d20 - d01 * d21) / denom;
-    float w = (d00 * d21 - d01 * d20) / denom;
-    float u = 1.0f - v - w;
+    // Distance from the plane, within epsilon as computed points are rarely exactly on it
+    if (fabs(glm::dot(normal, point - v0)) > epsilon * length)
+        return false; // Point not on triangle's plane
 
-    return (u >= -epsilon && v >= -epsilon && w >= -epsilon &&
-        u <= 1.0f + epsilon && v <= 1.0f + epsilon && w <= 1.0f + epsilon);
+    // Containment in the plane, from exact signs in the projection that drops
+    // the normal's largest axis
+    const glm::vec3 n = glm::abs(normal);
+    const int axis = n.x >= n.y && n.x >= n.z ? 0 : (n.y >= n.z ? 1 : 2);
+    auto project = [axis](const glm::vec3& p) { return glm::vec2(p[(axis + 1) % 3], p[(axis + 2) % 3]); };
+    const glm::vec2 p = project(point), a = project(v0), b = project(v1), c = project(v2);
+    const double d1 = Predicates::Orient2D(a, b, p);
+    const double d2 = Predicates::Orient2D(b, c, p);
+    const double d3 = Predicates::Orient2D(c, a, p);
+    const bool hasNeg = d1 < 0.0 || d2 < 0.0 || d3 < 0.0;
+    const bool hasPos = d1 > 0.0 || d2 > 0.0 || d3 > 0.0;
+    return !(hasNeg && hasPos) && Predicates::Orient2D(a, b, c) != 0.0;
 }
 
 std::vector<unsigned int> Shapes::TriangulateConvexPolygon(const std::vector<glm::vec3>& polygonVertices, const glm::vec3& normal) {
@@ -1109,10 +1262,13 @@ std::vector<unsigned int> Shapes::TriangulateConvexPolygon(const std::vector<glm
 
 
     unsigned int anchorIndex = n-1;
-    glm::vec3 v0 = polygonVertices[0];
-    glm::vec3 v1 = polygonVertices[1];
-    glm::vec3 v2 = polygonVertices[2];
-    glm::vec3 polygonNormal = glm::normalize(glm::cross(v1 - v0, v2 - v0));
+    // Winding from the whole fan rather than the first three points, which
+    // may be collinear when they follow an intersection curve along an edge
+    glm::vec3 polygonNormal(0.0f);
+    for (unsigned int i = 0; i + 1 < n; ++i) {
+        const unsigned int next = i + 2 < n ? i + 1 : 0;
+        polygonNormal += glm::cross(polygonVertices[i] - polygonVertices[anchorIndex], polygonVertices[next] - polygonVertices[anchorIndex]);
+    }
 
     for (unsigned int i = 0; i < n - 2; ++i) {
         if (glm::dot(polygonNormal, normal) < 0) {
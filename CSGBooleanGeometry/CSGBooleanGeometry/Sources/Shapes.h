@@ -1,32 +1,28 @@
 #pragma once
-#include "glad/glad.h"
 #include "glm.hpp"
-#include "gtc/epsilon.hpp"
+#include "MeshData.h"
+#include "GJK.h"
+#include "Broadphase.h"
+#include "MeshBoolean.h"
+#include <array>
 #include <vector>
-#include <unordered_map>
 
-struct Mesh {
-    GLuint VAO;
-    GLuint VBO;
-    GLuint EBO;
-    GLsizei indexCount;
-    std::vector<float> vertices;
-    std::vector<unsigned int> indices;
+// Narrow test used by AreMeshesIntersecting; both treat the meshes as convex
+enum class OverlapTest {
+    SAT, // Face-normal separating axes
+    GJK  // GJK on the Minkowski difference, warm-startable through a GJKCache
 };
 
-struct Vec3Hash {
-    size_t operator()(const glm::vec3& v) const {
-        size_t hx = std::hash<float>()(v.x);
-        size_t hy = std::hash<float>()(v.y);
-        size_t hz = std::hash<float>()(v.z);
-        return hx ^ (hy << 1) ^ (hz << 2);
-    }
-};
-
-struct Vec3Equal {
-    bool operator()(const glm::vec3& a, const glm::vec3& b) const {
-        return glm::all(glm::epsilonEqual(a, b, 1e-6f));
-    }
+// Per-pair state for AreMeshesIntersecting, kept by the caller across frames.
+// The last separating axis is tried before anything else: when an operand only
+// moved a little it usually still separates the pair, and the query ends there.
+struct SeparatingAxisCache {
+    glm::vec3 axis = glm::vec3(0.0f); // World space; zero after a query that found an overlap
+    unsigned int hintsA[2] = {};      // Support start vertices for the min/max projections
+    unsigned int hintsB[2] = {};
+    GJKCache gjk;                     // Warm start for OverlapTest::GJK
+    size_t axisHits = 0;              // Queries answered by the cached axis
+    size_t axisMisses = 0;            // Queries where the cached axis no longer separated the pair
 };
 
 struct Face {
@@ -39,43 +35,80 @@ class Shapes
 {
 public:
     static void ExtractUniquePositionsAndIndices(
-        const Mesh& mesh,
+        const MeshData& mesh,
         std::vector<glm::vec3>& outPositions,
         std::vector<unsigned int>& outIndices
     );
-    static void ExtractUniquePositionsAndIndicesWorld(const Mesh& mesh, std::vector<glm::vec3>& outPositions, std::vector<unsigned int>& outIndices, const glm::mat4& model);
-    static Mesh CreateSphere(float radius, unsigned int sectorCount, unsigned int stackCount, glm::vec3 color);
-    static Mesh CreateBox(float width, float height, float length, glm::vec3 color);
-    static Mesh CreateCylinder(float radius, float height, unsigned int sectorCount, glm::vec3 color);
-    static Mesh FaceToMesh(Face& face, glm::vec3 color);
-    static Mesh OpenGLDataInitialize(std::vector<float>& vertices, std::vector<unsigned int>& indices);
+    static void ExtractUniquePositionsAndIndicesWorld(const MeshData& mesh, std::vector<glm::vec3>& outPositions, std::vector<unsigned int>& outIndices, const glm::mat4& model);
+    static MeshData CreateSphere(float radius, unsigned int sectorCount, unsigned int stackCount, glm::vec3 color);
+    static MeshData CreateBox(float width, float height, float length, glm::vec3 color);
+    static MeshData CreateCylinder(float radius, float height, unsigned int sectorCount, glm::vec3 color);
+    static MeshData FaceToMesh(const Face& face, glm::vec3 color);
+    static MeshData BuildMesh(std::vector<glm::vec3>&& positions, std::vector<glm::vec3>&& normals, std::vector<glm::vec3>&& colors, std::vector<unsigned int>&& indices);
     static void ProjectOntoAxis(
-        const std::vector<float>& vertices,
+        const std::vector<glm::vec3>& positions,
         const glm::vec3& axis,
         const glm::mat4& modelMatrix,
         float& min,
         float& max
     );
     static bool AreMeshesIntersectingSAT(
-        const Mesh& meshA, const glm::mat4& modelA,
-        const Mesh& meshB, const glm::mat4& modelB
+        const MeshData& meshA, const glm::mat4& modelA,
+        const MeshData& meshB, const glm::mat4& modelB,
+        glm::vec3* outSeparatingAxis = nullptr
+    );
+    static bool AreMeshesIntersectingGJK(
+        const MeshData& meshA, const glm::mat4& modelA,
+        const MeshData& meshB, const glm::mat4& modelB,
+        GJKCache* cache = nullptr, Penetration* outPenetration = nullptr
     );
-    static std::vector<glm::vec3> CalculateFaceNormals(const Mesh& mesh, const glm::mat4& modelMatrix);
+    // Default overlap query: cached axis, world AABBs, the 15-axis OBB test, then `test`
+    static bool AreMeshesIntersecting(
+        const MeshData& meshA, const glm::mat4& modelA,
+        const MeshData& meshB, const glm::mat4& modelB,
+        OverlapTest test = OverlapTest::SAT, SeparatingAxisCache* cache = nullptr
+    );
+    // Narrow test on the broadphase pairs only; returns the pairs that intersect
+    static std::vector<BroadphasePair> FindIntersectingPairs(SweepAndPrune& scene, OverlapTest test = OverlapTest::SAT);
+    static std::vector<glm::vec3> CalculateFaceNormals(const MeshData& mesh, const glm::mat4& modelMatrix);
     static bool IsPointInsideConvexMesh(const glm::vec3& point,
         const std::vector<glm::vec3>& vertexPositions,
         const std::vector<unsigned int>& indices);
     static std::vector<unsigned int> GetConnectedVertices(
         const std::vector<unsigned int>& Indices,
         unsigned int vertexIndex);
-    static std::vector<unsigned int> GetVertexesWithinMesh(const Mesh& meshA, const glm::mat4& modelMatrixA, const Mesh& meshB, const glm::mat4& modelMatrixB);
+    // Point containment in a closed mesh, convex or not: exact face planes when the
+    // mesh is convex, the generalized winding number otherwise. outInside[i] is 1
+    // for points[i] (placed by pointsModel) inside mesh (placed by meshModel).
+    static void ClassifyPoints(const std::vector<glm::vec3>& points, const glm::mat4& pointsModel,
+        const MeshData& mesh, const glm::mat4& meshModel, std::vector<unsigned char>& outInside);
+    static std::vector<unsigned int> GetVertexesWithinMesh(const MeshData& meshA, const glm::mat4& modelMatrixA, const MeshData& meshB, const glm::mat4& modelMatrixB);
     static std::vector<glm::vec3> GetVertexesWithinMesh2(const std::vector<glm::vec3>& vertexPositionA,
     const std::vector<glm::vec3>& vertexPositionB,
     const std::vector<unsigned int>& IndicesA,
-    const std::vector<unsigned int> IndicesB);
-    static std::vector<glm::vec3> GetIntersectionPoints(const Mesh& meshA, const glm::mat4& modelMatrixA, const Mesh& meshB, const glm::mat4& modelMatrixB, bool firstMeshPoints);
+    const std::vector<unsigned int> IndicesB,
+    float tolerance = 0.001f);
+    // Same, for world positions against meshB itself, which need not be convex
+    static std::vector<glm::vec3> GetVertexesWithinMesh2(const std::vector<glm::vec3>& vertexPositionA,
+        const MeshData& meshB, const glm::mat4& modelMatrixB, float tolerance = 0.001f);
+    static std::vector<glm::vec3> GetIntersectionPoints(const MeshData& meshA, const glm::mat4& modelMatrixA, const MeshData& meshB, const glm::mat4& modelMatrixB, bool firstMeshPoints, float tolerance = 0.001f);
     static bool LineIntersectsTriangle(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2, glm::vec3& intersection);
     static std::vector<glm::vec3> GetEdgeIntersection(const glm::vec3& v0, const glm::vec3& v1, const std::vector<glm::vec3>& vertices, const std::vector<unsigned int>& indices, const glm::mat4& modelMatrix);
-    static std::vector<Face> GeneratePolygonIntersectionFaces(Mesh& meshA, const glm::mat4& modelMatrixA, const Mesh& meshB, const glm::mat4& modelMatrixB);
+    static std::vector<glm::vec3> GetEdgeIntersection(const glm::vec3& v0, const glm::vec3& v1, const std::vector<glm::vec3>& worldVertices, const std::vector<unsigned int>& indices);
+    // Only tests the triangles the segment reaches in bvh, which is built in the space modelMatrix maps to world
+    static std::vector<glm::vec3> GetEdgeIntersection(const glm::vec3& v0, const glm::vec3& v1, const std::vector<glm::vec3>& worldVertices, const std::vector<unsigned int>& indices, const BVH& bvh, const glm::mat4& modelMatrix);
+    // op applied to two closed meshes, welded and in world space: every edge is
+    // shared by exactly two triangles. SymmetricDifference comes out as the two
+    // shells A - B and B - A, each welded on its own (see MeshBoolean::Select).
+    static MeshData Boolean(const MeshData& meshA, const glm::mat4& modelA, const MeshData& meshB, const glm::mat4& modelB, BooleanOp op,
+        BooleanArithmetic arithmetic = BooleanArithmetic::Float);
+    // All four operators from a single intersection pass, indexed by BooleanOp
+    static std::array<MeshData, 4> BooleanAll(const MeshData& meshA, const glm::mat4& modelA, const MeshData& meshB, const glm::mat4& modelB,
+        BooleanArithmetic arithmetic = BooleanArithmetic::Float);
+    // Copy of mesh for drawing, with vertices split where faces meet at more than
+    // creaseDegrees so sharp edges shade sharp. The copy is no longer welded.
+    static MeshData SplitCreases(const MeshData& mesh, float creaseDegrees = 30.0f);
+    static std::vector<Face> GeneratePolygonIntersectionFaces(const MeshData& meshA, const glm::mat4& modelMatrixA, const MeshData& meshB, const glm::mat4& modelMatrixB, float tolerance = 0.00001f);
     static bool IsPointInTriangle(const glm::vec3& point, const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2, float epsilon = 1e-8f);
     static std::vector<unsigned int> TriangulateConvexPolygon(const std::vector<glm::vec3>& polygonVertices, const glm::vec3& normal);
 };
@@ -0,0 +1,44 @@
+#include "TransformCache.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CSG_TRANSFORM_SSE 1
+#endif
+
+const std::vector<glm::vec3>& TransformCache::GetWorldPositions(const MeshData& mesh, const glm::mat4& model)
+{
+    bool hit;
+    WorldPositionCache::Entry& entry = mesh.worldPositions.Find(mesh.revision, model, hit);
+    if (!hit)
+        TransformPositions(mesh.positions, model, entry.value);
+    return entry.value;
+}
+
+void TransformCache::TransformPositions(const glm::vec3* positions, size_t count, const glm::mat4& model, glm::vec3* out)
+{
+    size_t i = 0;
+#ifdef CSG_TRANSFORM_SSE
+    const __m128 c0 = _mm_loadu_ps(&model[0][0]);
+    const __m128 c1 = _mm_loadu_ps(&model[1][0]);
+    const __m128 c2 = _mm_loadu_ps(&model[2][0]);
+    const __m128 c3 = _mm_loadu_ps(&model[3][0]);
+
+    // A 4-wide store writes one float past the vec3, so the last point takes the scalar path
+    for (; i + 1 < count; ++i) {
+        const glm::vec3& p = positions[i];
+        __m128 r = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(p.x)), _mm_mul_ps(c1, _mm_set1_ps(p.y))),
+            _mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(p.z)), c3));
+        _mm_storeu_ps(&out[i].x, r);
+    }
+#endif
+    for (; i < count; ++i) {
+        out[i] = glm::vec3(model * glm::vec4(positions[i], 1.0f));
+    }
+}
+
+void TransformCache::TransformPositions(const std::vector<glm::vec3>& positions, const glm::mat4& model, std::vector<glm::vec3>& out)
+{
+    out.resize(positions.size());
+    TransformPositions(positions.data(), positions.size(), model, out.data());
+}
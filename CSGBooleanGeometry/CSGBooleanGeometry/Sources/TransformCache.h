@@ -0,0 +1,20 @@
+#pragma once
+#include "MeshData.h"
+#include <vector>
+
+// World-space positions of a mesh under one model matrix. Results are kept on
+// the mesh (MeshData::worldPositions) per (revision, matrix), so an operand that
+// did not move is never re-transformed, and asking for a second matrix does not
+// overwrite the positions returned for the first (see PerMatrixCache for how
+// long a reference stays valid). Not thread-safe: the cache lives in a mutable
+// member, so do not query the same mesh from several threads at once.
+class TransformCache
+{
+public:
+    static const std::vector<glm::vec3>& GetWorldPositions(const MeshData& mesh, const glm::mat4& model);
+
+    // Batch affine transform (out[i] = model * vec4(positions[i], 1)), SSE when available.
+    // out must not alias positions.
+    static void TransformPositions(const glm::vec3* positions, size_t count, const glm::mat4& model, glm::vec3* out);
+    static void TransformPositions(const std::vector<glm::vec3>& positions, const glm::mat4& model, std::vector<glm::vec3>& out);
+};
@@ -0,0 +1,287 @@
+#include "TriangleIntersection.h"
+#include "ImplicitPoints.h"
+#include "Predicates.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CSG_TRIANGLE_SSE 1
+#endif
+
+namespace {
+    // Signed distances of the triangle's vertices to the plane (n, d), snapped
+    // to zero near the plane. Returns false when all three lie strictly on one side.
+    bool PlaneDistances(const glm::vec3& n, float d, const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2, float out[3])
+    {
+        out[0] = glm::dot(n, v0) - d;
+        out[1] = glm::dot(n, v1) - d;
+        out[2] = glm::dot(n, v2) - d;
+        for (int i = 0; i < 3; ++i) {
+            if (std::abs(out[i]) < TriangleIntersection::PlaneEpsilon)
+                out[i] = 0.0f;
+        }
+        return !((out[0] > 0.0f && out[1] > 0.0f && out[2] > 0.0f) || (out[0] < 0.0f && out[1] < 0.0f && out[2] < 0.0f));
+    }
+
+    // Part of a triangle lying in the other triangle's plane: vertices on the
+    // plane plus edge crossings. Never more than two points unless coplanar.
+    void ClipToPlane(const glm::vec3 v[3], const float dist[3], glm::vec3& p0, glm::vec3& p1)
+    {
+        glm::vec3 points[2];
+        int count = 0;
+        for (int i = 0; i < 3 && count < 2; ++i) {
+            int j = (i + 1) % 3;
+            if (dist[i] == 0.0f)
+                points[count++] = v[i];
+            if (count < 2 && dist[i] * dist[j] < 0.0f) {
+                float t = dist[i] / (dist[i] - dist[j]);
+                points[count++] = v[i] + (v[j] - v[i]) * t;
+            }
+        }
+        p0 = points[0];
+        p1 = count > 1 ? points[1] : points[0];
+    }
+
+    int SignOf(double value)
+    {
+        return value > 0.0 ? 1 : (value < 0.0 ? -1 : 0);
+    }
+
+    bool SameSide(const int side[3])
+    {
+        return side[0] != 0 && side[0] == side[1] && side[1] == side[2];
+    }
+
+    bool Degenerate(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c)
+    {
+        for (int axis = 0; axis < 3; ++axis) {
+            auto project = [axis](const glm::vec3& p) { return glm::vec2(p[(axis + 1) % 3], p[(axis + 2) % 3]); };
+            if (Predicates::Orient2D(project(a), project(b), project(c)) != 0.0)
+                return false;
+        }
+        return true;
+    }
+
+    // ClipToPlane with exact sides; returns the number of points, two unless
+    // the triangle only touches the plane
+    int ClipToPlaneExact(ImplicitPoints& points, const unsigned int v[3], const int side[3], const unsigned int plane[3], unsigned int out[2])
+    {
+        int count = 0;
+        for (int i = 0; i < 3 && count < 2; ++i) {
+            const int j = (i + 1) % 3;
+            if (side[i] == 0)
+                out[count++] = v[i];
+            if (count < 2 && side[i] * side[j] < 0)
+                out[count++] = points.AddLinePlane(v[i], v[j], plane[0], plane[1], plane[2]);
+        }
+        return count;
+    }
+}
+
+TriangleIntersection::Result TriangleIntersection::Intersect(
+    const glm::vec3& a0, const glm::vec3& a1, const glm::vec3& a2,
+    const glm::vec3& b0, const glm::vec3& b1, const glm::vec3& b2,
+    glm::vec3& outStart, glm::vec3& outEnd)
+{
+    // Step 1: A against B's plane; reject when A is entirely on one side
+    glm::vec3 normalB = glm::cross(b1 - b0, b2 - b0);
+    float lengthB = glm::length(normalB);
+    if (lengthB == 0.0f)
+        return Result::None;
+    normalB /= lengthB;
+    float distA[3];
+    if (!PlaneDistances(normalB, glm::dot(normalB, b0), a0, a1, a2, distA))
+        return Result::None;
+
+    // Step 2: B against A's plane
+    glm::vec3 normalA = glm::cross(a1 - a0, a2 - a0);
+    float lengthA = glm::length(normalA);
+    if (lengthA == 0.0f)
+        return Result::None;
+    normalA /= lengthA;
+    float distB[3];
+    if (!PlaneDistances(normalA, glm::dot(normalA, a0), b0, b1, b2, distB))
+        return Result::None;
+
+    // Either test can be the one that lands every vertex on the plane
+    if ((distA[0] == 0.0f && distA[1] == 0.0f && distA[2] == 0.0f) || (distB[0] == 0.0f && distB[1] == 0.0f && distB[2] == 0.0f))
+        return Result::Coplanar;
+
+    // Step 3: Each triangle meets the other's plane in a segment on the common line
+    const glm::vec3 triA[3] = { a0, a1, a2 };
+    const glm::vec3 triB[3] = { b0, b1, b2 };
+    glm::vec3 segA0, segA1, segB0, segB1;
+    ClipToPlane(triA, distA, segA0, segA1);
+    ClipToPlane(triB, distB, segB0, segB1);
+
+    // Step 4: Overlap the two segments as intervals along the line direction
+    glm::vec3 direction = glm::cross(normalA, normalB);
+    float tA0 = glm::dot(direction, segA0), tA1 = glm::dot(direction, segA1);
+    float tB0 = glm::dot(direction, segB0), tB1 = glm::dot(direction, segB1);
+    if (tA0 > tA1) { std::swap(tA0, tA1); std::swap(segA0, segA1); }
+    if (tB0 > tB1) { std::swap(tB0, tB1); std::swap(segB0, segB1); }
+    if (tA1 < tB0 || tB1 < tA0)
+        return Result::None;
+
+    outStart = tA0 > tB0 ? segA0 : segB0;
+    outEnd = tA1 < tB1 ? segA1 : segB1;
+    return Result::Segment;
+}
+
+TriangleIntersection::Result TriangleIntersection::IntersectExact(ImplicitPoints& points, const unsigned int a[3], const unsigned int b[3],
+    unsigned int& outStart, unsigned int& outEnd)
+{
+    // Step 1: exact sides of each triangle's vertices against the other's plane
+    const std::vector<glm::vec3>& input = points.Input();
+    int sideA[3], sideB[3];
+    for (int i = 0; i < 3; ++i)
+        sideA[i] = SignOf(Predicates::Orient3D(input[b[0]], input[b[1]], input[b[2]], input[a[i]]));
+    if (SameSide(sideA))
+        return Result::None;
+    for (int i = 0; i < 3; ++i)
+        sideB[i] = SignOf(Predicates::Orient3D(input[a[0]], input[a[1]], input[a[2]], input[b[i]]));
+    if (SameSide(sideB))
+        return Result::None;
+
+    // A degenerate triangle has every point on its "plane"
+    if ((sideA[0] == 0 && sideA[1] == 0 && sideA[2] == 0) || (sideB[0] == 0 && sideB[1] == 0 && sideB[2] == 0)) {
+        if (Degenerate(input[a[0]], input[a[1]], input[a[2]]) || Degenerate(input[b[0]], input[b[1]], input[b[2]]))
+            return Result::None;
+        return Result::Coplanar;
+    }
+
+    // Step 2: each triangle's part on the other's plane, both on the common line
+    unsigned int clipA[2], clipB[2];
+    if (ClipToPlaneExact(points, a, sideA, b, clipA) < 2 || ClipToPlaneExact(points, b, sideB, a, clipB) < 2)
+        return Result::None;
+
+    // Step 3: order both along a coordinate the line runs along; the one it
+    // changes fastest in, by the rounded normals, nearly always decides first time
+    const glm::vec3 direction = glm::abs(glm::cross(glm::cross(input[a[1]] - input[a[0]], input[a[2]] - input[a[0]]),
+        glm::cross(input[b[1]] - input[b[0]], input[b[2]] - input[b[0]])));
+    int axes[3] = { 0, 1, 2 };
+    std::sort(axes, axes + 3, [&](int l, int r) { return direction[l] > direction[r]; });
+    int axis = -1;
+    for (int k = 0; k < 3 && axis < 0; ++k) {
+        const int order = points.Compare(clipA[0], clipA[1], axes[k]);
+        if (order == 0)
+            continue;
+        axis = axes[k];
+        if (order > 0)
+            std::swap(clipA[0], clipA[1]);
+    }
+    if (axis < 0)
+        return Result::None;
+    if (points.Compare(clipB[0], clipB[1], axis) > 0)
+        std::swap(clipB[0], clipB[1]);
+
+    // Step 4: overlap the two intervals; sharing only an end is a single point
+    if (points.Compare(clipA[1], clipB[0], axis) <= 0 || points.Compare(clipB[1], clipA[0], axis) <= 0)
+        return Result::None;
+    outStart = points.Compare(clipA[0], clipB[0], axis) >= 0 ? clipA[0] : clipB[0];
+    outEnd = points.Compare(clipA[1], clipB[1], axis) <= 0 ? clipA[1] : clipB[1];
+    return Result::Segment;
+}
+
+void TriangleIntersection::IntersectPairsExact(ImplicitPoints& points,
+    const std::vector<unsigned int>& indicesA, const std::vector<unsigned int>& indicesB,
+    const TrianglePair* pairs, size_t pairCount,
+    std::vector<ImplicitTriangleSegment>& outSegments)
+{
+    for (size_t p = 0; p < pairCount; ++p) {
+        ImplicitTriangleSegment segment{ pairs[p].triangleA, pairs[p].triangleB, 0, 0, false };
+        const Result result = IntersectExact(points, &indicesA[size_t(pairs[p].triangleA) * 3], &indicesB[size_t(pairs[p].triangleB) * 3],
+            segment.start, segment.end);
+        if (result == Result::None)
+            continue;
+        segment.coplanar = result == Result::Coplanar;
+        outSegments.push_back(segment);
+    }
+}
+
+void TriangleIntersection::IntersectPairs(
+    const std::vector<glm::vec3>& positionsA, const std::vector<unsigned int>& indicesA,
+    const std::vector<glm::vec3>& positionsB, const std::vector<unsigned int>& indicesB,
+    const TrianglePair* pairs, size_t pairCount,
+    std::vector<TriangleSegment>& outSegments)
+{
+    auto runScalar = [&](const TrianglePair& pair) {
+        const unsigned int* ia = &indicesA[size_t(pair.triangleA) * 3];
+        const unsigned int* ib = &indicesB[size_t(pair.triangleB) * 3];
+        TriangleSegment segment{ pair.triangleA, pair.triangleB, glm::vec3(0.0f), glm::vec3(0.0f), false };
+        Result result = Intersect(positionsA[ia[0]], positionsA[ia[1]], positionsA[ia[2]],
+            positionsB[ib[0]], positionsB[ib[1]], positionsB[ib[2]], segment.start, segment.end);
+        if (result == Result::None)
+            return;
+        segment.coplanar = result == Result::Coplanar;
+        outSegments.push_back(segment);
+    };
+
+    size_t p = 0;
+#ifdef CSG_TRIANGLE_SSE
+    // Four pairs per iteration in SoA form: A's vertices against B's plane, and
+    // B's vertices against A's plane. Pairs that clear both go to the scalar kernel.
+    auto load = [](const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2, const glm::vec3& v3, __m128& x, __m128& y, __m128& z) {
+        x = _mm_setr_ps(v0.x, v1.x, v2.x, v3.x);
+        y = _mm_setr_ps(v0.y, v1.y, v2.y, v3.y);
+        z = _mm_setr_ps(v0.z, v1.z, v2.z, v3.z);
+    };
+    // Lanes where all three vertices of one triangle are beyond epsilon on the
+    // same side of the other's plane. Distances are formed as PlaneDistances
+    // forms them (unit normal, dot(n, v) - d), and the epsilon is widened by a
+    // bound on their rounding error, so a pair the scalar test keeps is never rejected.
+    auto separated = [](const __m128 tri[3][3], const __m128 plane[3][3]) {
+        const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+        auto dot = [](__m128 ax, __m128 ay, __m128 az, __m128 bx, __m128 by, __m128 bz) {
+            return _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_mul_ps(az, bz));
+        };
+        __m128 e1x = _mm_sub_ps(plane[1][0], plane[0][0]), e1y = _mm_sub_ps(plane[1][1], plane[0][1]), e1z = _mm_sub_ps(plane[1][2], plane[0][2]);
+        __m128 e2x = _mm_sub_ps(plane[2][0], plane[0][0]), e2y = _mm_sub_ps(plane[2][1], plane[0][1]), e2z = _mm_sub_ps(plane[2][2], plane[0][2]);
+        __m128 nx = _mm_sub_ps(_mm_mul_ps(e1y, e2z), _mm_mul_ps(e1z, e2y));
+        __m128 ny = _mm_sub_ps(_mm_mul_ps(e1z, e2x), _mm_mul_ps(e1x, e2z));
+        __m128 nz = _mm_sub_ps(_mm_mul_ps(e1x, e2y), _mm_mul_ps(e1y, e2x));
+        // A zero normal gives NaN lanes, which never compare as separated
+        __m128 length = _mm_sqrt_ps(dot(nx, ny, nz, nx, ny, nz));
+        nx = _mm_div_ps(nx, length);
+        ny = _mm_div_ps(ny, length);
+        nz = _mm_div_ps(nz, length);
+        __m128 ax = _mm_and_ps(nx, signMask), ay = _mm_and_ps(ny, signMask), az = _mm_and_ps(nz, signMask);
+        __m128 d = dot(nx, ny, nz, plane[0][0], plane[0][1], plane[0][2]);
+        __m128 magnitudeD = dot(ax, ay, az, _mm_and_ps(plane[0][0], signMask), _mm_and_ps(plane[0][1], signMask), _mm_and_ps(plane[0][2], signMask));
+        __m128 allAbove = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        __m128 allBelow = allAbove;
+        for (int k = 0; k < 3; ++k) {
+            __m128 distance = _mm_sub_ps(dot(nx, ny, nz, tri[k][0], tri[k][1], tri[k][2]), d);
+            // Both evaluations err by a few ulps of the summed term magnitudes;
+            // 16 ulps covers each, plus the normals differing in their last bits
+            __m128 magnitude = _mm_add_ps(magnitudeD,
+                dot(ax, ay, az, _mm_and_ps(tri[k][0], signMask), _mm_and_ps(tri[k][1], signMask), _mm_and_ps(tri[k][2], signMask)));
+            __m128 eps = _mm_add_ps(_mm_set1_ps(PlaneEpsilon), _mm_mul_ps(_mm_set1_ps(16.0f * FLT_EPSILON), magnitude));
+            allAbove = _mm_and_ps(allAbove, _mm_cmpgt_ps(distance, eps));
+            allBelow = _mm_and_ps(allBelow, _mm_cmplt_ps(distance, _mm_sub_ps(_mm_setzero_ps(), eps)));
+        }
+        return _mm_movemask_ps(_mm_or_ps(allAbove, allBelow));
+    };
+
+    for (; p + 4 <= pairCount; p += 4) {
+        __m128 triA[3][3], triB[3][3];
+        for (int k = 0; k < 3; ++k) {
+            load(positionsA[indicesA[size_t(pairs[p].triangleA) * 3 + k]], positionsA[indicesA[size_t(pairs[p + 1].triangleA) * 3 + k]],
+                positionsA[indicesA[size_t(pairs[p + 2].triangleA) * 3 + k]], positionsA[indicesA[size_t(pairs[p + 3].triangleA) * 3 + k]],
+                triA[k][0], triA[k][1], triA[k][2]);
+            load(positionsB[indicesB[size_t(pairs[p].triangleB) * 3 + k]], positionsB[indicesB[size_t(pairs[p + 1].triangleB) * 3 + k]],
+                positionsB[indicesB[size_t(pairs[p + 2].triangleB) * 3 + k]], positionsB[indicesB[size_t(pairs[p + 3].triangleB) * 3 + k]],
+                triB[k][0], triB[k][1], triB[k][2]);
+        }
+        int rejected = separated(triA, triB) | separated(triB, triA);
+        for (int lane = 0; lane < 4; ++lane) {
+            if (!(rejected & (1 << lane)))
+                runScalar(pairs[p + lane]);
+        }
+    }
+#endif
+    for (; p < pairCount; ++p)
+        runScalar(pairs[p]);
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include "glm.hpp"
+#include "BVH.h"
+#include <vector>
+
+class ImplicitPoints;
+
+// Intersection of two triangles that are not coplanar: the segment they share
+// (start == end when they only touch at a point)
+struct TriangleSegment {
+    unsigned int triangleA;
+    unsigned int triangleB;
+    glm::vec3 start;
+    glm::vec3 end;
+    bool coplanar; // Both triangles lie in one plane; start/end are not set
+};
+
+// The same from the exact intersection, with endpoints as ids into ImplicitPoints
+struct ImplicitTriangleSegment {
+    unsigned int triangleA;
+    unsigned int triangleB;
+    unsigned int start;
+    unsigned int end;
+    bool coplanar;
+};
+
+// Triangle-triangle intersection after Moller, computing the segment the way
+// Guigue-Devillers do: each triangle is clipped against the other's plane and
+// the two resulting segments, which lie on the planes' common line, are overlapped.
+class TriangleIntersection
+{
+public:
+    enum class Result { None, Segment, Coplanar };
+
+    static Result Intersect(
+        const glm::vec3& a0, const glm::vec3& a1, const glm::vec3& a2,
+        const glm::vec3& b0, const glm::vec3& b1, const glm::vec3& b2,
+        glm::vec3& outStart, glm::vec3& outEnd);
+
+    // Runs every candidate pair; intersecting and coplanar pairs are appended
+    // to outSegments in pair order. The plane-side rejection runs four pairs
+    // at a time with SSE where available.
+    static void IntersectPairs(
+        const std::vector<glm::vec3>& positionsA, const std::vector<unsigned int>& indicesA,
+        const std::vector<glm::vec3>& positionsB, const std::vector<unsigned int>& indicesB,
+        const TrianglePair* pairs, size_t pairCount,
+        std::vector<TriangleSegment>& outSegments);
+
+    // Exact counterpart of Intersect for triangles given as input ids of points.
+    // Plane sides are exact orientations with no epsilon, and the segment's ends
+    // are added to points as input vertices or edge-plane crossings, ordered
+    // along the planes' common line by exact coordinate comparisons. Triangles
+    // touching in a single point give None.
+    static Result IntersectExact(ImplicitPoints& points, const unsigned int a[3], const unsigned int b[3],
+        unsigned int& outStart, unsigned int& outEnd);
+
+    // IntersectPairs for IntersectExact; indicesA / indicesB hold input ids of points
+    static void IntersectPairsExact(ImplicitPoints& points,
+        const std::vector<unsigned int>& indicesA, const std::vector<unsigned int>& indicesB,
+        const TrianglePair* pairs, size_t pairCount,
+        std::vector<ImplicitTriangleSegment>& outSegments);
+
+    // Signed distances within this of a plane count as on it
+    static constexpr float PlaneEpsilon = 1e-6f;
+};
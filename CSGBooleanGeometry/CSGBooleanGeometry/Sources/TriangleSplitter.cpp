@@ -0,0 +1,644 @@
+#include "TriangleSplitter.h"
+#include "ImplicitPoints.h"
+#include "Predicates.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Same hand in 2D as the 3D triangle when the dropped axis is the normal's largest
+    glm::vec2 Project(const glm::vec3& p, int axis)
+    {
+        switch (axis) {
+        case 0: return glm::vec2(p.y, p.z);
+        case 1: return glm::vec2(p.z, p.x);
+        default: return glm::vec2(p.x, p.y);
+        }
+    }
+
+    unsigned char Bit(unsigned char mask, int e)
+    {
+        return static_cast<unsigned char>((mask >> (e % 3)) & 1);
+    }
+}
+
+unsigned char TriangleSplitter::EdgeOf(const glm::vec3 corners[3], const glm::vec3& p, float tolerance)
+{
+    unsigned char edge = Interior;
+    float nearest = tolerance;
+    for (unsigned char e = 0; e < 3; ++e) {
+        const glm::vec3 direction = corners[(e + 1) % 3] - corners[e];
+        const float t = glm::dot(p - corners[e], direction) / glm::dot(direction, direction);
+        if (t <= 0.0f || t >= 1.0f)
+            continue;
+        const float distance = glm::length(p - (corners[e] + t * direction));
+        if (distance < nearest) {
+            nearest = distance;
+            edge = e;
+        }
+    }
+    return edge;
+}
+
+unsigned char TriangleSplitter::EdgeOf(const ImplicitPoints& implicit, const unsigned int corners[3], unsigned int point)
+{
+    int sign;
+    const int axis = implicit.ProjectionAxis(corners, sign);
+    if (sign == 0)
+        return Interior;
+    for (unsigned char e = 0; e < 3; ++e) {
+        if (implicit.Orient2D(corners[e], corners[(e + 1) % 3], point, axis) == 0)
+            return e;
+    }
+    return Interior;
+}
+
+double TriangleSplitter::Orient(unsigned int a, unsigned int b, unsigned int c) const
+{
+    if (implicit)
+        return implicit->Orient2D(ids[a], ids[b], ids[c], axis) * mirror;
+    return Predicates::Orient2D(vertices[a], vertices[b], vertices[c]);
+}
+
+double TriangleSplitter::InCircle(unsigned int a, unsigned int b, unsigned int c, unsigned int d) const
+{
+    // Positive when d is inside the circle through a, b, c (counter-clockwise)
+    return Predicates::InCircle(vertices[a], vertices[b], vertices[c], vertices[d]);
+}
+
+int TriangleSplitter::EdgeIndex(unsigned int t, unsigned int a, unsigned int b) const
+{
+    for (int e = 0; e < 3; ++e) {
+        if (triangles[t].v[e] == a && triangles[t].v[(e + 1) % 3] == b)
+            return e;
+    }
+    return -1;
+}
+
+bool TriangleSplitter::FindEdge(unsigned int a, unsigned int b, unsigned int& outTriangle, int& outEdge) const
+{
+    // Rotate around a through the neighbour links, one way and then the other
+    // when the boundary stops the first
+    auto has = [&](unsigned int t) {
+        const unsigned int* v = triangles[t].v;
+        const int i = v[0] == a ? 0 : (v[1] == a ? 1 : 2);
+        if (v[(i + 1) % 3] == b || v[(i + 2) % 3] == b) {
+            outTriangle = t;
+            outEdge = v[(i + 1) % 3] == b ? i : (i + 2) % 3;
+            return true;
+        }
+        return false;
+    };
+    auto next = [&](unsigned int t, bool forward) {
+        const unsigned int* v = triangles[t].v;
+        const int i = v[0] == a ? 0 : (v[1] == a ? 1 : 2);
+        return triangles[t].n[forward ? i : (i + 2) % 3];
+    };
+    const unsigned int start = vertexTriangle[a];
+    if (has(start))
+        return true;
+    for (int direction = 0; direction < 2; ++direction) {
+        unsigned int t = next(start, direction == 0);
+        for (size_t guard = 0; t != None && guard < triangles.size(); ++guard) {
+            if (t == start)
+                return false;
+            if (has(t))
+                return true;
+            t = next(t, direction == 0);
+        }
+    }
+    return false;
+}
+
+void TriangleSplitter::Relink(unsigned int t)
+{
+    // Point the neighbours back at t and t's vertices at t
+    const Triangle& triangle = triangles[t];
+    for (int e = 0; e < 3; ++e) {
+        vertexTriangle[triangle.v[e]] = t;
+        const unsigned int u = triangle.n[e];
+        if (u == None)
+            continue;
+        const int f = EdgeIndex(u, triangle.v[(e + 1) % 3], triangle.v[e]);
+        if (f >= 0)
+            triangles[u].n[f] = t;
+    }
+}
+
+void TriangleSplitter::Flip(unsigned int t, int e)
+{
+    // Triangles a-b-c and b-a-d become c-a-d and d-b-c
+    const Triangle T = triangles[t];
+    const unsigned int u = T.n[e];
+    const Triangle U = triangles[u];
+    const unsigned int a = T.v[e], b = T.v[(e + 1) % 3], c = T.v[(e + 2) % 3];
+    const int f = EdgeIndex(u, b, a);
+    const unsigned int d = U.v[(f + 2) % 3];
+    triangles[t] = { { c, a, d }, { T.n[(e + 2) % 3], U.n[(f + 1) % 3], u },
+        static_cast<unsigned char>(Bit(T.fixed, e + 2) | (Bit(U.fixed, f + 1) << 1)) };
+    triangles[u] = { { d, b, c }, { U.n[(f + 2) % 3], T.n[(e + 1) % 3], t },
+        static_cast<unsigned char>(Bit(U.fixed, f + 2) | (Bit(T.fixed, e + 1) << 1)) };
+    Relink(t);
+    Relink(u);
+}
+
+void TriangleSplitter::Legalize()
+{
+    // Lawson: flip pending edges whose opposite vertex lies in the circle of the
+    // other side, and re-check the four edges around each flip. The cap only
+    // matters for cocircular points, where round-off could flip back and forth.
+    const size_t maxFlips = 8 * triangles.size() + 64;
+    size_t flips = 0;
+    while (!pending.empty()) {
+        const Segment edge = pending.back();
+        pending.pop_back();
+        unsigned int t;
+        int e;
+        if (!FindEdge(edge.first, edge.second, t, e))
+            continue;
+        const Triangle& T = triangles[t];
+        if (Bit(T.fixed, e) || T.n[e] == None)
+            continue;
+        const unsigned int a = T.v[e], b = T.v[(e + 1) % 3], c = T.v[(e + 2) % 3];
+        const unsigned int u = T.n[e];
+        const unsigned int d = triangles[u].v[(EdgeIndex(u, b, a) + 2) % 3];
+        if (InCircle(a, b, c, d) <= 0.0 || Orient(c, a, d) <= 0.0 || Orient(d, b, c) <= 0.0)
+            continue;
+        if (++flips > maxFlips) {
+            pending.clear();
+            break;
+        }
+        Flip(t, e);
+        pending.push_back({ c, a });
+        pending.push_back({ a, d });
+        pending.push_back({ d, b });
+        pending.push_back({ b, c });
+    }
+}
+
+unsigned int TriangleSplitter::Locate(unsigned int vertex, int& outEdge, float& outDistance) const
+{
+    // Signed distance from the point to edge e of triangle t, positive inside
+    auto distanceTo = [&](unsigned int t, int e) {
+        const glm::vec2& a = vertices[triangles[t].v[e]];
+        const glm::vec2 ab = vertices[triangles[t].v[(e + 1) % 3]] - a;
+        const glm::vec2 ap = vertices[vertex] - a;
+        return (ab.x * ap.y - ab.y * ap.x) / std::max(glm::length(ab), 1e-30f);
+    };
+    auto nearestEdge = [&](unsigned int t, int& edge) {
+        float nearest = INFINITY;
+        for (int e = 0; e < 3; ++e) {
+            const float distance = distanceTo(t, e);
+            if (distance < nearest) {
+                nearest = distance;
+                edge = e;
+            }
+        }
+        return nearest;
+    };
+
+    // Walk towards the point, crossing an edge it lies beyond. The edge tried
+    // first rotates, which keeps the walk from cycling.
+    unsigned int t = lastTriangle < triangles.size() ? lastTriangle : 0;
+    for (size_t step = 0; step <= triangles.size(); ++step) {
+        const Triangle& triangle = triangles[t];
+        unsigned int next = None;
+        for (int k = 0; k < 3 && next == None; ++k) {
+            const int e = static_cast<int>((k + step) % 3);
+            if (triangle.n[e] != None && Orient(triangle.v[e], triangle.v[(e + 1) % 3], vertex) < 0.0)
+                next = triangle.n[e];
+        }
+        if (next == None) {
+            outDistance = nearestEdge(t, outEdge);
+            return t;
+        }
+        t = next;
+    }
+
+    // Round-off kept the walk from settling: the triangle the point is deepest
+    // inside of, or when exact, one that holds it
+    if (implicit) {
+        for (unsigned int s = 0; s < triangles.size(); ++s) {
+            const unsigned int* v = triangles[s].v;
+            if (Orient(v[0], v[1], vertex) >= 0.0 && Orient(v[1], v[2], vertex) >= 0.0 && Orient(v[2], v[0], vertex) >= 0.0) {
+                outDistance = nearestEdge(s, outEdge);
+                return s;
+            }
+        }
+    }
+    unsigned int best = 0;
+    outDistance = -INFINITY;
+    for (unsigned int s = 0; s < triangles.size(); ++s) {
+        int edge = 0;
+        const float distance = nearestEdge(s, edge);
+        if (distance > outDistance) {
+            outDistance = distance;
+            outEdge = edge;
+            best = s;
+        }
+    }
+    return best;
+}
+
+void TriangleSplitter::SplitTriangle(unsigned int t, unsigned int vertex)
+{
+    const Triangle T = triangles[t];
+    const unsigned int a = T.v[0], b = T.v[1], c = T.v[2];
+    const unsigned int t1 = static_cast<unsigned int>(triangles.size());
+    const unsigned int t2 = t1 + 1;
+    triangles[t] = { { a, b, vertex }, { T.n[0], t1, t2 }, Bit(T.fixed, 0) };
+    triangles.push_back({ { b, c, vertex }, { T.n[1], t2, t }, Bit(T.fixed, 1) });
+    triangles.push_back({ { c, a, vertex }, { T.n[2], t, t1 }, Bit(T.fixed, 2) });
+    Relink(t);
+    Relink(t1);
+    Relink(t2);
+    lastTriangle = t;
+    pending.push_back({ a, b });
+    pending.push_back({ b, c });
+    pending.push_back({ c, a });
+    Legalize();
+}
+
+void TriangleSplitter::SplitEdge(unsigned int a, unsigned int b, unsigned int vertex)
+{
+    // Both triangles on the edge (one on the outer boundary) split in two; the
+    // halves of a recovered segment stay recovered
+    unsigned int t;
+    int e;
+    if (!FindEdge(a, b, t, e))
+        return;
+    const Triangle T = triangles[t];
+    const unsigned int p = T.v[e], q = T.v[(e + 1) % 3], r = T.v[(e + 2) % 3];
+    const unsigned int u = T.n[e];
+    const unsigned char fixed = Bit(T.fixed, e);
+    const unsigned int t1 = static_cast<unsigned int>(triangles.size());
+    const unsigned int u1 = u != None ? t1 + 1 : None;
+    triangles[t] = { { p, vertex, r }, { u1, t1, T.n[(e + 2) % 3] },
+        static_cast<unsigned char>(fixed | (Bit(T.fixed, e + 2) << 2)) };
+    triangles.push_back({ { vertex, q, r }, { u, T.n[(e + 1) % 3], t },
+        static_cast<unsigned char>(fixed | (Bit(T.fixed, e + 1) << 1)) });
+    pending.push_back({ r, p });
+    pending.push_back({ q, r });
+    if (u != None) {
+        const Triangle U = triangles[u];
+        const int f = EdgeIndex(u, q, p);
+        const unsigned int s = U.v[(f + 2) % 3];
+        triangles[u] = { { q, vertex, s }, { t1, u1, U.n[(f + 2) % 3] },
+            static_cast<unsigned char>(fixed | (Bit(U.fixed, f + 2) << 2)) };
+        triangles.push_back({ { vertex, p, s }, { t, U.n[(f + 1) % 3], u },
+            static_cast<unsigned char>(fixed | (Bit(U.fixed, f + 1) << 1)) });
+        Relink(u);
+        Relink(u1);
+        pending.push_back({ s, q });
+        pending.push_back({ p, s });
+    }
+    Relink(t);
+    Relink(t1);
+    lastTriangle = t;
+    Legalize();
+}
+
+unsigned int TriangleSplitter::Insert(unsigned int vertex)
+{
+    const glm::vec2 point = vertices[vertex];
+    int edge = 0;
+    float distance = 0.0f;
+    const unsigned int t = Locate(vertex, edge, distance);
+
+    if (implicit) {
+        // Exact: the point is in t or on one of its edges, and not on a vertex
+        const Triangle& triangle = triangles[t];
+        for (int e = 0; e < 3; ++e) {
+            const unsigned int a = triangle.v[e], b = triangle.v[(e + 1) % 3];
+            if (Orient(a, b, vertex) == 0.0) {
+                if (OnBoundary(a, b))
+                    boundaryMask[vertex] = static_cast<unsigned char>(boundaryMask[a] & boundaryMask[b]);
+                SplitEdge(a, b, vertex);
+                return vertex;
+            }
+        }
+        SplitTriangle(t, vertex);
+        return vertex;
+    }
+
+    // A vertex within tolerance takes the point instead: one of the triangle's
+    // own, or one facing it across an edge
+    const Triangle triangle = triangles[t];
+    unsigned int nearest = None;
+    float nearestDistance = tolerance;
+    auto consider = [&](unsigned int w) {
+        const float d = glm::length(vertices[w] - point);
+        if (d <= nearestDistance) {
+            nearestDistance = d;
+            nearest = w;
+        }
+    };
+    for (int e = 0; e < 3; ++e) {
+        consider(triangle.v[e]);
+        const unsigned int u = triangle.n[e];
+        if (u != None)
+            consider(triangles[u].v[(EdgeIndex(u, triangle.v[(e + 1) % 3], triangle.v[e]) + 2) % 3]);
+    }
+    if (nearest != None) {
+        merged[vertex] = 1;
+        return nearest;
+    }
+
+    const unsigned int a = triangle.v[edge];
+    const unsigned int b = triangle.v[(edge + 1) % 3];
+    if (distance > tolerance || (OnBoundary(a, b) && distance > 0.0f)) {
+        SplitTriangle(t, vertex);
+        return vertex;
+    }
+    if (OnBoundary(a, b)) {
+        // Outside through round-off; splitting the boundary would leave a
+        // T-junction with the neighbour, so merge into the closer end instead
+        merged[vertex] = 1;
+        return glm::length(vertices[a] - point) < glm::length(vertices[b] - point) ? a : b;
+    }
+
+    // On an inner edge: move the point onto it so that no triangle turns over
+    const glm::vec2 ab = vertices[b] - vertices[a];
+    const float along = glm::dot(point - vertices[a], ab) / std::max(glm::dot(ab, ab), 1e-30f);
+    vertices[vertex] = vertices[a] + std::clamp(along, 0.0f, 1.0f) * ab;
+    SplitEdge(a, b, vertex);
+    return vertex;
+}
+
+bool TriangleSplitter::RecoverSegment(unsigned int u, unsigned int v, std::vector<Segment>& outEdges, int depth)
+{
+    if (u == v)
+        return true;
+
+    // A vertex lying on the segment splits it in two
+    unsigned int between = static_cast<unsigned int>(vertices.size());
+    if (implicit) {
+        // Exactly on its line and strictly between its ends along a projected
+        // coordinate the ends differ in
+        int k = (axis + 1) % 3;
+        int order = implicit->Compare(ids[u], ids[v], k);
+        if (order == 0) {
+            k = (axis + 2) % 3;
+            order = implicit->Compare(ids[u], ids[v], k);
+        }
+        for (unsigned int w = 0; w < vertices.size() && between == vertices.size(); ++w) {
+            if (w == u || w == v || Orient(u, v, w) != 0.0)
+                continue;
+            if (implicit->Compare(ids[u], ids[w], k) == order && implicit->Compare(ids[w], ids[v], k) == order)
+                between = w;
+        }
+    }
+    else {
+        const glm::vec2 uv = vertices[v] - vertices[u];
+        const float length = glm::length(uv);
+        float nearest = INFINITY;
+        for (unsigned int w = 0; w < vertices.size(); ++w) {
+            if (w == u || w == v || merged[w])
+                continue;
+            const glm::vec2 uw = vertices[w] - vertices[u];
+            const float along = glm::dot(uw, uv) / length;
+            if (along <= tolerance || along >= length - tolerance)
+                continue;
+            if (std::abs(uv.x * uw.y - uv.y * uw.x) / length <= tolerance && along < nearest) {
+                nearest = along;
+                between = w;
+            }
+        }
+    }
+    if (between < vertices.size() && depth < 64) {
+        const bool first = RecoverSegment(u, between, outEdges, depth + 1);
+        const bool second = RecoverSegment(between, v, outEdges, depth + 1);
+        return first && second;
+    }
+
+    auto fix = [&](unsigned int t, int e) {
+        const Triangle& triangle = triangles[t];
+        triangles[t].fixed |= static_cast<unsigned char>(1 << e);
+        const unsigned int w = triangle.n[e];
+        if (w != None)
+            triangles[w].fixed |= static_cast<unsigned char>(1 << EdgeIndex(w, triangle.v[(e + 1) % 3], triangle.v[e]));
+        outEdges.push_back({ u, v });
+    };
+    unsigned int t;
+    int e;
+    if (FindEdge(u, v, t, e)) {
+        fix(t, e);
+        return true;
+    }
+
+    // Signs compared rather than multiplied, so tiny exact determinants cannot underflow
+    auto opposite = [](double x, double y) { return (x < 0.0 && y > 0.0) || (x > 0.0 && y < 0.0); };
+    auto crosses = [&](unsigned int a, unsigned int b) {
+        if (a == u || a == v || b == u || b == v)
+            return false;
+        return opposite(Orient(u, v, a), Orient(u, v, b)) && opposite(Orient(a, b, u), Orient(a, b, v));
+    };
+
+    // The edges crossing the segment, each inner edge seen once from its lower
+    // triangle; a cut face has few triangles, so a scan beats walking along the
+    // segment and cannot get stuck on vertices next to it
+    crossing.clear();
+    for (unsigned int s = 0; s < triangles.size(); ++s) {
+        for (int k = 0; k < 3; ++k) {
+            const unsigned int w = triangles[s].n[k];
+            if (w == None || w < s || !crosses(triangles[s].v[k], triangles[s].v[(k + 1) % 3]))
+                continue;
+            if (Bit(triangles[s].fixed, k))
+                return false; // Crosses another segment
+            crossing.push_back({ triangles[s].v[k], triangles[s].v[(k + 1) % 3] });
+        }
+    }
+
+    // Sloan: flip each crossing edge whose quad is convex; one that still crosses
+    // goes back in the queue, the rest are checked for Delaunay once it is in
+    pending.clear();
+    const size_t maxSteps = 4 * crossing.size() * crossing.size() + 64;
+    size_t head = 0;
+    for (size_t step = 0; head < crossing.size() && step < maxSteps; ++step) {
+        const Segment edge = crossing[head++];
+        if (!FindEdge(edge.first, edge.second, t, e))
+            continue;
+        const Triangle& triangle = triangles[t];
+        const unsigned int a = triangle.v[e], b = triangle.v[(e + 1) % 3], c = triangle.v[(e + 2) % 3];
+        const unsigned int w = triangle.n[e];
+        const unsigned int d = triangles[w].v[(EdgeIndex(w, b, a) + 2) % 3];
+        if (Orient(c, a, d) <= 0.0 || Orient(d, b, c) <= 0.0) {
+            crossing.push_back(edge);
+            continue;
+        }
+        Flip(t, e);
+        if (crosses(c, d))
+            crossing.push_back({ c, d });
+        else
+            pending.push_back({ c, d });
+    }
+
+    const bool recovered = FindEdge(u, v, t, e);
+    if (recovered)
+        fix(t, e);
+    Legalize();
+    return recovered;
+}
+
+void TriangleSplitter::Split(const glm::vec3 corners[3], const std::vector<glm::vec3>& points, const std::vector<unsigned char>& pointEdges,
+    const std::vector<Segment>& segments, float splitTolerance,
+    std::vector<unsigned int>& outTriangles, std::vector<unsigned int>& outPointVertex, std::vector<Segment>& outEdges)
+{
+    // Project, mirroring when the normal points down the dropped axis so that
+    // the corners run counter-clockwise
+    const glm::vec3 normal = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+    const glm::vec3 absNormal = glm::abs(normal);
+    axis = absNormal.x > absNormal.y ? (absNormal.x > absNormal.z ? 0 : 2) : (absNormal.y > absNormal.z ? 1 : 2);
+    mirror = normal[axis] < 0.0f ? -1.0f : 1.0f;
+    tolerance = splitTolerance;
+    Run(corners, points, pointEdges, segments, outTriangles, outPointVertex, outEdges);
+}
+
+void TriangleSplitter::Split(const ImplicitPoints& points, const std::vector<glm::vec3>& rounded, const unsigned int corners[3],
+    const std::vector<unsigned int>& pointIds, const std::vector<unsigned char>& pointEdges, const std::vector<Segment>& segments,
+    std::vector<unsigned int>& outTriangles, std::vector<unsigned int>& outPointVertex, std::vector<Segment>& outEdges)
+{
+    int sign;
+    axis = points.ProjectionAxis(corners, sign);
+    mirror = sign < 0 ? -1.0f : 1.0f;
+    tolerance = 0.0f;
+    ids.assign(corners, corners + 3);
+    ids.insert(ids.end(), pointIds.begin(), pointIds.end());
+    roundedPoints.clear();
+    for (unsigned int id : pointIds)
+        roundedPoints.push_back(rounded[id]);
+    const glm::vec3 roundedCorners[3] = { rounded[corners[0]], rounded[corners[1]], rounded[corners[2]] };
+    implicit = &points;
+    Run(roundedCorners, roundedPoints, pointEdges, segments, outTriangles, outPointVertex, outEdges);
+    implicit = nullptr;
+}
+
+void TriangleSplitter::Run(const glm::vec3 corners[3], const std::vector<glm::vec3>& points, const std::vector<unsigned char>& pointEdges,
+    const std::vector<Segment>& segments,
+    std::vector<unsigned int>& outTriangles, std::vector<unsigned int>& outPointVertex, std::vector<Segment>& outEdges)
+{
+    outTriangles.clear();
+    outPointVertex.clear();
+    outEdges.clear();
+    triangles.clear();
+    pending.clear();
+    lastTriangle = 0;
+    failedSegments = 0;
+
+    // Step 1: projected vertices, along the axis and mirror Split chose
+    const size_t vertexCount = 3 + points.size();
+    vertices.resize(vertexCount);
+    boundaryMask.assign(vertexCount, 0);
+    merged.assign(vertexCount, 0);
+    vertexTriangle.assign(vertexCount, 0);
+    for (unsigned int i = 0; i < vertexCount; ++i) {
+        glm::vec2 p = Project(i < 3 ? corners[i] : points[i - 3], axis);
+        p.x *= mirror;
+        vertices[i] = p;
+    }
+    for (unsigned int c = 0; c < 3; ++c)
+        boundaryMask[c] = static_cast<unsigned char>((1 << c) | (1 << ((c + 2) % 3)));
+
+    triangles.push_back({ { 0, 1, 2 }, { None, None, None }, 0 });
+    if (Orient(0, 1, 2) <= 0.0) {
+        // Degenerate: keep the triangle, points go to their nearest corner
+        outTriangles.assign({ 0, 1, 2 });
+        for (const glm::vec3& point : points) {
+            unsigned int nearest = 0;
+            for (unsigned int c = 1; c < 3; ++c) {
+                if (glm::length(point - corners[c]) < glm::length(point - corners[nearest]))
+                    nearest = c;
+            }
+            outPointVertex.push_back(nearest);
+        }
+        return;
+    }
+
+    // Step 2: edge points, walking each edge from its first corner and splitting
+    // the sub-edge that is left ahead
+    auto along = [&](unsigned int i) {
+        const unsigned int e = pointEdges[i];
+        const glm::vec3 edge = corners[(e + 1) % 3] - corners[e];
+        return glm::dot(points[i] - corners[e], edge) / glm::dot(edge, edge);
+    };
+    order.clear();
+    for (unsigned int i = 0; i < points.size(); ++i) {
+        if (pointEdges[i] < Interior)
+            order.push_back(i);
+    }
+    // Exact: compared along the coordinate the edge changes most in
+    auto before = [&](unsigned int l, unsigned int r) {
+        if (!implicit)
+            return along(l) < along(r);
+        const unsigned int e = pointEdges[l];
+        const glm::vec3 edge = corners[(e + 1) % 3] - corners[e];
+        const glm::vec3 absEdge = glm::abs(edge);
+        const int k = absEdge.x > absEdge.y ? (absEdge.x > absEdge.z ? 0 : 2) : (absEdge.y > absEdge.z ? 1 : 2);
+        return implicit->Compare(ids[3 + l], ids[3 + r], k) * (edge[k] < 0.0f ? -1 : 1) < 0;
+    };
+    std::sort(order.begin(), order.end(), [&](unsigned int l, unsigned int r) {
+        return pointEdges[l] != pointEdges[r] ? pointEdges[l] < pointEdges[r] : before(l, r);
+        });
+    unsigned int previous = 0;
+    for (size_t k = 0; k < order.size(); ++k) {
+        const unsigned int i = order[k];
+        const unsigned int e = pointEdges[i];
+        if (k == 0 || pointEdges[order[k - 1]] != e)
+            previous = e;
+        const unsigned int vertex = 3 + i;
+        if (!implicit) {
+            const glm::vec2 edge = vertices[(e + 1) % 3] - vertices[e];
+            vertices[vertex] = vertices[e] + std::clamp(along(i), 0.0f, 1.0f) * edge;
+        }
+        boundaryMask[vertex] = static_cast<unsigned char>(1 << e);
+        SplitEdge(previous, (e + 1) % 3, vertex);
+        previous = vertex;
+    }
+
+    // Step 3: interior points
+    outPointVertex.resize(points.size());
+    for (unsigned int i = 0; i < points.size(); ++i)
+        outPointVertex[i] = pointEdges[i] < Interior ? 3 + i : Insert(3 + i);
+
+    // Step 4: segments
+    auto local = [&](unsigned int id) { return id < 3 ? id : outPointVertex[id - 3]; };
+    for (const Segment& segment : segments) {
+        if (!RecoverSegment(local(segment.first), local(segment.second), outEdges, 0))
+            failedSegments++;
+    }
+
+    outTriangles.reserve(triangles.size() * 3);
+    for (const Triangle& triangle : triangles)
+        outTriangles.insert(outTriangles.end(), triangle.v, triangle.v + 3);
+}
+
+void TriangleSplitter::LabelBySides(const bool cornerInside[3], std::vector<unsigned char>& outInside)
+{
+    // Flood fill from the first triangle, flipping across recovered segments;
+    // unreached triangles (none, unless the split failed) stay at 2 until then
+    outInside.assign(triangles.size(), 2);
+    stack.clear();
+    outInside[0] = 0;
+    stack.push_back(0);
+    while (!stack.empty()) {
+        const unsigned int t = stack.back();
+        stack.pop_back();
+        for (int e = 0; e < 3; ++e) {
+            const unsigned int u = triangles[t].n[e];
+            if (u == None || outInside[u] != 2)
+                continue;
+            outInside[u] = static_cast<unsigned char>(outInside[t] ^ Bit(triangles[t].fixed, e));
+            stack.push_back(u);
+        }
+    }
+
+    // The corners vote on whether the first triangle is inside
+    int votes = 0;
+    for (unsigned int c = 0; c < 3; ++c) {
+        const unsigned char side = outInside[vertexTriangle[c]];
+        if (side != 2)
+            votes += (side != 0) != cornerInside[c] ? 1 : -1;
+    }
+    const unsigned char flip = votes > 0 ? 1 : 0;
+    for (unsigned char& side : outInside)
+        side = side == 2 ? 0 : static_cast<unsigned char>(side ^ flip);
+}
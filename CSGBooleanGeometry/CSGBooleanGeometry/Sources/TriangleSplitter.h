@@ -0,0 +1,106 @@
+#pragma once
+#include "glm.hpp"
+#include <utility>
+#include <vector>
+
+class ImplicitPoints;
+
+// Re-triangulates one triangle so that given points become vertices and given
+// segments between them become edges; used to split faces along intersection
+// curves. The result is the constrained Delaunay triangulation of the points,
+// computed in 2D after dropping the axis where the triangle's normal is largest.
+// Points known to lie on the triangle's edges are placed on them exactly, in
+// order, so a neighbour given the same edge points splits the shared edge the
+// same way. Interior points are then inserted one at a time, located by walking
+// the neighbour links, with Lawson flips restoring the Delaunay property. Each
+// segment is recovered by flipping the edges that cross it (Sloan) and the
+// flipped region is made Delaunay again, so no vertices beyond the given points
+// are created.
+// All working storage lives in the splitter and keeps its capacity between
+// calls, so a splitter reused across many triangles stops allocating once it
+// has seen the largest one; one splitter per thread.
+class TriangleSplitter
+{
+public:
+    using Segment = std::pair<unsigned int, unsigned int>;
+    static constexpr unsigned char Interior = 3;
+
+    // corners: the triangle. points: positions on or inside it; pointEdges[i] is
+    // the edge points[i] lies on (edge e runs from corner e to corner e + 1) or
+    // Interior. segments: pairs of local vertex ids to become edges, where 0-2 are
+    // the corners and 3 + i is points[i]. tolerance: 2D distance below which an
+    // interior point merges with a vertex or lands on an edge.
+    // Writes triangles as local vertex ids, wound like corners; outPointVertex[i]
+    // is the vertex points[i] ended up as (3 + i unless it merged). outEdges
+    // receives the recovered segments as local vertex pairs.
+    void Split(const glm::vec3 corners[3], const std::vector<glm::vec3>& points, const std::vector<unsigned char>& pointEdges,
+        const std::vector<Segment>& segments, float tolerance,
+        std::vector<unsigned int>& outTriangles, std::vector<unsigned int>& outPointVertex, std::vector<Segment>& outEdges);
+
+    // Exact variant: corners are input ids and points are point ids of implicit,
+    // and every orientation is decided exactly on them; rounded[id] are their
+    // rounded positions, which only steer point location and the Delaunay flips.
+    // Points are neither merged nor moved, so they must be distinct, and their
+    // pointEdges must come from the exact EdgeOf.
+    void Split(const ImplicitPoints& implicit, const std::vector<glm::vec3>& rounded, const unsigned int corners[3],
+        const std::vector<unsigned int>& points, const std::vector<unsigned char>& pointEdges, const std::vector<Segment>& segments,
+        std::vector<unsigned int>& outTriangles, std::vector<unsigned int>& outPointVertex, std::vector<Segment>& outEdges);
+
+    // Edge of triangle corners that p lies on, within tolerance and strictly
+    // between its ends, or Interior; gives Split its pointEdges
+    static unsigned char EdgeOf(const glm::vec3 corners[3], const glm::vec3& p, float tolerance);
+    // The same exactly, for a point known to lie on the triangle and not on a corner
+    static unsigned char EdgeOf(const ImplicitPoints& implicit, const unsigned int corners[3], unsigned int point);
+
+    // Segments that could not be recovered (crossing another segment), from the last Split
+    size_t FailedSegments() const { return failedSegments; }
+
+    // Sides of the recovered segments in the last Split, as outInside[t] for each
+    // output triangle: the label flips across every segment, and the corners'
+    // sides, by majority, tell which side is inside.
+    void LabelBySides(const bool cornerInside[3], std::vector<unsigned char>& outInside);
+
+private:
+    static constexpr unsigned int None = ~0u;
+
+    struct Triangle {
+        unsigned int v[3];        // Counter-clockwise in 2D
+        unsigned int n[3];        // Triangle across edge e, from v[e] to v[e + 1]; None on the outer boundary
+        unsigned char fixed;      // Bit e set when edge e is a recovered segment
+    };
+
+    double Orient(unsigned int a, unsigned int b, unsigned int c) const;
+    double InCircle(unsigned int a, unsigned int b, unsigned int c, unsigned int d) const;
+    bool OnBoundary(unsigned int a, unsigned int b) const { return (boundaryMask[a] & boundaryMask[b]) != 0; }
+    int EdgeIndex(unsigned int t, unsigned int a, unsigned int b) const;
+    bool FindEdge(unsigned int a, unsigned int b, unsigned int& outTriangle, int& outEdge) const;
+    void Relink(unsigned int t);
+    void Flip(unsigned int t, int e);
+    void Legalize();
+    unsigned int Locate(unsigned int vertex, int& outEdge, float& outDistance) const;
+    unsigned int Insert(unsigned int vertex);
+    void SplitTriangle(unsigned int t, unsigned int vertex);
+    void SplitEdge(unsigned int a, unsigned int b, unsigned int vertex);
+    bool RecoverSegment(unsigned int u, unsigned int v, std::vector<Segment>& outEdges, int depth);
+    void Run(const glm::vec3 corners[3], const std::vector<glm::vec3>& points, const std::vector<unsigned char>& pointEdges,
+        const std::vector<Segment>& segments,
+        std::vector<unsigned int>& outTriangles, std::vector<unsigned int>& outPointVertex, std::vector<Segment>& outEdges);
+
+    std::vector<glm::vec2> vertices;
+    std::vector<unsigned char> boundaryMask;  // Bit e set for vertices on the triangle's edge e
+    std::vector<unsigned char> merged;        // Point vertices that merged into another and are unused
+    std::vector<unsigned int> vertexTriangle; // A triangle around each inserted vertex
+    std::vector<Triangle> triangles;
+    std::vector<unsigned int> order;          // Scratch: edge points sorted along their edge
+    std::vector<Segment> pending;             // Scratch: edges to check for the Delaunay property
+    std::vector<Segment> crossing;            // Scratch: edges crossing a segment being recovered
+    std::vector<unsigned int> stack;          // Scratch: flood fill of LabelBySides
+    unsigned int lastTriangle = 0;            // Where the next point location starts walking
+    float tolerance = 0.0f;
+    int axis = 2;                             // Dropped by the projection
+    float mirror = 1.0f;                      // -1 when the projection is mirrored to wind the corners counter-clockwise
+    const ImplicitPoints* implicit = nullptr; // Set during an exact Split
+    std::vector<unsigned int> ids;            // Exact Split: point id of each vertex
+    std::vector<glm::vec3> roundedPoints;     // Exact Split scratch
+    size_t failedSegments = 0;
+};
@@ -0,0 +1,382 @@
+#include "VertexWelder.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+namespace {
+    uint64_t Mix(uint64_t h)
+    {
+        // splitmix64 finalizer
+        h ^= h >> 30;
+        h *= 0xbf58476d1ce4e5b9ull;
+        h ^= h >> 27;
+        h *= 0x94d049bb133111ebull;
+        h ^= h >> 31;
+        return h;
+    }
+
+    int64_t FloatBits(float value)
+    {
+        if (value == 0.0f)
+            value = 0.0f; // -0 and +0 weld together
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return static_cast<int64_t>(bits);
+    }
+}
+
+VertexWelder::VertexWelder(float tolerance, size_t expectedPoints)
+    : tolerance(tolerance > 0.0f ? tolerance : 0.0f),
+    toleranceSquared(this->tolerance * this->tolerance),
+    inverseCellSize(this->tolerance > 0.0f ? 1.0 / (CellSizeInTolerances * this->tolerance) : 0.0),
+    exact(!(this->tolerance > 0.0f))
+{
+    Rehash(16);
+    Reserve(expectedPoints);
+}
+
+void VertexWelder::Reserve(size_t count)
+{
+    points.reserve(count);
+    next.reserve(count);
+    size_t capacity = cells.size();
+    while (capacity < count * 2)
+        capacity *= 2;
+    if (capacity != cells.size())
+        Rehash(capacity);
+}
+
+void VertexWelder::Clear()
+{
+    points.clear();
+    next.clear();
+    for (Cell& cell : cells)
+        cell.head = NotFound;
+    usedCells = 0;
+}
+
+int64_t VertexWelder::Quantize(double value) const
+{
+    // Clamp far outside the grid instead of overflowing; such cells just merge
+    const double limit = 4.0e18;
+    double q = std::floor(value * inverseCellSize);
+    if (q > limit) q = limit;
+    if (q < -limit) q = -limit;
+    return static_cast<int64_t>(q);
+}
+
+VertexWelder::CellKey VertexWelder::CellOf(const glm::vec3& p) const
+{
+    if (exact)
+        return { FloatBits(p.x), FloatBits(p.y), FloatBits(p.z) };
+    return { Quantize(p.x), Quantize(p.y), Quantize(p.z) };
+}
+
+size_t VertexWelder::Slot(const CellKey& key) const
+{
+    uint64_t h = Mix(static_cast<uint64_t>(key.x) * 0x9e3779b97f4a7c15ull
+        ^ static_cast<uint64_t>(key.y) * 0xc2b2ae3d27d4eb4full
+        ^ static_cast<uint64_t>(key.z) * 0x165667b19e3779f9ull);
+    return static_cast<size_t>(h) & (cells.size() - 1);
+}
+
+unsigned int VertexWelder::FindInCell(const CellKey& key, const glm::vec3& p) const
+{
+    const size_t mask = cells.size() - 1;
+    for (size_t slot = Slot(key); ; slot = (slot + 1) & mask) {
+        const Cell& cell = cells[slot];
+        if (cell.head == NotFound)
+            return NotFound;
+        if (!(cell.key == key))
+            continue;
+
+        // Chains run newest to oldest, keep the oldest match
+        unsigned int best = NotFound;
+        for (unsigned int id = cell.head; id != NotFound; id = next[id]) {
+            glm::vec3 d = points[id] - p;
+            if (exact ? (points[id] == p) : (glm::dot(d, d) <= toleranceSquared))
+                best = id;
+        }
+        return best;
+    }
+}
+
+unsigned int VertexWelder::Find(const glm::vec3& p) const
+{
+    if (exact)
+        return FindInCell(CellOf(p), p);
+
+    // Cells overlapped by the tolerance box around p: one or two per axis
+    const double t = tolerance;
+    const int64_t x0 = Quantize(p.x - t), x1 = Quantize(p.x + t);
+    const int64_t y0 = Quantize(p.y - t), y1 = Quantize(p.y + t);
+    const int64_t z0 = Quantize(p.z - t), z1 = Quantize(p.z + t);
+
+    unsigned int best = NotFound;
+    for (int64_t x = x0; x <= x1; ++x) {
+        for (int64_t y = y0; y <= y1; ++y) {
+            for (int64_t z = z0; z <= z1; ++z) {
+                unsigned int id = FindInCell({ x, y, z }, p);
+                if (id < best)
+                    best = id;
+            }
+        }
+    }
+    return best;
+}
+
+unsigned int VertexWelder::Insert(const glm::vec3& p)
+{
+    bool inserted;
+    return Insert(p, inserted);
+}
+
+unsigned int VertexWelder::Insert(const glm::vec3& p, bool& inserted)
+{
+    unsigned int id = Find(p);
+    inserted = id == NotFound;
+    if (!inserted)
+        return id;
+
+    id = static_cast<unsigned int>(points.size());
+    points.push_back(p);
+    next.push_back(NotFound);
+    InsertIntoCell(CellOf(p), id);
+    return id;
+}
+
+void VertexWelder::InsertIntoCell(const CellKey& key, unsigned int id)
+{
+    if ((usedCells + 1) * 2 > cells.size())
+        Rehash(cells.size() * 2);
+
+    const size_t mask = cells.size() - 1;
+    for (size_t slot = Slot(key); ; slot = (slot + 1) & mask) {
+        Cell& cell = cells[slot];
+        if (cell.head == NotFound) {
+            cell.key = key;
+            cell.head = id;
+            ++usedCells;
+            return;
+        }
+        if (cell.key == key) {
+            next[id] = cell.head;
+            cell.head = id;
+            return;
+        }
+    }
+}
+
+void VertexWelder::Rehash(size_t capacity)
+{
+    std::vector<Cell> old;
+    old.swap(cells);
+    cells.assign(capacity, Cell{ { 0, 0, 0 }, NotFound });
+
+    const size_t mask = capacity - 1;
+    for (const Cell& cell : old) {
+        if (cell.head == NotFound)
+            continue;
+        size_t slot = Slot(cell.key);
+        while (cells[slot].head != NotFound)
+            slot = (slot + 1) & mask;
+        cells[slot] = cell;
+    }
+}
+
+void VertexWelder::Weld(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices, float tolerance,
+    std::vector<glm::vec3>& outPositions, std::vector<unsigned int>& outIndices, unsigned int threadCount)
+{
+    if (threadCount == 0)
+        threadCount = positions.size() >= ParallelThreshold ? Parallel::ThreadCount() : 1;
+    if (threadCount > 1) {
+        WeldParallel(positions, indices, tolerance, outPositions, outIndices, threadCount);
+        return;
+    }
+
+    VertexWelder welder(tolerance, positions.size());
+    outIndices.resize(indices.size());
+
+    // Each source vertex is welded once, on its first reference; inserting the
+    // same point again would return the same id
+    std::vector<unsigned int> remap(positions.size(), NotFound);
+    for (size_t i = 0; i < indices.size(); ++i) {
+        unsigned int originalIndex = indices[i];
+        unsigned int& id = remap[originalIndex];
+        if (id == NotFound)
+            id = welder.Insert(positions[originalIndex]);
+        outIndices[i] = id;
+    }
+
+    outPositions = std::move(welder.points);
+}
+
+// Parallel weld that reproduces the sequential result exactly.
+// Space is cut into slabs along x at cell boundaries that no tolerance box
+// crosses, so no two points of different slabs can ever weld. Each slab is then
+// welded on its own, in first-reference order, and picks the same
+// representatives the sequential pass would. Global ids follow from a prefix
+// sum over the representative flags, since the sequential pass numbers
+// representatives in first-reference order as well.
+void VertexWelder::WeldParallel(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices, float tolerance,
+    std::vector<glm::vec3>& outPositions, std::vector<unsigned int>& outIndices, unsigned int threadCount)
+{
+    const VertexWelder grid(tolerance);
+    const double t = grid.tolerance;
+
+    // Step 1: Distinct source vertices in first-reference order
+    std::vector<unsigned int> order;
+    std::vector<unsigned int> orderOf(positions.size(), NotFound);
+    order.reserve(positions.size());
+    for (unsigned int index : indices) {
+        if (orderOf[index] == NotFound) {
+            orderOf[index] = static_cast<unsigned int>(order.size());
+            order.push_back(index);
+        }
+    }
+    const size_t vertexCount = order.size();
+
+    // Step 2: x cell of every vertex
+    std::vector<int64_t> cellX(vertexCount);
+    Parallel::ForChunks(vertexCount, threadCount, [&](size_t begin, size_t end, unsigned int) {
+        for (size_t k = begin; k < end; ++k)
+            cellX[k] = grid.CellOf(positions[order[k]]).x;
+        });
+
+    // Step 3: Candidate cuts at quantiles of a sample of the x cells. Each
+    // candidate opens a window of consecutive boundaries to pick a clean one from.
+    const size_t CutWindow = 64;
+    const size_t partitionTarget = std::min<size_t>(size_t(threadCount) * 4, std::max<size_t>(1, vertexCount / 4096));
+    std::vector<int64_t> sample;
+    const size_t stride = std::max<size_t>(1, vertexCount / 4096);
+    for (size_t k = 0; k < vertexCount; k += stride)
+        sample.push_back(cellX[k]);
+    std::sort(sample.begin(), sample.end());
+
+    std::vector<int64_t> windows;
+    for (size_t p = 1; p < partitionTarget && !sample.empty(); ++p)
+        windows.push_back(sample[p * sample.size() / partitionTarget]);
+    windows.erase(std::unique(windows.begin(), windows.end()), windows.end());
+
+    // Step 4: Mark boundaries inside the windows that some tolerance box crosses.
+    // Boundary b separates cell b - 1 from cell b.
+    std::vector<std::vector<unsigned char>> dirtyPerChunk(threadCount, std::vector<unsigned char>(windows.size() * CutWindow, 0));
+    if (!grid.exact && !windows.empty()) {
+        Parallel::ForChunks(vertexCount, threadCount, [&](size_t begin, size_t end, unsigned int chunk) {
+            std::vector<unsigned char>& dirty = dirtyPerChunk[chunk];
+            auto mark = [&](int64_t boundary) {
+                auto it = std::upper_bound(windows.begin(), windows.end(), boundary);
+                while (it != windows.begin()) {
+                    --it;
+                    if (boundary - *it >= static_cast<int64_t>(CutWindow))
+                        break;
+                    dirty[(it - windows.begin()) * CutWindow + static_cast<size_t>(boundary - *it)] = 1;
+                }
+                };
+            for (size_t k = begin; k < end; ++k) {
+                const double x = positions[order[k]].x;
+                if (grid.Quantize(x - t) != cellX[k]) mark(cellX[k]);
+                if (grid.Quantize(x + t) != cellX[k]) mark(cellX[k] + 1);
+            }
+            });
+    }
+
+    // Step 5: First clean boundary of every window; a window without one is dropped
+    std::vector<int64_t> cuts;
+    for (size_t w = 0; w < windows.size(); ++w) {
+        for (size_t offset = 0; offset < CutWindow; ++offset) {
+            bool dirty = false;
+            for (const auto& chunkDirty : dirtyPerChunk)
+                dirty = dirty || chunkDirty[w * CutWindow + offset] != 0;
+            if (!dirty) {
+                cuts.push_back(windows[w] + static_cast<int64_t>(offset));
+                break;
+            }
+        }
+    }
+    std::sort(cuts.begin(), cuts.end());
+    cuts.erase(std::unique(cuts.begin(), cuts.end()), cuts.end());
+    const size_t partitionCount = cuts.size() + 1;
+
+    // Step 6: Stable counting sort of the vertices by partition
+    std::vector<unsigned int> partitionOf(vertexCount);
+    std::vector<std::vector<size_t>> countPerChunk(threadCount, std::vector<size_t>(partitionCount + 1, 0));
+    Parallel::ForChunks(vertexCount, threadCount, [&](size_t begin, size_t end, unsigned int chunk) {
+        for (size_t k = begin; k < end; ++k) {
+            partitionOf[k] = static_cast<unsigned int>(std::upper_bound(cuts.begin(), cuts.end(), cellX[k]) - cuts.begin());
+            ++countPerChunk[chunk][partitionOf[k]];
+        }
+        });
+
+    std::vector<size_t> partitionStart(partitionCount + 1, 0);
+    size_t running = 0;
+    for (size_t p = 0; p < partitionCount; ++p) {
+        partitionStart[p] = running;
+        for (unsigned int chunk = 0; chunk < threadCount; ++chunk) {
+            size_t chunkCount = countPerChunk[chunk][p];
+            countPerChunk[chunk][p] = running; // Becomes the chunk's write cursor
+            running += chunkCount;
+        }
+    }
+    partitionStart[partitionCount] = running;
+
+    std::vector<unsigned int> members(vertexCount);
+    Parallel::ForChunks(vertexCount, threadCount, [&](size_t begin, size_t end, unsigned int chunk) {
+        std::vector<size_t>& cursor = countPerChunk[chunk];
+        for (size_t k = begin; k < end; ++k)
+            members[cursor[partitionOf[k]]++] = static_cast<unsigned int>(k);
+        });
+
+    // Step 7: Weld every partition on its own; repOf[k] is the order position of
+    // the representative vertex k welds to
+    std::vector<unsigned int> repOf(vertexCount);
+    std::atomic<size_t> nextPartition{ 0 };
+    Parallel::ForChunks(threadCount, threadCount, [&](size_t, size_t, unsigned int) {
+        std::vector<unsigned int> localReps;
+        for (size_t p = nextPartition++; p < partitionCount; p = nextPartition++) {
+            VertexWelder welder(tolerance, partitionStart[p + 1] - partitionStart[p]);
+            localReps.clear();
+            for (size_t m = partitionStart[p]; m < partitionStart[p + 1]; ++m) {
+                unsigned int k = members[m];
+                bool inserted;
+                unsigned int id = welder.Insert(positions[order[k]], inserted);
+                if (inserted)
+                    localReps.push_back(k);
+                repOf[k] = localReps[id];
+            }
+        }
+        });
+
+    // Step 8: Exclusive prefix sum over the representative flags gives global ids
+    std::vector<unsigned int> idOf(vertexCount);
+    std::vector<unsigned int> repsPerChunk(threadCount + 1, 0);
+    Parallel::ForChunks(vertexCount, threadCount, [&](size_t begin, size_t end, unsigned int chunk) {
+        unsigned int count = 0;
+        for (size_t k = begin; k < end; ++k)
+            count += repOf[k] == k;
+        repsPerChunk[chunk + 1] = count;
+        });
+    for (unsigned int chunk = 0; chunk < threadCount; ++chunk)
+        repsPerChunk[chunk + 1] += repsPerChunk[chunk];
+
+    outPositions.resize(repsPerChunk[threadCount]);
+    Parallel::ForChunks(vertexCount, threadCount, [&](size_t begin, size_t end, unsigned int chunk) {
+        unsigned int id = repsPerChunk[chunk];
+        for (size_t k = begin; k < end; ++k) {
+            if (repOf[k] == k) {
+                idOf[k] = id;
+                outPositions[id++] = positions[order[k]];
+            }
+        }
+        });
+
+    // Step 9: Remap the index buffer
+    outIndices.resize(indices.size());
+    Parallel::ForChunks(indices.size(), threadCount, [&](size_t begin, size_t end, unsigned int) {
+        for (size_t i = begin; i < end; ++i)
+            outIndices[i] = idOf[repOf[orderOf[indices[i]]]];
+        });
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include "glm.hpp"
+#include <cstdint>
+#include <vector>
+
+// Tolerance-based point welding on a quantized grid.
+// Points are bucketed in cubic cells much larger than the tolerance, so the
+// tolerance box around a query usually lies in a single cell and never touches
+// more than 8. Cells live in an open-addressing table and points of a cell are
+// chained through a flat index array, so inserting never allocates per point.
+// A point welds to the earliest inserted point within tolerance (Euclidean);
+// a tolerance of 0 welds bit-identical positions only. Used both for mesh
+// welding and as the tolerance point set for deduplicating intersection points.
+class VertexWelder
+{
+public:
+    static constexpr float DefaultTolerance = 1e-6f;
+    static constexpr unsigned int NotFound = 0xFFFFFFFFu;
+
+    explicit VertexWelder(float tolerance = DefaultTolerance, size_t expectedPoints = 0);
+
+    // Id of the welded point within tolerance of p, inserting p if there is none
+    unsigned int Insert(const glm::vec3& p);
+    unsigned int Insert(const glm::vec3& p, bool& inserted);
+    // Id of the welded point within tolerance of p, or NotFound
+    unsigned int Find(const glm::vec3& p) const;
+
+    const std::vector<glm::vec3>& Points() const { return points; }
+    size_t Size() const { return points.size(); }
+    float Tolerance() const { return tolerance; }
+    void Reserve(size_t count);
+    void Clear();
+
+    // Welds the vertices referenced by an indexed triangle list. Welded points are
+    // numbered by first reference, outIndices[i] is the id of positions[indices[i]].
+    // threadCount 1 runs sequentially, 0 uses all hardware threads once the input
+    // is large enough to pay for them. Every thread count gives the same result.
+    static void Weld(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices, float tolerance,
+        std::vector<glm::vec3>& outPositions, std::vector<unsigned int>& outIndices, unsigned int threadCount = 1);
+
+private:
+    // Cell edge in multiples of the tolerance; larger cells mean fewer cells per query
+    static constexpr double CellSizeInTolerances = 16.0;
+    // Below this many vertices the parallel weld costs more than it saves
+    static constexpr size_t ParallelThreshold = 1 << 16;
+
+    static void WeldParallel(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices, float tolerance,
+        std::vector<glm::vec3>& outPositions, std::vector<unsigned int>& outIndices, unsigned int threadCount);
+
+    struct CellKey {
+        int64_t x, y, z;
+        bool operator==(const CellKey& other) const { return x == other.x && y == other.y && z == other.z; }
+    };
+
+    struct Cell {
+        CellKey key;
+        unsigned int head; // Most recently inserted point of the cell, NotFound for an empty slot
+    };
+
+    CellKey CellOf(const glm::vec3& p) const;
+    int64_t Quantize(double value) const;
+    size_t Slot(const CellKey& key) const;
+    unsigned int FindInCell(const CellKey& key, const glm::vec3& p) const;
+    void InsertIntoCell(const CellKey& key, unsigned int id);
+    void Rehash(size_t capacity);
+
+    float tolerance;
+    float toleranceSquared;
+    double inverseCellSize;
+    bool exact;
+
+    std::vector<glm::vec3> points;
+    std::vector<unsigned int> next; // Chain to the previous point of the same cell
+    std::vector<Cell> cells;        // Power-of-two sized open-addressing table
+    size_t usedCells = 0;
+};
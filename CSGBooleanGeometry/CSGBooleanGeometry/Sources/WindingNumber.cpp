@@ -0,0 +1,171 @@
+#include "WindingNumber.h"
+#include "MeshData.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // BVH depth is capped at 60, and a traversal holds at most depth + 2 nodes
+    constexpr unsigned int StackSize = 64;
+    constexpr float FourPi = 12.566370614359172f;
+
+    // Signed solid angle of triangle abc seen from the origin (Van Oosterom and Strackee)
+    float TriangleSolidAngle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c)
+    {
+        const float la = glm::length(a);
+        const float lb = glm::length(b);
+        const float lc = glm::length(c);
+        const float numerator = glm::dot(a, glm::cross(b, c));
+        const float denominator = la * lb * lc + glm::dot(a, b) * lc + glm::dot(b, c) * la + glm::dot(c, a) * lb;
+        return 2.0f * std::atan2(numerator, denominator);
+    }
+}
+
+const WindingNumber& WindingNumber::ForMesh(const MeshData& mesh)
+{
+    WindingNumber& winding = mesh.winding;
+    if (winding.sourceRevision != mesh.revision) {
+        winding.Build(mesh);
+        winding.sourceRevision = mesh.revision;
+    }
+    return winding;
+}
+
+void WindingNumber::Build(const MeshData& mesh)
+{
+    Build(BVH::ForMesh(mesh), mesh.positions, mesh.indices);
+}
+
+void WindingNumber::Build(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices)
+{
+    BVH bvh;
+    bvh.Build(positions, indices);
+    Build(bvh, positions, indices);
+}
+
+void WindingNumber::Build(const BVH& bvh, const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices)
+{
+    nodes = bvh.Nodes();
+    dipoles.assign(nodes.size(), Dipole());
+    corners.clear();
+    if (nodes.empty())
+        return;
+
+    // Leaves address runs of the triangle order; store the corners in that order
+    const std::vector<unsigned int>& order = bvh.TriangleOrder();
+    corners.resize(order.size() * 3);
+    for (size_t slot = 0; slot < order.size(); ++slot) {
+        for (int k = 0; k < 3; ++k)
+            corners[slot * 3 + k] = positions[indices[size_t(order[slot]) * 3 + k]];
+    }
+    BuildDipoles(0);
+}
+
+float WindingNumber::BuildDipoles(unsigned int nodeIndex)
+{
+    const BVHNode& node = nodes[nodeIndex];
+    Dipole& dipole = dipoles[nodeIndex];
+    const glm::vec3 boxCenter = (node.boundsMin + node.boundsMax) * 0.5f;
+
+    float area = 0.0f;
+    glm::vec3 weightedCenter(0.0f);
+    dipole.normal = glm::vec3(0.0f);
+    dipole.radius = 0.0f;
+
+    if (node.IsLeaf()) {
+        const glm::vec3* first = corners.data() + size_t(node.leftFirst) * 3;
+        for (unsigned int t = 0; t < node.triangleCount; ++t) {
+            const glm::vec3* v = first + t * 3;
+            const glm::vec3 areaVector = 0.5f * glm::cross(v[1] - v[0], v[2] - v[0]);
+            const float triangleArea = glm::length(areaVector);
+            dipole.normal += areaVector;
+            weightedCenter += triangleArea * (v[0] + v[1] + v[2]) / 3.0f;
+            area += triangleArea;
+        }
+        dipole.center = area > 0.0f ? weightedCenter / area : boxCenter;
+        for (unsigned int c = 0; c < node.triangleCount * 3; ++c)
+            dipole.radius = std::max(dipole.radius, glm::length(first[c] - dipole.center));
+        return area;
+    }
+
+    const unsigned int left = node.leftFirst;
+    const unsigned int right = node.leftFirst + 1;
+    const float leftArea = BuildDipoles(left);
+    const float rightArea = BuildDipoles(right);
+    const Dipole& l = dipoles[left];
+    const Dipole& r = dipoles[right];
+    area = leftArea + rightArea;
+    dipole.normal = l.normal + r.normal;
+    dipole.center = area > 0.0f ? (leftArea * l.center + rightArea * r.center) / area : boxCenter;
+    dipole.radius = std::max(glm::length(l.center - dipole.center) + l.radius, glm::length(r.center - dipole.center) + r.radius);
+    return area;
+}
+
+float WindingNumber::Evaluate(const glm::vec3& point) const
+{
+    if (nodes.empty())
+        return 0.0f;
+
+    const float betaSquared = Beta * Beta;
+    float solidAngle = 0.0f;
+    unsigned int stack[StackSize];
+    unsigned int stackSize = 0;
+    stack[stackSize++] = 0;
+    while (stackSize > 0) {
+        const unsigned int nodeIndex = stack[--stackSize];
+        const BVHNode& node = nodes[nodeIndex];
+        const Dipole& dipole = dipoles[nodeIndex];
+
+        // Far field: the node's triangles seen as one oriented patch at their centroid
+        const glm::vec3 offset = dipole.center - point;
+        const float distanceSquared = glm::dot(offset, offset);
+        if (distanceSquared > betaSquared * dipole.radius * dipole.radius) {
+            solidAngle += glm::dot(dipole.normal, offset) / (distanceSquared * std::sqrt(distanceSquared));
+            continue;
+        }
+
+        if (node.IsLeaf()) {
+            const glm::vec3* first = corners.data() + size_t(node.leftFirst) * 3;
+            for (unsigned int t = 0; t < node.triangleCount; ++t) {
+                const glm::vec3* v = first + t * 3;
+                solidAngle += TriangleSolidAngle(v[0] - point, v[1] - point, v[2] - point);
+            }
+        }
+        else {
+            stack[stackSize++] = node.leftFirst;
+            stack[stackSize++] = node.leftFirst + 1;
+        }
+    }
+    return solidAngle / FourPi;
+}
+
+void WindingNumber::Evaluate(const glm::vec3* points, size_t count, float* outWinding, unsigned int threadCount) const
+{
+    if (threadCount == 0)
+        threadCount = count >= ParallelThreshold ? Parallel::ThreadCount() : 1;
+    Parallel::ForChunks(count, threadCount, [&](size_t begin, size_t end, unsigned int) {
+        for (size_t i = begin; i < end; ++i)
+            outWinding[i] = Evaluate(points[i]);
+        });
+}
+
+void WindingNumber::Classify(const glm::vec3* points, size_t count, unsigned char* outInside, unsigned int threadCount) const
+{
+    if (threadCount == 0)
+        threadCount = count >= ParallelThreshold ? Parallel::ThreadCount() : 1;
+    Parallel::ForChunks(count, threadCount, [&](size_t begin, size_t end, unsigned int) {
+        for (size_t i = begin; i < end; ++i)
+            outInside[i] = Evaluate(points[i]) > 0.5f ? 1 : 0;
+        });
+}
+
+void WindingNumber::ClassifyTriangleCentroids(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices,
+    std::vector<unsigned char>& outInside, unsigned int threadCount) const
+{
+    const size_t triangleCount = indices.size() / 3;
+    std::vector<glm::vec3> centroids(triangleCount);
+    for (size_t t = 0; t < triangleCount; ++t)
+        centroids[t] = (positions[indices[t * 3]] + positions[indices[t * 3 + 1]] + positions[indices[t * 3 + 2]]) / 3.0f;
+    outInside.resize(triangleCount);
+    Classify(centroids.data(), triangleCount, outInside.data(), threadCount);
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include "glm.hpp"
+#include "BVH.h"
+#include <cstddef>
+#include <vector>
+
+struct MeshData;
+
+// Point containment for arbitrary (non-convex, possibly open) triangle meshes
+// through the generalized winding number: the solid angle of the surface seen
+// from the point over 4 pi. It is 1 inside a closed outward-facing mesh, 0
+// outside, and degrades smoothly around holes.
+// Evaluation follows Barill et al., "Fast Winding Numbers for Soups and Clouds":
+// each BVH node stores the area-weighted normal and centroid of its triangles.
+// A node far enough from the query (distance > Beta * node radius) contributes
+// as a single dipole; near nodes are opened, and leaves sum exact triangle
+// solid angles. A query costs about O(log n) node visits instead of O(n).
+class WindingNumber
+{
+public:
+    // Far-field acceptance ratio; larger is more accurate and slower
+    static constexpr float Beta = 2.0f;
+    // Batches at least this large are split across threads when threadCount is 0
+    static constexpr size_t ParallelThreshold = 1 << 12;
+
+    void Build(const MeshData& mesh);
+    void Build(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices);
+    // Builds over an existing BVH of the same positions/indices
+    void Build(const BVH& bvh, const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices);
+
+    // Local-space evaluator of the mesh on its cached BVH, rebuilt when the revision changes
+    static const WindingNumber& ForMesh(const MeshData& mesh);
+
+    float Evaluate(const glm::vec3& point) const;
+    // Winding number above one half
+    bool Contains(const glm::vec3& point) const { return Evaluate(point) > 0.5f; }
+
+    // Batch queries. threadCount 1 runs on the calling thread, 0 uses all
+    // hardware threads for batches of ParallelThreshold points or more.
+    void Evaluate(const glm::vec3* points, size_t count, float* outWinding, unsigned int threadCount = 0) const;
+    void Classify(const glm::vec3* points, size_t count, unsigned char* outInside, unsigned int threadCount = 0) const;
+    // Classifies the centroid of every triangle of an indexed list (positions in this mesh's space)
+    void ClassifyTriangleCentroids(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices,
+        std::vector<unsigned char>& outInside, unsigned int threadCount = 0) const;
+
+    bool Empty() const { return nodes.empty(); }
+
+    unsigned long long sourceRevision = 0;
+
+private:
+    // Far-field data of one BVH node
+    struct Dipole {
+        glm::vec3 center;   // Area-weighted centroid of the node's triangles
+        float radius;       // Bounds the distance from center to any of the node's vertices
+        glm::vec3 normal;   // Sum of area * unit normal of the node's triangles
+    };
+
+    // Fills the subtree's dipoles and returns its surface area
+    float BuildDipoles(unsigned int nodeIndex);
+
+    std::vector<BVHNode> nodes;
+    std::vector<Dipole> dipoles;
+    std::vector<glm::vec3> corners; // Triangle vertices in BVH leaf order, 3 per triangle
+};